@@ -0,0 +1,243 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+// This benchmark measures the scheduler and the mailbox implementation
+// (single_reader_queue) of local actors. It runs the following cases:
+// - spawn_terminate: spawns actors that terminate immediately
+// - ping_pong:       round trips between two actors, i.e., latency
+// - n_to_1:          many senders flooding a single mailbox
+// - fan_out_fan_in:  one actor sending a message to many workers and
+//                    waiting for all replies before starting the next round
+// - idle_spawn:      spawns actors that wait for a message afterwards
+// - idle_terminate:  tells all idle actors to quit
+//
+// Usage: actor_scheduling [WORKERS [SCALE]]
+//
+// WORKERS defaults to the number of cores and SCALE multiplies the number
+// of operations per case (default: 1). Prints one CSV line per case:
+// name,workers,operations,seconds,operations_per_second,us_per_operation.
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstdint>
+#include <iostream>
+
+#include "caf/all.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+using done_atom = atom_constant<atom("done")>;
+
+using clock_type = chrono::high_resolution_clock;
+
+// number of senders in the n_to_1 case
+constexpr size_t num_senders = 16;
+
+// number of workers in the fan_out_fan_in case
+constexpr size_t fan_out = 100;
+
+size_t num_workers;
+
+void print(const char* name, size_t operations,
+           clock_type::time_point start) {
+  chrono::duration<double> diff = clock_type::now() - start;
+  auto t = diff.count();
+  cout << name << "," << num_workers << "," << operations << "," << t << ","
+       << static_cast<double>(operations) / t << ","
+       << t * 1e6 / static_cast<double>(operations) << endl;
+}
+
+// waits for `done_atom` from the actor running the case
+void await_done(scoped_actor& self) {
+  self->receive(
+    [](done_atom) {
+      // nop
+    }
+  );
+}
+
+void spawn_terminate(scoped_actor& self, size_t actors) {
+  auto start = clock_type::now();
+  for (size_t i = 0; i < actors; ++i) {
+    spawn([] {
+      // terminates immediately without a behavior
+    });
+  }
+  self->await_all_other_actors_done();
+  print("spawn_terminate", actors, start);
+}
+
+behavior pong() {
+  return {
+    [](uint64_t value) {
+      return value;
+    }
+  };
+}
+
+behavior ping(event_based_actor* self, actor buddy, uint64_t rounds,
+              actor parent) {
+  self->send(buddy, uint64_t{0});
+  return {
+    [=](uint64_t value) {
+      if (value + 1 == rounds) {
+        self->send(parent, done_atom::value);
+        self->send_exit(buddy, exit_reason::user_shutdown);
+        self->quit();
+        return;
+      }
+      self->send(buddy, value + 1);
+    }
+  };
+}
+
+void ping_pong(scoped_actor& self, uint64_t rounds) {
+  auto start = clock_type::now();
+  spawn(ping, spawn(pong), rounds, self);
+  await_done(self);
+  print("ping_pong", rounds, start);
+  self->await_all_other_actors_done();
+}
+
+behavior sink(event_based_actor* self, size_t expected, actor parent) {
+  auto received = make_shared<size_t>(0);
+  return {
+    [=](uint64_t) {
+      if (++*received == expected) {
+        self->send(parent, done_atom::value);
+        self->quit();
+      }
+    }
+  };
+}
+
+void n_to_1(scoped_actor& self, size_t messages_per_sender) {
+  auto total = messages_per_sender * num_senders;
+  auto start = clock_type::now();
+  auto dest = spawn(sink, total, self);
+  for (size_t i = 0; i < num_senders; ++i) {
+    spawn([=](event_based_actor* sender) {
+      for (uint64_t j = 0; j < messages_per_sender; ++j) {
+        sender->send(dest, j);
+      }
+    });
+  }
+  await_done(self);
+  print("n_to_1", total, start);
+  self->await_all_other_actors_done();
+}
+
+behavior fan_worker() {
+  return {
+    [](uint64_t value) {
+      return value;
+    }
+  };
+}
+
+behavior fan_master(event_based_actor* self, size_t rounds, actor parent) {
+  auto workers = make_shared<vector<actor>>();
+  for (size_t i = 0; i < fan_out; ++i) {
+    workers->push_back(spawn(fan_worker));
+  }
+  auto broadcast = [=](uint64_t round) {
+    for (auto& w : *workers) {
+      self->send(w, round);
+    }
+  };
+  auto replies = make_shared<size_t>(0);
+  broadcast(0);
+  return {
+    [=](uint64_t round) {
+      if (++*replies < fan_out) {
+        return;
+      }
+      *replies = 0;
+      if (round + 1 < rounds) {
+        broadcast(round + 1);
+        return;
+      }
+      for (auto& w : *workers) {
+        self->send_exit(w, exit_reason::user_shutdown);
+      }
+      self->send(parent, done_atom::value);
+      self->quit();
+    }
+  };
+}
+
+void fan_out_fan_in(scoped_actor& self, size_t rounds) {
+  auto start = clock_type::now();
+  spawn(fan_master, rounds, self);
+  await_done(self);
+  print("fan_out_fan_in", rounds * fan_out, start);
+  self->await_all_other_actors_done();
+}
+
+behavior idle(event_based_actor* self) {
+  return {
+    [=](done_atom) {
+      self->quit();
+    }
+  };
+}
+
+void idle_actors(scoped_actor& self, size_t actors) {
+  vector<actor> hdls;
+  hdls.reserve(actors);
+  auto start = clock_type::now();
+  for (size_t i = 0; i < actors; ++i) {
+    hdls.push_back(spawn(idle));
+  }
+  print("idle_spawn", actors, start);
+  start = clock_type::now();
+  for (auto& hdl : hdls) {
+    self->send(hdl, done_atom::value);
+  }
+  hdls.clear();
+  self->await_all_other_actors_done();
+  print("idle_terminate", actors, start);
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  num_workers = thread::hardware_concurrency();
+  size_t scale = 1;
+  if (argc > 1) num_workers = stoul(argv[1]);
+  if (argc > 2) scale = stoul(argv[2]);
+  set_scheduler<>(num_workers);
+  { // lifetime scope of self
+    scoped_actor self;
+    cout << "name,workers,operations,seconds,operations_per_second,"
+            "us_per_operation" << endl;
+    spawn_terminate(self, 100000 * scale);
+    ping_pong(self, 100000 * scale);
+    n_to_1(self, 100000 * scale);
+    fan_out_fan_in(self, 10000 * scale);
+    idle_actors(self, 100000 * scale);
+  }
+  await_all_actors_done();
+  shutdown();
+}
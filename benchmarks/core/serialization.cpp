@@ -0,0 +1,207 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+// This benchmark measures the binary serialization of builtin types,
+// announced structs, nested containers and messages as well as the string
+// serialization of messages via to_string and from_string. Each case
+// serializes and deserializes the same value repeatedly, reusing the
+// buffer, and counts the heap allocations per round.
+//
+// Usage: serialization [ROUNDS]
+//
+// Prints one CSV line per case: name,bytes,rounds,serialize_mbps,
+// deserialize_mbps,serialize_allocs,deserialize_allocs, whereas the last
+// two columns are allocations per round.
+
+#include <map>
+#include <list>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "caf/all.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/binary_deserializer.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+using clock_type = chrono::high_resolution_clock;
+
+using buffer_type = vector<char>;
+
+atomic<size_t> s_allocations{0};
+
+} // namespace <anonymous>
+
+// counts all heap allocations of this program
+void* operator new(size_t size) {
+  s_allocations.fetch_add(1, memory_order_relaxed);
+  auto result = malloc(size == 0 ? 1 : size);
+  if (!result) {
+    throw bad_alloc{};
+  }
+  return result;
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  free(ptr);
+}
+
+namespace {
+
+struct point {
+  int32_t x;
+  int32_t y;
+};
+
+bool operator==(const point& lhs, const point& rhs) {
+  return lhs.x == rhs.x && lhs.y == rhs.y;
+}
+
+struct shape {
+  string name;
+  vector<point> points;
+  map<string, double> attributes;
+};
+
+bool operator==(const shape& lhs, const shape& rhs) {
+  return lhs.name == rhs.name && lhs.points == rhs.points
+         && lhs.attributes == rhs.attributes;
+}
+
+using nested = map<string, vector<list<int64_t>>>;
+
+double seconds_since(clock_type::time_point start) {
+  chrono::duration<double> diff = clock_type::now() - start;
+  return diff.count();
+}
+
+void print(const char* name, size_t bytes, size_t rounds,
+           double serialize_time, size_t serialize_allocs,
+           double deserialize_time, size_t deserialize_allocs) {
+  auto mb = static_cast<double>(bytes * rounds) / 1e6;
+  auto per_round = [&](size_t allocs) {
+    return static_cast<double>(allocs) / static_cast<double>(rounds);
+  };
+  cout << name << "," << bytes << "," << rounds << ","
+       << mb / serialize_time << "," << mb / deserialize_time << ","
+       << per_round(serialize_allocs) << "," << per_round(deserialize_allocs)
+       << endl;
+}
+
+template <class T>
+void run_binary(const char* name, const T& value, size_t rounds) {
+  buffer_type buf;
+  auto allocs = s_allocations.load();
+  auto start = clock_type::now();
+  for (size_t i = 0; i < rounds; ++i) {
+    buf.clear();
+    binary_serializer bs{back_inserter(buf)};
+    bs << value;
+  }
+  auto serialize_time = seconds_since(start);
+  auto serialize_allocs = s_allocations.load() - allocs;
+  auto uti = uniform_typeid<T>();
+  T result;
+  allocs = s_allocations.load();
+  start = clock_type::now();
+  for (size_t i = 0; i < rounds; ++i) {
+    binary_deserializer bd{buf.data(), buf.size()};
+    uti->deserialize(&result, &bd);
+  }
+  auto deserialize_time = seconds_since(start);
+  auto deserialize_allocs = s_allocations.load() - allocs;
+  if (!(result == value)) {
+    cerr << name << ": deserialized value differs from input" << endl;
+  }
+  print(name, buf.size(), rounds, serialize_time, serialize_allocs,
+        deserialize_time, deserialize_allocs);
+}
+
+void run_string(const char* name, const message& value, size_t rounds) {
+  string str;
+  auto allocs = s_allocations.load();
+  auto start = clock_type::now();
+  for (size_t i = 0; i < rounds; ++i) {
+    str = to_string(value);
+  }
+  auto serialize_time = seconds_since(start);
+  auto serialize_allocs = s_allocations.load() - allocs;
+  optional<message> result;
+  allocs = s_allocations.load();
+  start = clock_type::now();
+  for (size_t i = 0; i < rounds; ++i) {
+    result = from_string<message>(str);
+  }
+  auto deserialize_time = seconds_since(start);
+  auto deserialize_allocs = s_allocations.load() - allocs;
+  if (!result || *result != value) {
+    cerr << name << ": deserialized value differs from input" << endl;
+  }
+  print(name, str.size(), rounds, serialize_time, serialize_allocs,
+        deserialize_time, deserialize_allocs);
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t rounds = 100000;
+  if (argc > 1) rounds = stoul(argv[1]);
+  announce<point>("point", &point::x, &point::y);
+  announce<vector<point>>("point_vector");
+  announce<map<string, double>>("attribute_map");
+  announce<shape>("shape", &shape::name, &shape::points, &shape::attributes);
+  announce<vector<list<int64_t>>>("int64_list_vector");
+  announce<nested>("nested");
+  shape s{"polygon", {}, {{"area", 12.5}, {"weight", 0.75}}};
+  for (int32_t i = 0; i < 32; ++i) {
+    s.points.push_back(point{i, -i});
+  }
+  nested n;
+  for (int64_t i = 0; i < 8; ++i) {
+    auto& lists = n["key" + to_string(i)];
+    for (int64_t j = 0; j < 4; ++j) {
+      lists.push_back(list<int64_t>{i, j, i * j});
+    }
+  }
+  auto msg = make_message(atom("put"), int32_t{42}, string("key"), 1.5, s);
+  cout << "name,bytes,rounds,serialize_mbps,deserialize_mbps,"
+          "serialize_allocs,deserialize_allocs" << endl;
+  run_binary("int64", int64_t{0x0123456789abcdef}, rounds);
+  run_binary("double", 3.14159265358979, rounds);
+  run_binary("string", string(256, 'x'), rounds);
+  run_binary("struct", s, rounds);
+  run_binary("nested", n, rounds);
+  run_binary("message", msg, rounds);
+  run_string("message_string", make_message(atom("put"), int32_t{42},
+                                            string("key"), 1.5),
+             rounds / 10);
+  shutdown();
+}
@@ -0,0 +1,183 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+// This program feeds malformed input to binary_deserializer and
+// from_string. The first byte of each input selects the target:
+// - even: the remaining bytes are deserialized as message
+// - odd:  the remaining bytes are parsed by from_string<message>
+// Any input must either produce a value or raise an exception.
+//
+// Usage: serialization_fuzz [ITERATIONS [SEED]]
+//
+// Without libFuzzer, the program mutates serialized messages and their
+// string representations randomly and prints one CSV line:
+// iterations,seconds,inputs_per_second,accepted,rejected. Compiling this
+// file with -DCAF_LIBFUZZER and -fsanitize=fuzzer builds a libFuzzer
+// target instead.
+
+#include <map>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+
+#include "caf/all.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/binary_deserializer.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+using buffer_type = vector<char>;
+
+size_t s_accepted = 0;
+size_t s_rejected = 0;
+
+void deserialize(const char* data, size_t size) {
+  binary_deserializer bd{data, size};
+  message msg;
+  uniform_typeid<message>()->deserialize(&msg, &bd);
+  // touch all elements to find dangling or invalid values
+  to_string(msg);
+}
+
+void parse(const char* data, size_t size) {
+  auto msg = from_string<message>(string(data, size));
+  if (!msg) {
+    throw std::invalid_argument("from_string returned none");
+  }
+  to_string(*msg);
+}
+
+void run(const uint8_t* data, size_t size) {
+  if (size == 0) {
+    return;
+  }
+  auto first = reinterpret_cast<const char*>(data) + 1;
+  try {
+    if (data[0] % 2 == 0) {
+      deserialize(first, size - 1);
+    } else {
+      parse(first, size - 1);
+    }
+    ++s_accepted;
+  }
+  catch (std::exception&) {
+    ++s_rejected;
+  }
+}
+
+} // namespace <anonymous>
+
+#ifdef CAF_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  run(data, size);
+  return 0;
+}
+
+#else // CAF_LIBFUZZER
+
+namespace {
+
+using clock_type = chrono::high_resolution_clock;
+
+vector<buffer_type> make_seeds() {
+  vector<message> msgs{
+    make_message(int32_t{42}),
+    make_message(atom("put"), int32_t{42}, string("key"), 1.5),
+    make_message(vector<int32_t>{1, 2, 3}, map<string, string>{{"a", "b"}}),
+    make_message(string(100, 'x'), make_message(uint64_t{1}, 'c'))
+  };
+  vector<buffer_type> result;
+  for (auto& msg : msgs) {
+    buffer_type buf{0};
+    binary_serializer bs{back_inserter(buf)};
+    bs << msg;
+    result.push_back(move(buf));
+    auto str = to_string(msg);
+    buf.assign(1, 1);
+    buf.insert(buf.end(), str.begin(), str.end());
+    result.push_back(move(buf));
+  }
+  return result;
+}
+
+// flips bits, overwrites, inserts, erases or truncates bytes after the
+// first byte, which selects the target
+void mutate(buffer_type& buf, default_random_engine& engine) {
+  uniform_int_distribution<int> op_dist{0, 4};
+  uniform_int_distribution<int> byte_dist{0, 255};
+  auto pos = [&] {
+    uniform_int_distribution<size_t> dist{1, buf.size() - 1};
+    return dist(engine);
+  };
+  uniform_int_distribution<int> num_dist{1, 4};
+  for (auto n = num_dist(engine); n > 0 && buf.size() > 1; --n) {
+    switch (op_dist(engine)) {
+      case 0:
+        buf[pos()] ^= static_cast<char>(1 << (byte_dist(engine) % 8));
+        break;
+      case 1:
+        buf[pos()] = static_cast<char>(byte_dist(engine));
+        break;
+      case 2:
+        buf.insert(buf.begin() + static_cast<ptrdiff_t>(pos()),
+                   static_cast<char>(byte_dist(engine)));
+        break;
+      case 3:
+        buf.erase(buf.begin() + static_cast<ptrdiff_t>(pos()));
+        break;
+      default:
+        buf.resize(pos());
+    }
+  }
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t iterations = 100000;
+  unsigned seed = 42;
+  if (argc > 1) iterations = stoul(argv[1]);
+  if (argc > 2) seed = static_cast<unsigned>(stoul(argv[2]));
+  announce<vector<int32_t>>("int32_vector");
+  announce<map<string, string>>("string_map");
+  auto seeds = make_seeds();
+  default_random_engine engine{seed};
+  uniform_int_distribution<size_t> seed_dist{0, seeds.size() - 1};
+  auto start = clock_type::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    auto input = seeds[seed_dist(engine)];
+    mutate(input, engine);
+    run(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+  }
+  chrono::duration<double> diff = clock_type::now() - start;
+  cout << "iterations,seconds,inputs_per_second,accepted,rejected" << endl
+       << iterations << "," << diff.count() << ","
+       << static_cast<double>(iterations) / diff.count() << "," << s_accepted
+       << "," << s_rejected << endl;
+  shutdown();
+}
+
+#endif // CAF_LIBFUZZER
@@ -0,0 +1,255 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+// This benchmark measures the trade-off of compressing BASP payloads. It
+// first runs the LZ codec on serialized messages with typical content and
+// on random bytes, reporting the compression ratio and the throughput of
+// compressing and decompressing. Afterwards, it sends messages to two
+// forked sink processes via TCP, one with compression and one without.
+//
+// Usage: basp_compression [MESSAGES [MESSAGE_SIZE]]
+//
+// Prints two CSV tables: name,bytes,compressed_bytes,ratio,compress_mbps,
+// decompress_mbps for the codec and name,messages,bytes_per_message,
+// seconds,messages_per_second for sending messages over the network.
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+
+#include "caf/config.hpp"
+
+#ifndef CAF_WINDOWS
+# include <unistd.h>
+# include <sys/wait.h>
+#endif
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+#include "caf/io/network/lz_codec.hpp"
+
+using namespace std;
+using namespace caf;
+using namespace caf::io;
+
+using done_atom = atom_constant<atom("done")>;
+
+using clock_type = chrono::high_resolution_clock;
+
+using buffer_type = vector<char>;
+
+// number of times each codec measurement is repeated
+constexpr size_t codec_rounds = 200;
+
+// compresses messages of at least 128 bytes
+constexpr size_t threshold = 128;
+
+#ifndef CAF_WINDOWS
+
+void write_port(int fd, uint16_t port) {
+  if (::write(fd, &port, sizeof(port)) != sizeof(port)) {
+    cerr << "unable to write to pipe" << endl;
+  }
+  ::close(fd);
+}
+
+uint16_t read_port(int fd) {
+  uint16_t port = 0;
+  if (::read(fd, &port, sizeof(port)) != sizeof(port)) {
+    cerr << "unable to read from pipe" << endl;
+  }
+  ::close(fd);
+  return port;
+}
+
+double seconds_since(clock_type::time_point start) {
+  chrono::duration<double> diff = clock_type::now() - start;
+  return diff.count();
+}
+
+// a log line as it might appear in a message between services
+string make_text(size_t size) {
+  static const char* words[] = {"node", "actor", "request", "response",
+                                "timeout", "worker", "user", "session"};
+  string result;
+  for (size_t i = 0; result.size() < size; ++i) {
+    result += words[i % 8];
+    result += "=";
+    result += to_string(i % 97);
+    result += " ";
+  }
+  result.resize(size);
+  return result;
+}
+
+buffer_type serialize(const message& msg) {
+  buffer_type result;
+  binary_serializer bs{back_inserter(result)};
+  bs << msg;
+  return result;
+}
+
+void run_codec(const char* name, const buffer_type& input) {
+  network::lz_codec codec;
+  buffer_type compressed;
+  auto start = clock_type::now();
+  for (size_t i = 0; i < codec_rounds; ++i) {
+    compressed.clear();
+    codec.compress(input.data(), input.size(), compressed);
+  }
+  auto compress_time = seconds_since(start);
+  buffer_type output;
+  start = clock_type::now();
+  for (size_t i = 0; i < codec_rounds; ++i) {
+    output.clear();
+    network::lz_codec::decompress(compressed.data(), compressed.size(),
+                                  output);
+  }
+  auto decompress_time = seconds_since(start);
+  if (output != input) {
+    cerr << name << ": decompressed data differs from input" << endl;
+  }
+  auto mb = static_cast<double>(input.size() * codec_rounds) / 1e6;
+  cout << name << "," << input.size() << "," << compressed.size() << ","
+       << static_cast<double>(input.size()) / compressed.size() << ","
+       << mb / compress_time << "," << mb / decompress_time << endl;
+}
+
+void run_codecs(size_t msg_size) {
+  cout << "name,bytes,compressed_bytes,ratio,compress_mbps,decompress_mbps"
+       << endl;
+  run_codec("text", serialize(make_message(make_text(msg_size))));
+  // many small strings, as in a batch of records
+  vector<string> records;
+  for (size_t i = 0; i < msg_size / 16; ++i) {
+    records.push_back("record-" + to_string(i % 50));
+  }
+  run_codec("records", serialize(make_message(records)));
+  // many small messages, each repeating its type names
+  buffer_type batch;
+  while (batch.size() < msg_size) {
+    auto seq = static_cast<int32_t>(batch.size());
+    auto x = serialize(make_message(atom("put"), seq, string("key"), 1.5));
+    batch.insert(batch.end(), x.begin(), x.end());
+  }
+  run_codec("batch", batch);
+  // incompressible data
+  buffer_type noise(msg_size);
+  default_random_engine engine{42};
+  uniform_int_distribution<int> dist{0, 255};
+  for (auto& c : noise) {
+    c = static_cast<char>(dist(engine));
+  }
+  run_codec("random", noise);
+}
+
+// counts messages and replies with the count to done_atom
+behavior sink(event_based_actor* self) {
+  auto received = make_shared<uint64_t>(0);
+  return {
+    [=](const string&) {
+      ++*received;
+    },
+    [=](done_atom) {
+      self->quit();
+      return *received;
+    }
+  };
+}
+
+void run_sink(int port_pipe, size_t min_compressed) {
+  // compression is never used for connections via Unix domain sockets
+  prefer_local_transport(false);
+  compression_threshold(min_compressed);
+  auto port = publish(spawn(sink), 0, "127.0.0.1");
+  write_port(port_pipe, port);
+  await_all_actors_done();
+  shutdown();
+}
+
+void run_source(const char* name, int port_pipe, size_t min_compressed,
+                size_t messages, size_t msg_size) {
+  // nodes negotiate compression when connecting
+  compression_threshold(min_compressed);
+  scoped_actor self;
+  auto sink_hdl = remote_actor("127.0.0.1", read_port(port_pipe));
+  auto payload = make_text(msg_size);
+  auto start = clock_type::now();
+  for (size_t i = 0; i < messages; ++i) {
+    self->send(sink_hdl, payload);
+  }
+  self->sync_send(sink_hdl, done_atom::value).await(
+    [&](uint64_t received) {
+      auto t = seconds_since(start);
+      if (received != messages) {
+        cerr << "sink received " << received << " messages, expected "
+             << messages << endl;
+      }
+      cout << name << "," << messages << "," << msg_size << "," << t << ","
+           << static_cast<double>(messages) / t << endl;
+    }
+  );
+}
+
+int main(int argc, char** argv) {
+  size_t messages = 100000;
+  size_t msg_size = 4096;
+  if (argc > 1) messages = stoul(argv[1]);
+  if (argc > 2) msg_size = stoul(argv[2]);
+  // fork before any CAF thread is running
+  int plain_pipe[2];
+  int compressed_pipe[2];
+  if (pipe(plain_pipe) != 0 || pipe(compressed_pipe) != 0) {
+    cerr << "pipe() failed" << endl;
+    return 1;
+  }
+  auto plain_pid = fork();
+  if (plain_pid == 0) {
+    run_sink(plain_pipe[1], 0);
+    return 0;
+  }
+  auto compressed_pid = fork();
+  if (compressed_pid == 0) {
+    run_sink(compressed_pipe[1], threshold);
+    return 0;
+  }
+  run_codecs(msg_size);
+  prefer_local_transport(false);
+  cout << "name,messages,bytes_per_message,seconds,messages_per_second"
+       << endl;
+  run_source("uncompressed", plain_pipe[0], 0, messages, msg_size);
+  run_source("compressed", compressed_pipe[0], threshold, messages, msg_size);
+  await_all_actors_done();
+  shutdown();
+  waitpid(plain_pid, nullptr, 0);
+  waitpid(compressed_pid, nullptr, 0);
+}
+
+#else // CAF_WINDOWS
+
+int main() {
+  cerr << "basp_compression requires fork() and is not available on Windows"
+       << endl;
+  return 1;
+}
+
+#endif // CAF_WINDOWS
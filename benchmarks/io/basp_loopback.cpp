@@ -0,0 +1,313 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+// This benchmark measures BASP over TCP loopback for a range of message
+// sizes. It forks a server node publishing an echo actor and a relay node
+// handing out a handle to the echo actor. Afterwards, the parent measures:
+// - ping_pong:  round trips to the server, i.e., latency
+// - one_way:    messages sent to the server without waiting for replies
+// - relay:      like one_way, but sent by a separate client process that
+//               is only connected to the relay node, which forwards all
+//               messages to the server
+// - connect:    connections established via remote_actor to the server
+//
+// Usage: basp_loopback [MESSAGES [CONNECTIONS [SIZE...]]]
+//
+// MESSAGES is the maximum number of messages per size and case, whereas
+// ping_pong uses one tenth and large messages are limited to 64 MB per run.
+// SIZE defaults to 16, 1024, 65536 and 1048576 bytes. Prints one CSV line
+// per case and size: name,bytes_per_message,messages,seconds,
+// messages_per_second,us_per_message.
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+
+#include "caf/config.hpp"
+
+#ifndef CAF_WINDOWS
+# include <unistd.h>
+# include <sys/wait.h>
+#endif
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+using namespace caf::io;
+
+using done_atom = atom_constant<atom("done")>;
+
+using clock_type = chrono::high_resolution_clock;
+
+// limits the bytes sent per case and size
+constexpr size_t max_bytes = 64 * 1024 * 1024;
+
+#ifndef CAF_WINDOWS
+
+void write_port(int fd, uint16_t port) {
+  if (::write(fd, &port, sizeof(port)) != sizeof(port)) {
+    cerr << "unable to write to pipe" << endl;
+  }
+  ::close(fd);
+}
+
+uint16_t read_port(int fd) {
+  uint16_t port = 0;
+  if (::read(fd, &port, sizeof(port)) != sizeof(port)) {
+    cerr << "unable to read from pipe" << endl;
+  }
+  ::close(fd);
+  return port;
+}
+
+void print(const char* name, size_t msg_size, size_t messages,
+           clock_type::time_point start) {
+  chrono::duration<double> diff = clock_type::now() - start;
+  auto t = diff.count();
+  cout << name << "," << msg_size << "," << messages << "," << t << ","
+       << static_cast<double>(messages) / t << ","
+       << t * 1e6 / static_cast<double>(messages) << endl;
+}
+
+// echoes strings and counts one-way messages tagged with put_atom
+behavior echo(event_based_actor* self) {
+  auto received = make_shared<uint64_t>(0);
+  return {
+    [](const string& payload) {
+      return payload;
+    },
+    [=](put_atom, const string&) {
+      ++*received;
+    },
+    [=](get_atom) {
+      auto result = *received;
+      *received = 0;
+      return result;
+    },
+    [=](done_atom) {
+      self->quit();
+    }
+  };
+}
+
+// hands out the echo actor's handle until the echo actor is done
+behavior directory(event_based_actor* self, const actor& echo_hdl) {
+  self->monitor(echo_hdl);
+  return {
+    [=](get_atom) {
+      return echo_hdl;
+    },
+    [=](const down_msg&) {
+      self->quit();
+    }
+  };
+}
+
+void run_server(int port_pipe) {
+  prefer_local_transport(false);
+  auto port = publish(spawn(echo), 0, "127.0.0.1");
+  write_port(port_pipe, port);
+  await_all_actors_done();
+  shutdown();
+}
+
+void run_relay(uint16_t server_port, int port_pipe) {
+  prefer_local_transport(false);
+  auto echo_hdl = remote_actor("127.0.0.1", server_port);
+  auto port = publish(spawn(directory, echo_hdl), 0, "127.0.0.1");
+  write_port(port_pipe, port);
+  await_all_actors_done();
+  shutdown();
+}
+
+void ping_pong(scoped_actor& self, const actor& hdl, size_t rounds,
+               const string& payload) {
+  auto start = clock_type::now();
+  for (size_t i = 0; i < rounds; ++i) {
+    self->sync_send(hdl, payload).await(
+      [&](const string& str) {
+        if (str.size() != payload.size()) {
+          cerr << "unexpected reply of size " << str.size() << endl;
+        }
+      }
+    );
+  }
+  print("ping_pong", payload.size(), rounds, start);
+}
+
+// counts the direct connections of this node
+class connection_counter : public hook {
+ public:
+  connection_counter(shared_ptr<atomic<size_t>> count)
+      : m_count(move(count)) {
+    // nop
+  }
+
+  void new_connection_established_cb(const node_id& node) override {
+    ++*m_count;
+    call_next<new_connection_established>(node);
+  }
+
+ private:
+  shared_ptr<atomic<size_t>> m_count;
+};
+
+void one_way(scoped_actor& self, const char* name, const actor& hdl,
+             size_t messages, const string& payload) {
+  auto start = clock_type::now();
+  for (size_t i = 0; i < messages; ++i) {
+    self->send(hdl, put_atom::value, payload);
+  }
+  // the echo actor handles messages from the same sender in order
+  self->sync_send(hdl, get_atom::value).await(
+    [&](uint64_t received) {
+      if (received != messages) {
+        cerr << name << ": received " << received << " messages, expected "
+             << messages << endl;
+      }
+    }
+  );
+  print(name, payload.size(), messages, start);
+}
+
+void connect(uint16_t port, size_t connections) {
+  auto start = clock_type::now();
+  for (size_t i = 0; i < connections; ++i) {
+    // the server closes redundant connections after the handshake
+    remote_actor("127.0.0.1", port);
+  }
+  print("connect", 0, connections, start);
+}
+
+size_t messages_per_size(size_t messages, size_t msg_size) {
+  return min(messages, max<size_t>(100, max_bytes / msg_size));
+}
+
+// never connects to the server, hence all messages to the
+// echo actor take the route via the relay node
+void run_relay_client(uint16_t relay_port, size_t messages,
+                      const vector<size_t>& sizes) {
+  prefer_local_transport(false);
+  auto connections = make_shared<atomic<size_t>>(0);
+  middleman::instance()->add_hook<connection_counter>(connections);
+  { // lifetime scope of self
+    scoped_actor self;
+    auto dir = remote_actor("127.0.0.1", relay_port);
+    actor relayed_hdl;
+    self->sync_send(dir, get_atom::value).await(
+      [&](const actor& hdl) {
+        relayed_hdl = hdl;
+      }
+    );
+    for (auto msg_size : sizes) {
+      auto n = messages_per_size(messages, msg_size);
+      one_way(self, "relay", relayed_hdl, n, string(msg_size, 'x'));
+    }
+    // the relay is our only neighbor, hence it has
+    // forwarded all messages to the echo actor
+    if (relayed_hdl.address().node() == dir.address().node()
+        || *connections != 1) {
+      cerr << "relay: messages to the echo actor took a direct route" << endl;
+    }
+  }
+  await_all_actors_done();
+  shutdown();
+}
+
+void run_client(uint16_t server_port, size_t messages, size_t connections,
+                const vector<size_t>& sizes) {
+  prefer_local_transport(false);
+  { // lifetime scope of self
+    scoped_actor self;
+    auto echo_hdl = remote_actor("127.0.0.1", server_port);
+    for (auto msg_size : sizes) {
+      auto n = messages_per_size(messages, msg_size);
+      string payload(msg_size, 'x');
+      ping_pong(self, echo_hdl, max<size_t>(1, n / 10), payload);
+      one_way(self, "one_way", echo_hdl, n, payload);
+    }
+    connect(server_port, connections);
+    self->send(echo_hdl, done_atom::value);
+  }
+  await_all_actors_done();
+  shutdown();
+}
+
+int main(int argc, char** argv) {
+  size_t messages = 100000;
+  size_t connections = 100;
+  vector<size_t> sizes;
+  if (argc > 1) messages = stoul(argv[1]);
+  if (argc > 2) connections = stoul(argv[2]);
+  for (int i = 3; i < argc; ++i) {
+    sizes.push_back(max<size_t>(1, stoul(argv[i])));
+  }
+  if (sizes.empty()) {
+    sizes = {16, 1024, 64 * 1024, 1024 * 1024};
+  }
+  // fork before any CAF thread is running
+  int server_pipe[2];
+  int relay_pipe[2];
+  if (pipe(server_pipe) != 0 || pipe(relay_pipe) != 0) {
+    cerr << "pipe() failed" << endl;
+    return 1;
+  }
+  auto server_pid = fork();
+  if (server_pid == 0) {
+    run_server(server_pipe[1]);
+    return 0;
+  }
+  // the relay and the client both connect to the server
+  auto server_port = read_port(server_pipe[0]);
+  auto relay_pid = fork();
+  if (relay_pid == 0) {
+    run_relay(server_port, relay_pipe[1]);
+    return 0;
+  }
+  auto relay_port = read_port(relay_pipe[0]);
+  cout << "name,bytes_per_message,messages,seconds,messages_per_second,"
+          "us_per_message" << endl;
+  // the relay client runs first, because it must not share
+  // a node with a direct connection to the server
+  auto relay_client_pid = fork();
+  if (relay_client_pid == 0) {
+    run_relay_client(relay_port, messages, sizes);
+    return 0;
+  }
+  waitpid(relay_client_pid, nullptr, 0);
+  run_client(server_port, messages, connections, sizes);
+  waitpid(relay_pid, nullptr, 0);
+  waitpid(server_pid, nullptr, 0);
+}
+
+#else // CAF_WINDOWS
+
+int main() {
+  cerr << "basp_loopback requires fork() and is not available on Windows"
+       << endl;
+  return 1;
+}
+
+#endif // CAF_WINDOWS
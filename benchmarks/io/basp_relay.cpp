@@ -0,0 +1,182 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+// This benchmark measures how fast a BASP node relays messages between two
+// other nodes. It forks a sink and a relay process: the source (parent)
+// obtains a handle to the sink's actor from the relay and thus sends all
+// messages via the relay, which forwards them without deserializing them.
+//
+// Usage: basp_relay [MESSAGES [MESSAGE_SIZE]]
+//
+// Prints one CSV line: name,messages,bytes_per_message,seconds,
+// messages_per_second.
+
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <iostream>
+
+#include "caf/config.hpp"
+
+#ifndef CAF_WINDOWS
+# include <unistd.h>
+# include <sys/wait.h>
+#endif
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+using namespace caf::io;
+
+using done_atom = atom_constant<atom("done")>;
+
+using clock_type = chrono::high_resolution_clock;
+
+#ifndef CAF_WINDOWS
+
+void write_port(int fd, uint16_t port) {
+  if (::write(fd, &port, sizeof(port)) != sizeof(port)) {
+    cerr << "unable to write to pipe" << endl;
+  }
+  ::close(fd);
+}
+
+uint16_t read_port(int fd) {
+  uint16_t port = 0;
+  if (::read(fd, &port, sizeof(port)) != sizeof(port)) {
+    cerr << "unable to read from pipe" << endl;
+  }
+  ::close(fd);
+  return port;
+}
+
+// counts messages and replies with the count to done_atom
+behavior sink(event_based_actor* self) {
+  auto received = make_shared<uint64_t>(0);
+  return {
+    [=](const string&) {
+      ++*received;
+    },
+    [=](done_atom) {
+      self->quit();
+      return *received;
+    }
+  };
+}
+
+// hands out the sink's handle until the sink is done
+behavior directory(event_based_actor* self, const actor& sink_hdl) {
+  self->monitor(sink_hdl);
+  return {
+    [=](get_atom) {
+      return sink_hdl;
+    },
+    [=](const down_msg&) {
+      self->quit();
+    }
+  };
+}
+
+void run_sink(int port_pipe) {
+  auto port = publish(spawn(sink), 0, "127.0.0.1");
+  write_port(port_pipe, port);
+  await_all_actors_done();
+  shutdown();
+}
+
+void run_relay(int sink_pipe, int port_pipe) {
+  auto sink_hdl = remote_actor("127.0.0.1", read_port(sink_pipe));
+  auto port = publish(spawn(directory, sink_hdl), 0, "127.0.0.1");
+  write_port(port_pipe, port);
+  await_all_actors_done();
+  shutdown();
+}
+
+void run_source(int port_pipe, size_t messages, size_t msg_size) {
+  { // lifetime scope of self
+    scoped_actor self;
+    auto dir = remote_actor("127.0.0.1", read_port(port_pipe));
+    actor sink_hdl;
+    self->sync_send(dir, get_atom::value).await(
+      [&](const actor& hdl) {
+        sink_hdl = hdl;
+      }
+    );
+    string payload(msg_size, 'x');
+    auto start = clock_type::now();
+    for (size_t i = 0; i < messages; ++i) {
+      self->send(sink_hdl, payload);
+    }
+    self->sync_send(sink_hdl, done_atom::value).await(
+      [&](uint64_t received) {
+        chrono::duration<double> diff = clock_type::now() - start;
+        if (received != messages) {
+          cerr << "sink received " << received << " messages, expected "
+               << messages << endl;
+        }
+        cout << "name,messages,bytes_per_message,seconds,messages_per_second"
+             << endl
+             << "relay," << messages << "," << msg_size << ","
+             << diff.count() << ","
+             << static_cast<double>(messages) / diff.count() << endl;
+      }
+    );
+  }
+  await_all_actors_done();
+  shutdown();
+}
+
+int main(int argc, char** argv) {
+  size_t messages = 100000;
+  size_t msg_size = 1024;
+  if (argc > 1) messages = stoul(argv[1]);
+  if (argc > 2) msg_size = stoul(argv[2]);
+  // fork before any CAF thread is running
+  int sink_pipe[2];
+  int relay_pipe[2];
+  if (pipe(sink_pipe) != 0 || pipe(relay_pipe) != 0) {
+    cerr << "pipe() failed" << endl;
+    return 1;
+  }
+  auto sink_pid = fork();
+  if (sink_pid == 0) {
+    run_sink(sink_pipe[1]);
+    return 0;
+  }
+  auto relay_pid = fork();
+  if (relay_pid == 0) {
+    run_relay(sink_pipe[0], relay_pipe[1]);
+    return 0;
+  }
+  run_source(relay_pipe[0], messages, msg_size);
+  waitpid(relay_pid, nullptr, 0);
+  waitpid(sink_pid, nullptr, 0);
+}
+
+#else // CAF_WINDOWS
+
+int main() {
+  cerr << "basp_relay requires fork() and is not available on Windows"
+       << endl;
+  return 1;
+}
+
+#endif // CAF_WINDOWS
@@ -0,0 +1,194 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+// This benchmark measures the raw performance of the broker stream layer
+// over loopback. Two brokers run in the same process and either exchange
+// small frames in a ping-pong fashion (latency) or stream fixed-size
+// frames in bursts, flushing after each frame just like BASP does
+// (throughput).
+//
+// Usage: broker_throughput [ROUNDS [MESSAGES [MESSAGE_SIZE]]]
+//
+// Each run prints one CSV line: name,messages,bytes_per_message,seconds,
+// messages_per_second. Running the benchmark under `strace -c -f` shows
+// the number of send/sendmsg calls per message.
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+using namespace caf::io;
+
+using publish_atom = atom_constant<atom("publish")>;
+using burst_atom = atom_constant<atom("burst")>;
+using done_atom = atom_constant<atom("done")>;
+
+using clock_type = chrono::high_resolution_clock;
+
+// number of frames written per burst in streaming mode
+constexpr size_t frames_per_burst = 128;
+
+double seconds_since(clock_type::time_point start) {
+  chrono::duration<double> diff = clock_type::now() - start;
+  return diff.count();
+}
+
+void print_result(const char* name, size_t messages, size_t msg_size,
+                  double seconds) {
+  cout << name << "," << messages << "," << msg_size << "," << seconds << ","
+       << static_cast<double>(messages) / seconds << endl;
+}
+
+// echoes each frame in ping-pong mode (expected_bytes == 0), otherwise
+// acknowledges with a single byte once `expected_bytes` have been received
+behavior server_conn(broker* self, connection_handle hdl, size_t frame_size,
+                     uint64_t expected_bytes) {
+  auto received = make_shared<uint64_t>(0);
+  if (expected_bytes == 0) {
+    self->configure_read(hdl, receive_policy::exactly(frame_size));
+  } else {
+    self->configure_read(hdl, receive_policy::at_most(65536));
+  }
+  return {
+    [=](const new_data_msg& msg) {
+      if (expected_bytes == 0) {
+        self->write(hdl, msg.buf.size(), msg.buf.data());
+        self->flush(hdl);
+        return;
+      }
+      *received += msg.buf.size();
+      if (*received >= expected_bytes) {
+        char ack = 1;
+        self->write(hdl, 1, &ack);
+        self->flush(hdl);
+      }
+    },
+    [=](const connection_closed_msg&) {
+      self->quit();
+    }
+  };
+}
+
+behavior server(broker* self, size_t frame_size, uint64_t expected_bytes) {
+  return {
+    [=](const new_connection_msg& msg) {
+      self->fork(server_conn, msg.handle, frame_size, expected_bytes);
+      self->quit();
+    },
+    [=](publish_atom) {
+      return self->add_tcp_doorman(0, "127.0.0.1").second;
+    }
+  };
+}
+
+behavior ping_client(broker* self, connection_handle hdl, size_t rounds,
+                     const actor& listener) {
+  auto count = make_shared<size_t>(0);
+  auto start = clock_type::now();
+  self->configure_read(hdl, receive_policy::exactly(sizeof(uint32_t)));
+  uint32_t frame = 0;
+  self->write(hdl, sizeof(frame), &frame);
+  self->flush(hdl);
+  return {
+    [=](const new_data_msg& msg) {
+      if (++*count == rounds) {
+        self->send(listener, done_atom::value, seconds_since(start));
+        self->quit();
+        return;
+      }
+      self->write(hdl, msg.buf.size(), msg.buf.data());
+      self->flush(hdl);
+    }
+  };
+}
+
+behavior stream_client(broker* self, connection_handle hdl, size_t messages,
+                       size_t msg_size, const actor& listener) {
+  auto sent = make_shared<size_t>(0);
+  auto start = clock_type::now();
+  vector<char> frame(msg_size, 'x');
+  self->configure_read(hdl, receive_policy::exactly(1));
+  self->send(self, burst_atom::value);
+  return {
+    [=](burst_atom) {
+      for (size_t i = 0; i < frames_per_burst && *sent < messages; ++i) {
+        self->write(hdl, frame.size(), frame.data());
+        self->flush(hdl);
+        ++*sent;
+      }
+      if (*sent < messages) {
+        self->send(self, burst_atom::value);
+      }
+    },
+    [=](const new_data_msg&) {
+      self->send(listener, done_atom::value, seconds_since(start));
+      self->quit();
+    }
+  };
+}
+
+template <class F, class... Ts>
+double run(scoped_actor& self, size_t frame_size, uint64_t expected_bytes,
+           F client, Ts... xs) {
+  auto serv = spawn_io(server, frame_size, expected_bytes);
+  uint16_t port = 0;
+  self->sync_send(serv, publish_atom::value).await(
+    [&](uint16_t res) {
+      port = res;
+    }
+  );
+  actor listener = self;
+  spawn_io_client(client, "127.0.0.1", port, xs..., listener);
+  double result = 0;
+  self->receive(
+    [&](done_atom, double seconds) {
+      result = seconds;
+    }
+  );
+  return result;
+}
+
+int main(int argc, char** argv) {
+  size_t rounds = 10000;
+  size_t messages = 1000000;
+  size_t msg_size = 64;
+  if (argc > 1) rounds = stoul(argv[1]);
+  if (argc > 2) messages = stoul(argv[2]);
+  if (argc > 3) msg_size = stoul(argv[3]);
+  { // lifetime scope of self
+    scoped_actor self;
+    cout << "name,messages,bytes_per_message,seconds,messages_per_second"
+         << endl;
+    auto t = run(self, sizeof(uint32_t), 0, ping_client, rounds);
+    print_result("ping_pong", rounds, sizeof(uint32_t), t);
+    t = run(self, msg_size, static_cast<uint64_t>(messages) * msg_size,
+            stream_client, messages, msg_size);
+    print_result("streaming", messages, msg_size, t);
+  }
+  await_all_actors_done();
+  shutdown();
+}
@@ -0,0 +1,197 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+// This benchmark compares the round-trip latency between two BASP nodes on
+// the same host when using TCP over loopback, Unix domain sockets and
+// shared memory. It forks one server process per transport, each
+// publishing a pong actor:
+// - tcp:      TCP only, local transport disabled on both sides
+// - unix:     explicit path via publish(whom, path) and remote_actor(path)
+// - tcp_auto: TCP address, switched to a Unix domain socket during the
+//             handshake because both nodes share the same host ID
+// - shm:      explicit path with `shm:` prefix, i.e., shared memory rings
+// - tcp_auto_shm: like tcp_auto, but the server offers shared memory
+// The shared memory transports are available on Linux only.
+//
+// Usage: local_latency [ROUNDS]
+//
+// Prints one CSV line per transport: name,rounds,seconds,us_per_round_trip.
+
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <iostream>
+
+#include "caf/config.hpp"
+
+#ifndef CAF_WINDOWS
+# include <unistd.h>
+# include <sys/wait.h>
+#endif
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+using namespace caf::io;
+
+using done_atom = atom_constant<atom("done")>;
+
+using clock_type = chrono::high_resolution_clock;
+
+#ifndef CAF_WINDOWS
+
+void write_port(int fd, uint16_t port) {
+  if (::write(fd, &port, sizeof(port)) != sizeof(port)) {
+    cerr << "unable to write to pipe" << endl;
+  }
+  ::close(fd);
+}
+
+uint16_t read_port(int fd) {
+  uint16_t port = 0;
+  if (::read(fd, &port, sizeof(port)) != sizeof(port)) {
+    cerr << "unable to read from pipe" << endl;
+  }
+  ::close(fd);
+  return port;
+}
+
+behavior pong(event_based_actor* self) {
+  return {
+    [](uint64_t value) {
+      return value;
+    },
+    [=](done_atom) {
+      self->quit();
+    }
+  };
+}
+
+// publishes a pong actor at `path` if not empty, otherwise at a TCP port
+void run_server(int port_pipe, bool local_transport, bool shared_memory,
+                const string& path) {
+  prefer_local_transport(local_transport);
+  shared_memory_transport(shared_memory);
+  auto hdl = spawn(pong);
+  uint16_t port = 0;
+  if (path.empty()) {
+    port = publish(hdl, 0, "127.0.0.1");
+  } else {
+    publish(hdl, path);
+  }
+  write_port(port_pipe, port);
+  await_all_actors_done();
+  shutdown();
+}
+
+pid_t fork_server(int& port_pipe, bool local_transport,
+                  const string& path = "", bool shared_memory = false) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    cerr << "pipe() failed" << endl;
+    exit(1);
+  }
+  auto pid = fork();
+  if (pid == 0) {
+    ::close(fds[0]);
+    run_server(fds[1], local_transport, shared_memory, path);
+    exit(0);
+  }
+  ::close(fds[1]);
+  port_pipe = fds[0];
+  return pid;
+}
+
+void measure(scoped_actor& self, const char* name, const actor& hdl,
+             size_t rounds) {
+  auto start = clock_type::now();
+  for (uint64_t i = 0; i < rounds; ++i) {
+    self->sync_send(hdl, i).await(
+      [&](uint64_t value) {
+        if (value != i) {
+          cerr << "unexpected reply: " << value << endl;
+        }
+      }
+    );
+  }
+  chrono::duration<double> diff = clock_type::now() - start;
+  cout << name << "," << rounds << "," << diff.count() << ","
+       << diff.count() * 1e6 / static_cast<double>(rounds) << endl;
+  self->send(hdl, done_atom::value);
+}
+
+int main(int argc, char** argv) {
+  size_t rounds = 10000;
+  if (argc > 1) rounds = stoul(argv[1]);
+  auto path = "/tmp/caf-local-latency-" + to_string(getpid()) + ".sock";
+  // fork before any CAF thread is running
+  int tcp_pipe;
+  int unix_pipe;
+  int auto_pipe;
+  auto tcp_pid = fork_server(tcp_pipe, false);
+  auto unix_pid = fork_server(unix_pipe, true, path);
+  auto auto_pid = fork_server(auto_pipe, true);
+# ifdef CAF_LINUX
+  auto shm_path = "shm:/tmp/caf-local-latency-shm-" + to_string(getpid())
+                  + ".sock";
+  int shm_pipe;
+  int shm_auto_pipe;
+  auto shm_pid = fork_server(shm_pipe, true, shm_path);
+  auto shm_auto_pid = fork_server(shm_auto_pipe, true, "", true);
+# endif
+  { // lifetime scope of self
+    scoped_actor self;
+    cout << "name,rounds,seconds,us_per_round_trip" << endl;
+    prefer_local_transport(false);
+    measure(self, "tcp", remote_actor("127.0.0.1", read_port(tcp_pipe)),
+            rounds);
+    read_port(unix_pipe);
+    measure(self, "unix", remote_actor(path), rounds);
+    prefer_local_transport(true);
+    measure(self, "tcp_auto",
+            remote_actor("127.0.0.1", read_port(auto_pipe)), rounds);
+#   ifdef CAF_LINUX
+    read_port(shm_pipe);
+    measure(self, "shm", remote_actor(shm_path), rounds);
+    measure(self, "tcp_auto_shm",
+            remote_actor("127.0.0.1", read_port(shm_auto_pipe)), rounds);
+#   endif
+  }
+  waitpid(tcp_pid, nullptr, 0);
+  waitpid(unix_pid, nullptr, 0);
+  waitpid(auto_pid, nullptr, 0);
+# ifdef CAF_LINUX
+  waitpid(shm_pid, nullptr, 0);
+  waitpid(shm_auto_pid, nullptr, 0);
+# endif
+  await_all_actors_done();
+  shutdown();
+}
+
+#else // CAF_WINDOWS
+
+int main() {
+  cerr << "local_latency requires fork() and is not available on Windows"
+       << endl;
+  return 1;
+}
+
+#endif // CAF_WINDOWS
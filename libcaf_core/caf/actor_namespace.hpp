@@ -21,6 +21,8 @@
 #define CAF_ACTOR_NAMESPACE_HPP
 
 #include <map>
+#include <mutex>
+#include <memory>
 #include <utility>
 #include <functional>
 
@@ -56,6 +58,13 @@ class actor_namespace {
 
   actor_namespace(backend& mgm);
 
+  /**
+   * Creates a namespace that shares all proxies with `other` but creates
+   * new proxies using `mgm`. All namespaces sharing their proxies can be
+   * used concurrently from different threads.
+   */
+  actor_namespace(backend& mgm, actor_namespace& other);
+
   /**
    * Writes an actor address to `sink` and adds the actor
    * to the list of known actors for a later deserialization.
@@ -111,8 +120,13 @@ class actor_namespace {
   bool empty() const;
 
  private:
+  struct proxies {
+    std::mutex mtx;
+    std::map<key_type, proxy_map> nodes;
+  };
+
   backend& m_backend;
-  std::map<key_type, proxy_map> m_proxies;
+  std::shared_ptr<proxies> m_proxies;
 };
 
 } // namespace caf
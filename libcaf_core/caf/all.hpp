@@ -52,6 +52,7 @@
 #include "caf/replies_to.hpp"
 #include "caf/serializer.hpp"
 #include "caf/actor_proxy.hpp"
+#include "caf/trace_context.hpp"
 #include "caf/exit_reason.hpp"
 #include "caf/from_string.hpp"
 #include "caf/local_actor.hpp"
@@ -72,6 +73,7 @@
 #include "caf/behavior_policy.hpp"
 #include "caf/continue_helper.hpp"
 #include "caf/mailbox_element.hpp"
+#include "caf/message_latency.hpp"
 #include "caf/message_builder.hpp"
 #include "caf/message_handler.hpp"
 #include "caf/response_handle.hpp"
@@ -85,6 +87,7 @@
 #include "caf/primitive_variant.hpp"
 #include "caf/uniform_type_info.hpp"
 #include "caf/wildcard_position.hpp"
+#include "caf/runtime_inspector.hpp"
 #include "caf/timeout_definition.hpp"
 #include "caf/binary_deserializer.hpp"
 #include "caf/await_all_actors_done.hpp"
@@ -22,6 +22,7 @@
 
 #include <map>
 #include <mutex>
+#include <vector>
 #include <thread>
 #include <atomic>
 #include <cstdint>
@@ -75,6 +76,18 @@ class actor_registry : public singleton_mixin<actor_registry> {
   // blocks the caller until running-actors-count becomes `expected`
   void await_running_count_equal(size_t expected);
 
+  // stores a running actor for runtime inspection
+  void add_live(const abstract_actor_ptr& value);
+
+  // removes an actor stored via `add_live`
+  void remove_live(actor_id key);
+
+  // removes all actors stored via `add_live`
+  void clear_live();
+
+  // returns all actors stored via `add_live`
+  std::vector<abstract_actor_ptr> live() const;
+
  private:
   using entries = std::map<actor_id, value_type>;
 
@@ -88,6 +101,11 @@ class actor_registry : public singleton_mixin<actor_registry> {
 
   mutable detail::shared_spinlock m_instances_mtx;
   entries m_entries;
+
+  // allows `remove_live` to skip locking if no actor is stored
+  std::atomic<size_t> m_live_count;
+  mutable detail::shared_spinlock m_live_mtx;
+  std::map<actor_id, abstract_actor_ptr> m_live;
 };
 
 } // namespace detail
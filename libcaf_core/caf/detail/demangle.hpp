@@ -0,0 +1,38 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_DEMANGLE_HPP
+#define CAF_DETAIL_DEMANGLE_HPP
+
+#include <string>
+
+namespace caf {
+namespace detail {
+
+/**
+ * Returns the demangled form of a type name as returned
+ * by `std::type_info::name`, or `name` itself if it is
+ * not a mangled name.
+ */
+std::string demangle(const char* name);
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_DEMANGLE_HPP
@@ -20,6 +20,10 @@
 #ifndef CAF_LOGGING_HPP
 #define CAF_LOGGING_HPP
 
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
 #include <cstring>
 #include <sstream>
 #include <iostream>
@@ -41,15 +45,30 @@
  * 3: + debug
  * 4: + trace (prints for each logged method entry and exit message)
  *
- * Note: this logger emits log4j style XML output; logs are best viewed
- *       using a log4j viewer, e.g., http://code.google.com/p/otroslogviewer/
+ * At runtime, `logging::set_level` lowers the level globally or for
+ * individual classes. Arguments of disabled statements are not evaluated.
  *
+ * Log statements write binary records into a lock-free ring buffer of
+ * the calling thread. A background thread drains these buffers and
+ * formats the records into the text log file.
  */
 namespace caf {
 namespace detail {
 
 class singletons;
 
+/**
+ * Describes the static part of a log statement. Each log statement
+ * owns one instance with static storage duration, i.e., the address
+ * of a site identifies the statement in a log record.
+ */
+struct log_site {
+  const char* level;
+  const char* function_name;
+  const char* file_name;
+  int line_num;
+};
+
 class logging {
 
   friend class detail::singletons;
@@ -60,26 +79,60 @@ class logging {
   // returns the previously set actor id
   actor_id set_aid(actor_id aid);
 
-  virtual void log(const char* level, const char* class_name,
-           const char* function_name, const char* file_name,
-           int line_num, const std::string& msg) = 0;
+  /**
+   * Appends the encoded record `buf` of `size` bytes
+   * to the ring buffer of the calling thread.
+   */
+  virtual void append(const char* buf, size_t size) = 0;
+
+  /**
+   * Sets the level for all classes without a level of their own.
+   * Statements above `CAF_LOG_LEVEL` remain disabled.
+   */
+  static void set_level(int level);
+
+  /**
+   * Sets the level for all classes in `component`, which is either a
+   * class or a namespace, e.g., `caf::io` or `caf.io.basp_broker`.
+   * The most specific component of a class determines its level.
+   */
+  static void set_level(const std::string& component, int level);
+
+  /**
+   * Removes the levels of all components.
+   */
+  static void reset_levels();
+
+  /**
+   * Returns whether any class logs statements of `level`. This check
+   * precedes all other work of a log statement and costs one branch.
+   */
+  static inline bool enabled(int level) {
+    return level <= s_max_level.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns whether `class_name` logs statements of `level`.
+   */
+  static bool accepts(int level, const char* class_name);
 
   class trace_helper {
 
    public:
 
-    trace_helper(std::string class_name, const char* fun_name,
-           const char* file_name, int line_num,
-           const std::string& msg);
+    trace_helper(const log_site& site, const char* class_name);
 
     ~trace_helper();
 
+    inline bool enabled() const {
+      return m_enabled;
+    }
+
    private:
 
-    std::string m_class;
-    const char* m_fun_name;
-    const char* m_file_name;
-    int m_line_num;
+    const log_site& m_site;
+    const char* m_class;
+    bool m_enabled;
 
   };
 
@@ -95,37 +148,148 @@ class logging {
 
   inline void dispose() { delete this; }
 
+ private:
+
+  // maximum of the global level and all component levels
+  static std::atomic<int> s_max_level;
+
 };
 
-struct oss_wr {
+/**
+ * Encodes a single log statement into a binary record without
+ * formatting its arguments. Integers, floating points, booleans and
+ * strings are stored as raw bytes and only the logger thread converts
+ * them to text. Any other type is rendered via `operator<<` in place.
+ * The record is passed to the logger when this object is destroyed.
+ */
+class log_record {
 
-  inline oss_wr() { }
+ public:
 
-  inline oss_wr(oss_wr&& other) : m_str(std::move(other.m_str)) {}
+  /**
+   * Tags the arguments of a record.
+   */
+  enum arg_type : char {
+    signed_arg,
+    unsigned_arg,
+    double_arg,
+    bool_arg,
+    char_arg,
+    string_arg
+  };
 
-  std::string m_str;
+  // strings are truncated if a record would exceed this size
+  static constexpr size_t max_size = 16 * 1024;
 
-  inline std::string str() { return std::move(m_str); }
+  /**
+   * Starts a record for `site`, which is passed to `target` or
+   * to the logger singleton if `target == nullptr`.
+   */
+  log_record(const log_site& site, const char* class_name,
+             logging* target = nullptr);
 
-};
+  log_record(const log_record&) = delete;
+
+  log_record& operator=(const log_record&) = delete;
+
+  ~log_record();
+
+  inline log_record& operator<<(const std::string& str) {
+    append_string(str.data(), str.size());
+    return *this;
+  }
+
+  inline log_record& operator<<(const char* str) {
+    append_string(str, strlen(str));
+    return *this;
+  }
+
+  inline log_record& operator<<(char* str) {
+    append_string(str, strlen(str));
+    return *this;
+  }
+
+  inline log_record& operator<<(bool x) {
+    append(bool_arg, static_cast<char>(x ? 1 : 0));
+    return *this;
+  }
+
+  inline log_record& operator<<(char x) {
+    append(char_arg, x);
+    return *this;
+  }
+
+  inline log_record& operator<<(signed char x) {
+    append(char_arg, static_cast<char>(x));
+    return *this;
+  }
+
+  inline log_record& operator<<(unsigned char x) {
+    append(char_arg, static_cast<char>(x));
+    return *this;
+  }
 
-inline oss_wr operator<<(oss_wr&& lhs, std::string str) {
-  lhs.m_str += std::move(str);
-  return std::move(lhs);
-}
+  template <class T>
+  typename std::enable_if<
+    std::is_integral<T>::value && std::is_signed<T>::value,
+    log_record&
+  >::type
+  operator<<(T x) {
+    append(signed_arg, static_cast<int64_t>(x));
+    return *this;
+  }
+
+  template <class T>
+  typename std::enable_if<
+    std::is_integral<T>::value && !std::is_signed<T>::value,
+    log_record&
+  >::type
+  operator<<(T x) {
+    append(unsigned_arg, static_cast<uint64_t>(x));
+    return *this;
+  }
+
+  template <class T>
+  typename std::enable_if<std::is_floating_point<T>::value, log_record&>::type
+  operator<<(T x) {
+    append(double_arg, static_cast<double>(x));
+    return *this;
+  }
+
+  template <class T>
+  typename std::enable_if<!std::is_arithmetic<T>::value, log_record&>::type
+  operator<<(const T& x) {
+    std::ostringstream oss;
+    oss << x;
+    return *this << oss.str();
+  }
 
-inline oss_wr operator<<(oss_wr&& lhs, const char* str) {
-  lhs.m_str += str;
-  return std::move(lhs);
-}
+  // manipulators such as `std::boolalpha` have no effect on records
+  inline log_record& operator<<(std::ios_base& (*)(std::ios_base&)) {
+    return *this;
+  }
 
-template <class T>
-oss_wr operator<<(oss_wr&& lhs, T rhs) {
-  std::ostringstream oss;
-  oss << rhs;
-  lhs.m_str += oss.str();
-  return std::move(lhs);
-}
+  /**
+   * Returns the buffer for encoding records on the calling thread.
+   */
+  static std::vector<char>& thread_buffer();
+
+ private:
+
+  template <class T>
+  void append(arg_type type, T x) {
+    m_buf.push_back(type);
+    auto first = reinterpret_cast<const char*>(&x);
+    m_buf.insert(m_buf.end(), first, first + sizeof(T));
+  }
+
+  void append_string(const char* str, size_t size);
+
+  logging* m_target;
+  std::vector<char>& m_buf;
+  size_t m_offset;
+
+};
 
 } // namespace detail
 } // namespace caf
@@ -155,21 +319,23 @@ oss_wr operator<<(oss_wr&& lhs, T rhs) {
 
 #ifndef CAF_LOG_LEVEL
 inline caf::actor_id caf_set_aid_dummy() { return 0; }
-#define CAF_LOG_IMPL(lvlname, classname, funname, message)                     \
+#define CAF_LOG_IMPL(lvl, lvlname, classname, funname, message)                \
   CAF_PRINT_ERROR_IMPL(lvlname, classname, funname, message)
 #define CAF_PUSH_AID(unused) static_cast<void>(0)
 #define CAF_PUSH_AID_FROM_PTR(unused) static_cast<void>(0)
 #define CAF_SET_AID(unused) caf_set_aid_dummy()
 #else
-#define CAF_LOG_IMPL(lvlname, classname, funname, message)                     \
-  if (strcmp(lvlname, "ERROR") == 0) {                                         \
-    CAF_PRINT_ERROR_IMPL(lvlname, classname, funname, message);                \
+#define CAF_LOG_IMPL(lvl, lvlname, classname, funname, message)                \
+  if (caf::detail::logging::enabled(lvl)                                       \
+      && caf::detail::logging::accepts(lvl, classname)) {                      \
+    static const caf::detail::log_site caf_log_site_{lvlname, funname,         \
+                                                      __FILE__, __LINE__};     \
+    if (lvl == CAF_ERROR) {                                                    \
+      CAF_PRINT_ERROR_IMPL(lvlname, classname, funname, message);              \
+    }                                                                          \
+    caf::detail::log_record{caf_log_site_, classname} << message;              \
   }                                                                            \
-  caf::detail::singletons::get_logger()->log(lvlname, classname, funname,      \
-                                             __FILE__, __LINE__,               \
-                                             (caf::detail::oss_wr{}            \
-                                              << std::boolalpha                \
-                                              << message).str())
+  CAF_VOID_STMT
 #define CAF_PUSH_AID(aid_arg)                                                  \
   auto prev_aid_in_scope                                                       \
     = caf::detail::singletons::get_logger()->set_aid(aid_arg);                 \
@@ -185,29 +351,50 @@ inline caf::actor_id caf_set_aid_dummy() { return 0; }
 
 #define CAF_CLASS_NAME typeid(*this).name()
 
-#define CAF_PRINT0(lvlname, classname, funname, msg)                           \
-  CAF_LOG_IMPL(lvlname, classname, funname, msg)
+/**
+ * @def CAF_LOG_ENABLED
+ * Evaluates to `true` if a statement of given level
+ * inside a member function would produce output.
+ */
+#ifndef CAF_LOG_LEVEL
+#define CAF_LOG_ENABLED(level) false
+#else
+#define CAF_LOG_ENABLED(level)                                                 \
+  (level <= CAF_LOG_LEVEL && caf::detail::logging::enabled(level)              \
+   && caf::detail::logging::accepts(level, CAF_CLASS_NAME))
+#endif
 
-#define CAF_PRINT_IF0(stmt, lvlname, classname, funname, msg)                  \
+#define CAF_PRINT_IF_IMPL(stmt, lvl, lvlname, classname, funname, msg)         \
   if (stmt) {                                                                  \
-    CAF_LOG_IMPL(lvlname, classname, funname, msg);                            \
+    CAF_LOG_IMPL(lvl, lvlname, classname, funname, msg);                       \
   }                                                                            \
   CAF_VOID_STMT
 
+#define CAF_PRINT0(lvlname, classname, funname, msg)                           \
+  CAF_LOG_IMPL(CAF_ERROR, lvlname, classname, funname, msg)
+
+#define CAF_PRINT_IF0(stmt, lvlname, classname, funname, msg)                  \
+  CAF_PRINT_IF_IMPL(stmt, CAF_ERROR, lvlname, classname, funname, msg)
+
 #define CAF_PRINT1(lvlname, classname, funname, msg)                           \
-  CAF_PRINT0(lvlname, classname, funname, msg)
+  CAF_LOG_IMPL(CAF_WARNING, lvlname, classname, funname, msg)
 
 #define CAF_PRINT_IF1(stmt, lvlname, classname, funname, msg)                  \
-  CAF_PRINT_IF0(stmt, lvlname, classname, funname, msg)
+  CAF_PRINT_IF_IMPL(stmt, CAF_WARNING, lvlname, classname, funname, msg)
 
 #if !defined(CAF_LOG_LEVEL) || CAF_LOG_LEVEL < CAF_TRACE
 #define CAF_PRINT4(arg0, arg1, arg2, arg3)
 #else
 #define CAF_PRINT4(lvlname, classname, funname, msg)                           \
+  static const caf::detail::log_site caf_trace_site_{lvlname, funname,         \
+                                                      __FILE__, __LINE__};     \
   caf::detail::logging::trace_helper caf_trace_helper_ {                       \
-    classname, funname, __FILE__, __LINE__,                                    \
-      (caf::detail::oss_wr{} << msg).str()                                     \
-  }
+    caf_trace_site_, classname                                                 \
+  };                                                                           \
+  if (caf_trace_helper_.enabled()) {                                           \
+    caf::detail::log_record{caf_trace_site_, classname} << "ENTRY " << msg;    \
+  }                                                                            \
+  CAF_VOID_STMT
 #endif
 
 #if !defined(CAF_LOG_LEVEL) || CAF_LOG_LEVEL < CAF_DEBUG
@@ -215,9 +402,9 @@ inline caf::actor_id caf_set_aid_dummy() { return 0; }
 #define CAF_PRINT_IF3(arg0, arg1, arg2, arg3, arg4)
 #else
 #define CAF_PRINT3(lvlname, classname, funname, msg)                           \
-  CAF_PRINT0(lvlname, classname, funname, msg)
+  CAF_LOG_IMPL(CAF_DEBUG, lvlname, classname, funname, msg)
 #define CAF_PRINT_IF3(stmt, lvlname, classname, funname, msg)                  \
-  CAF_PRINT_IF0(stmt, lvlname, classname, funname, msg)
+  CAF_PRINT_IF_IMPL(stmt, CAF_DEBUG, lvlname, classname, funname, msg)
 #endif
 
 #if !defined(CAF_LOG_LEVEL) || CAF_LOG_LEVEL < CAF_INFO
@@ -225,9 +412,9 @@ inline caf::actor_id caf_set_aid_dummy() { return 0; }
 #define CAF_PRINT_IF2(arg0, arg1, arg2, arg3, arg4)
 #else
 #define CAF_PRINT2(lvlname, classname, funname, msg)                           \
-  CAF_PRINT0(lvlname, classname, funname, msg)
+  CAF_LOG_IMPL(CAF_INFO, lvlname, classname, funname, msg)
 #define CAF_PRINT_IF2(stmt, lvlname, classname, funname, msg)                  \
-  CAF_PRINT_IF0(stmt, lvlname, classname, funname, msg)
+  CAF_PRINT_IF_IMPL(stmt, CAF_INFO, lvlname, classname, funname, msg)
 #endif
 
 #define CAF_EVAL(what) what
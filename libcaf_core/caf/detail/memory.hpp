@@ -21,8 +21,10 @@
 #define CAF_DETAIL_MEMORY_HPP
 
 #include <new>
+#include <atomic>
 #include <vector>
 #include <memory>
+#include <cstdint>
 #include <utility>
 #include <typeinfo>
 
@@ -66,10 +68,27 @@ class instance_wrapper {
 
 };
 
+// enables counters for runtime inspection, see runtime_inspector.hpp
+extern std::atomic<bool> s_inspect_runtime;
+
+/**
+ * Occupancy of the memory caches for a single type.
+ */
+struct memory_usage {
+  const std::type_info* type;
+  // instances allocated while runtime inspection was enabled
+  int64_t in_use;
+  // free instances held by all threads
+  uint64_t cached;
+};
+
 class memory_cache {
 
  public:
 
+  // registers this cache for memory::usage()
+  memory_cache(const std::type_info& type);
+
   virtual ~memory_cache();
 
   // calls dtor and either releases memory or re-uses it later
@@ -80,6 +99,23 @@ class memory_cache {
   // casts `ptr` to the derived type and returns it
   virtual void* downcast(memory_managed* ptr) = 0;
 
+  inline const std::type_info& type() const {
+    return *m_type;
+  }
+
+  // returns the number of free instances in this cache
+  inline uint64_t cached() const {
+    return m_cached.load(std::memory_order_relaxed);
+  }
+
+ protected:
+
+  const std::type_info* m_type;
+  // written only by the thread owning this cache
+  std::atomic<uint64_t> m_cached;
+  // counts instances of `m_type` in use for all threads
+  std::atomic<int64_t>* m_in_use;
+
 };
 
 class instance_wrapper;
@@ -105,6 +141,9 @@ class memory {
     return nullptr;
   }
 
+  // returns the occupancy of all caches, i.e., nothing
+  static std::vector<memory_usage> usage();
+
 };
 
 #else // CAF_NO_MEM_MANAGEMENT
@@ -118,13 +157,21 @@ class basic_memory_cache : public memory_cache {
 
   struct wrapper : instance_wrapper {
     ref_counted* parent;
+    // non-null if allocated while runtime inspection was enabled
+    std::atomic<int64_t>* in_use;
     union {
       T instance;
 
     };
-    wrapper() : parent(nullptr) {}
+    wrapper() : parent(nullptr), in_use(nullptr) {}
     ~wrapper() {}
-    void destroy() { instance.~T(); }
+    void destroy() {
+      instance.~T();
+      if (in_use) {
+        in_use->fetch_sub(1, std::memory_order_relaxed);
+        in_use = nullptr;
+      }
+    }
     void deallocate() { parent->deref(); }
 
   };
@@ -157,7 +204,9 @@ class basic_memory_cache : public memory_cache {
 
   std::vector<wrapper*> cached_elements;
 
-  basic_memory_cache() { cached_elements.reserve(dsize); }
+  basic_memory_cache() : memory_cache(typeid(T)) {
+    cached_elements.reserve(dsize);
+  }
 
   ~basic_memory_cache() {
     for (auto e : cached_elements) e->deallocate();
@@ -183,6 +232,11 @@ class basic_memory_cache : public memory_cache {
     }
     wrapper* wptr = cached_elements.back();
     cached_elements.pop_back();
+    m_cached.store(cached_elements.size(), std::memory_order_relaxed);
+    if (s_inspect_runtime.load(std::memory_order_relaxed)) {
+      wptr->in_use = m_in_use;
+      m_in_use->fetch_add(1, std::memory_order_relaxed);
+    }
     return std::make_pair(wptr, &(wptr->instance));
   }
 
@@ -209,6 +263,9 @@ class memory {
 
   static memory_cache* get_cache_map_entry(const std::type_info* tinf);
 
+  // returns the occupancy of the caches of all threads, one entry per type
+  static std::vector<memory_usage> usage();
+
  private:
 
   static void add_cache_map_entry(const std::type_info* tinf,
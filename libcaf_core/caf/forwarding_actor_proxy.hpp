@@ -20,19 +20,59 @@
 #ifndef CAF_FORWARDING_ACTOR_PROXY_HPP
 #define CAF_FORWARDING_ACTOR_PROXY_HPP
 
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
 #include "caf/actor.hpp"
 #include "caf/actor_proxy.hpp"
+#include "caf/outbound_queue.hpp"
 
 #include "caf/detail/shared_spinlock.hpp"
 
 namespace caf {
 
+/**
+ * Denotes how a proxy handles messages from local senders
+ * while its number of messages in flight is at its high-water mark.
+ */
+enum class backpressure_policy {
+  /**
+   * Discards the message. Requests are treated as with `error_reply`,
+   * because their senders would otherwise wait forever.
+   */
+  drop,
+  /**
+   * Discards the message and sends `(error_atom, "backpressure")` back to
+   * the sender, as response if the message was a request.
+   */
+  error_reply,
+  /**
+   * Blocks the sending thread until the remote node returned credit.
+   * Actors running in the scheduler or in the I/O loop are never blocked,
+   * their messages are treated as with `error_reply` instead.
+   */
+  suspend
+};
+
 /**
  * Implements a simple proxy forwarding all operations to a manager.
+ * Messages are either put into an outbound queue for the remote node,
+ * if available, or are sent to the manager as `_Dispatch` messages.
+ *
+ * A proxy with an outbound queue and a nonzero high-water mark counts
+ * each message until the manager returns credit for it via `grant`.
+ * Once the number of messages in flight reaches the high-water mark,
+ * the proxy reports backpressure and applies its policy to new messages.
+ * Responses to requests are never refused.
  */
 class forwarding_actor_proxy : public actor_proxy {
  public:
-  forwarding_actor_proxy(actor_id mid, node_id pinfo, actor parent);
+  forwarding_actor_proxy(actor_id mid, node_id pinfo, actor parent,
+                         outbound_queue_ptr queue = nullptr,
+                         size_t high_water_mark = 0,
+                         backpressure_policy policy
+                           = backpressure_policy::suspend);
 
   ~forwarding_actor_proxy();
 
@@ -51,11 +91,33 @@ class forwarding_actor_proxy : public actor_proxy {
 
   void manager(actor new_manager);
 
+  /**
+   * Returns whether the number of messages in flight
+   * to the remote actor reached the high-water mark.
+   */
+  bool backpressure() const;
+
+  /**
+   * Returns credit for `num` messages that have been
+   * delivered by the remote node.
+   */
+  void grant(size_t num);
+
  private:
   void forward_msg(const actor_addr& sender, message_id mid, message msg);
 
+  // applies the backpressure policy if needed,
+  // returns false if `mid` from `sender` is refused
+  bool admit(const actor_addr& sender, message_id mid, execution_unit* host);
+
   mutable detail::shared_spinlock m_manager_mtx;
   actor m_manager;
+  outbound_queue_ptr m_queue;
+  size_t m_high_water_mark;
+  backpressure_policy m_policy;
+  std::atomic<size_t> m_in_flight;
+  std::mutex m_credit_mtx;
+  std::condition_variable m_credit_cv;
 };
 
 } // namespace caf
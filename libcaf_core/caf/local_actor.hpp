@@ -43,6 +43,7 @@
 #include "caf/mailbox_element.hpp"
 #include "caf/message_handler.hpp"
 #include "caf/response_promise.hpp"
+#include "caf/runtime_inspector.hpp"
 #include "caf/message_priority.hpp"
 #include "caf/check_typed_input.hpp"
 
@@ -529,9 +530,30 @@ class local_actor : public extend<abstract_actor>::with<mixin::memory_cached> {
 
   template <class... Ts>
   inline mailbox_element* new_mailbox_element(Ts&&... args) {
+    if (detail::s_inspect_runtime.load(std::memory_order_relaxed)) {
+      m_enqueued_messages.fetch_add(1, std::memory_order_relaxed);
+    }
     return mailbox_element::create(std::forward<Ts>(args)...);
   }
 
+  // called by the actor itself for each message it handled or dropped
+  inline void message_processed() {
+    if (detail::s_inspect_runtime.load(std::memory_order_relaxed)) {
+      auto n = m_processed_messages.load(std::memory_order_relaxed);
+      m_processed_messages.store(n + 1, std::memory_order_relaxed);
+    }
+  }
+
+  // returns the number of messages enqueued while collecting statistics
+  inline uint64_t enqueued_messages() const {
+    return m_enqueued_messages.load(std::memory_order_relaxed);
+  }
+
+  // returns the number of messages processed while collecting statistics
+  inline uint64_t processed_messages() const {
+    return m_processed_messages.load(std::memory_order_relaxed);
+  }
+
  protected:
   // identifies the ID of the last sent synchronous request
   message_id m_last_request_id;
@@ -549,6 +571,10 @@ class local_actor : public extend<abstract_actor>::with<mixin::memory_cached> {
   // set by quit
   uint32_t m_planned_exit_reason;
 
+  // counters for runtime inspection
+  std::atomic<uint64_t> m_enqueued_messages;
+  std::atomic<uint64_t> m_processed_messages;
+
   /** @endcond */
 
  private:
@@ -27,6 +27,7 @@
 #include "caf/actor_addr.hpp"
 #include "caf/message_id.hpp"
 #include "caf/ref_counted.hpp"
+#include "caf/trace_context.hpp"
 
 #include "caf/mixin/memory_cached.hpp"
 
@@ -48,6 +49,8 @@ class mailbox_element : public extend<memory_managed>::
   actor_addr sender;
   message_id mid;
   message msg; // 'content field'
+  uint64_t enqueued = 0; // timestamp if message latencies are traced
+  trace_context trace{0, 0, 0, false}; // context of the sender
 
   ~mailbox_element();
 
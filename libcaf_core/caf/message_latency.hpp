@@ -0,0 +1,157 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_MESSAGE_LATENCY_HPP
+#define CAF_MESSAGE_LATENCY_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <typeinfo>
+
+namespace caf {
+
+/**
+ * A lock-free histogram of durations in nanoseconds. Values below 16
+ * are recorded exactly, larger values fall into one of 16 buckets per
+ * power of two, i.e., each bucket covers a range of at most 1/16 of its
+ * lower bound. All member functions are safe to call concurrently.
+ */
+class latency_histogram {
+
+ public:
+
+  static constexpr size_t sub_buckets = 16;
+
+  static constexpr size_t num_buckets = 61 * sub_buckets;
+
+  latency_histogram();
+
+  latency_histogram(const latency_histogram&) = delete;
+
+  latency_histogram& operator=(const latency_histogram&) = delete;
+
+  void record(uint64_t ns);
+
+  /**
+   * Returns the number of recorded values.
+   */
+  uint64_t count() const;
+
+  /**
+   * Returns the arithmetic mean of all recorded values.
+   */
+  double mean() const;
+
+  /**
+   * Returns the largest recorded value.
+   */
+  uint64_t max() const;
+
+  /**
+   * Returns an upper bound for the value below which `p` percent
+   * of all recorded values fall, e.g., `percentile(99)`.
+   */
+  uint64_t percentile(double p) const;
+
+  void reset();
+
+  // returns the index of the bucket for `ns`
+  static size_t bucket_of(uint64_t ns);
+
+  // returns the largest value of bucket `index`
+  static uint64_t upper_bound_of(size_t index);
+
+ private:
+
+  std::array<std::atomic<uint64_t>, num_buckets> m_buckets;
+  std::atomic<uint64_t> m_count;
+  std::atomic<uint64_t> m_sum;
+  std::atomic<uint64_t> m_max;
+
+};
+
+/**
+ * Latencies of all messages handled by one actor type.
+ */
+struct message_latency {
+  /**
+   * Time between creating a mailbox element and invoking its handler.
+   */
+  latency_histogram queueing;
+  /**
+   * Time spent executing message handlers.
+   */
+  latency_histogram handling;
+};
+
+/**
+ * Enables or disables tracing of message latencies (disabled by default).
+ * Mailbox elements receive a timestamp as they are enqueued while tracing
+ * is enabled, and actors record the latencies of these messages on
+ * handling them.
+ */
+void trace_message_latency(bool enable);
+
+/**
+ * Queries whether message latencies are traced.
+ */
+bool trace_message_latency();
+
+/**
+ * Returns the latencies recorded for actors of type `tinf`.
+ * The returned object remains valid until the program terminates.
+ */
+const message_latency& message_latency_of(const std::type_info& tinf);
+
+/**
+ * Writes the latencies of all actor types to `out`, one line per type
+ * in the format "type,count,queueing_mean,queueing_p50,queueing_p99,
+ * queueing_max,handling_mean,handling_p50,handling_p99,handling_max"
+ * with all durations in microseconds.
+ */
+void dump_message_latency(std::ostream& out);
+
+/**
+ * Discards all recorded latencies.
+ */
+void reset_message_latency();
+
+namespace detail {
+
+// timestamp for message latencies in nanoseconds, never 0
+inline uint64_t latency_clock() {
+  using namespace std::chrono;
+  auto t = steady_clock::now().time_since_epoch();
+  return static_cast<uint64_t>(duration_cast<nanoseconds>(t).count()) | 1;
+}
+
+// enables timestamps in new mailbox elements
+extern std::atomic<bool> s_trace_message_latency;
+
+void record_message_latency(const std::type_info& tinf, uint64_t enqueued,
+                            uint64_t started, uint64_t finished);
+
+} // namespace detail
+
+} // namespace caf
+
+#endif // CAF_MESSAGE_LATENCY_HPP
@@ -49,10 +49,10 @@ constexpr invalid_node_id_t invalid_node_id = invalid_node_id_t{};
 /**
  * A node ID consists of a host ID and process ID. The host ID identifies
  * the physical machine in the network, whereas the process ID identifies
- * the running system-level process on that machine.
+ * the running system-level process on that machine. Node IDs are interned
+ * process-wide, i.e., testing two node IDs for equality compares pointers.
  */
-class node_id : detail::comparable<node_id>,
-        detail::comparable<node_id, invalid_node_id_t> {
+class node_id : detail::comparable<node_id, invalid_node_id_t> {
 
   using super = ref_counted;
 
@@ -149,8 +149,37 @@ class node_id : detail::comparable<node_id>,
   // "inherited" from comparable<node_id, invalid_node_id_t>
   int compare(const invalid_node_id_t&) const;
 
+  // `dataptr` must be interned, i.e., obtained from `intern`
   node_id(intrusive_ptr<data> dataptr);
 
+  // returns the unique data instance for given process and host ID
+  static intrusive_ptr<data> intern(uint32_t process_id,
+                                    const host_id_type& host_id);
+
+  friend inline bool operator==(const node_id& lhs, const node_id& rhs) {
+    return lhs.m_data == rhs.m_data;
+  }
+
+  friend inline bool operator!=(const node_id& lhs, const node_id& rhs) {
+    return lhs.m_data != rhs.m_data;
+  }
+
+  friend inline bool operator<(const node_id& lhs, const node_id& rhs) {
+    return lhs.compare(rhs) < 0;
+  }
+
+  friend inline bool operator<=(const node_id& lhs, const node_id& rhs) {
+    return lhs.compare(rhs) <= 0;
+  }
+
+  friend inline bool operator>(const node_id& lhs, const node_id& rhs) {
+    return lhs.compare(rhs) > 0;
+  }
+
+  friend inline bool operator>=(const node_id& lhs, const node_id& rhs) {
+    return lhs.compare(rhs) >= 0;
+  }
+
   /** @endcond */
 
  private:
@@ -0,0 +1,161 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_OUTBOUND_QUEUE_HPP
+#define CAF_OUTBOUND_QUEUE_HPP
+
+#include <memory>
+
+#include "caf/extend.hpp"
+#include "caf/message.hpp"
+#include "caf/actor_addr.hpp"
+#include "caf/message_id.hpp"
+#include "caf/exit_reason.hpp"
+#include "caf/ref_counted.hpp"
+#include "caf/trace_context.hpp"
+#include "caf/intrusive_ptr.hpp"
+
+#include "caf/mixin/memory_cached.hpp"
+
+#include "caf/detail/memory.hpp"
+#include "caf/detail/single_reader_queue.hpp"
+
+namespace caf {
+
+/**
+ * A message that is about to be sent to a remote actor.
+ */
+class outbound_message : public extend<memory_managed>::
+                         with<mixin::memory_cached> {
+
+  friend class detail::memory;
+
+ public:
+
+  outbound_message* next; // intrusive next pointer
+  actor_addr sender;
+  actor_addr receiver;
+  message_id mid;
+  message msg;
+  // counts against the high-water mark of the receiving proxy
+  bool flow_controlled;
+  // context of the sender at the time of sending
+  trace_context trace;
+
+  ~outbound_message();
+
+  outbound_message(outbound_message&&) = delete;
+  outbound_message(const outbound_message&) = delete;
+  outbound_message& operator=(outbound_message&&) = delete;
+  outbound_message& operator=(const outbound_message&) = delete;
+
+  static outbound_message* create(actor_addr sender, actor_addr receiver,
+                                  message_id mid, message msg,
+                                  bool flow_controlled = false) {
+    return detail::memory::create<outbound_message>(std::move(sender),
+                                                    std::move(receiver), mid,
+                                                    std::move(msg),
+                                                    flow_controlled);
+  }
+
+ private:
+
+  outbound_message() = default;
+
+  outbound_message(actor_addr sender, actor_addr receiver,
+                   message_id mid, message msg, bool flow_controlled);
+
+};
+
+using outbound_message_ptr =
+  std::unique_ptr<outbound_message, detail::disposer>;
+
+/**
+ * A lock-free queue for messages to a remote node. Any number of proxies
+ * can enqueue messages concurrently, whereas only a single reader, usually
+ * the broker managing the connection to the remote node, drains it.
+ * The reader is notified via `wakeup()` whenever the queue changes
+ * from empty to non-empty. Hence, the reader is woken up at most once
+ * per batch of messages rather than once per message.
+ */
+class outbound_queue : public ref_counted {
+ public:
+  outbound_queue();
+
+  ~outbound_queue();
+
+  /**
+   * Adds a new message to the queue and calls `wakeup()` if the
+   * queue was empty. Returns `false` if the queue has been closed.
+   */
+  bool enqueue(const actor_addr& sender, const actor_addr& receiver,
+               message_id mid, message msg, bool flow_controlled = false);
+
+  /**
+   * Removes the oldest message from the queue or returns
+   * `nullptr` if the queue is empty.
+   * @warning Call only from the reader.
+   */
+  outbound_message_ptr try_pop();
+
+  /**
+   * Puts the queue back to sleep after draining it. Returns `false`
+   * if new messages arrived in the meantime, in which case the reader
+   * needs to drain the queue again.
+   * @warning Call only from the reader.
+   */
+  bool try_block();
+
+  /**
+   * Closes the queue and discards all remaining messages. Senders of
+   * discarded requests receive a `sync_exited_msg` with `reason`.
+   * @warning Call only from the reader.
+   */
+  void close(uint32_t reason = exit_reason::remote_link_unreachable);
+
+  /**
+   * Returns whether the queue has been closed.
+   */
+  bool closed();
+
+  /**
+   * Returns whether the calling thread can wait for the reader to make
+   * progress, i.e., returns `false` if called from the reader's thread.
+   */
+  virtual bool may_block() const;
+
+ protected:
+  /**
+   * Called by the writer that enqueued the first message after the
+   * reader put the queue to sleep. Usually schedules the reader.
+   */
+  virtual void wakeup() = 0;
+
+ private:
+  detail::single_reader_queue<outbound_message, detail::disposer> m_queue;
+};
+
+/**
+ * @relates outbound_queue
+ */
+using outbound_queue_ptr = intrusive_ptr<outbound_queue>;
+
+} // namespace caf
+
+#endif // CAF_OUTBOUND_QUEUE_HPP
@@ -31,6 +31,8 @@
 #include "caf/message_id.hpp"
 #include "caf/exit_reason.hpp"
 #include "caf/mailbox_element.hpp"
+#include "caf/message_latency.hpp"
+#include "caf/trace_context.hpp"
 #include "caf/system_messages.hpp"
 #include "caf/message_handler.hpp"
 #include "caf/response_promise.hpp"
@@ -90,9 +92,25 @@ class invoke_policy {
       return false;
     }
     CAF_LOG_TRACE("");
+    auto enqueued = node_ptr->enqueued;
+    auto started = enqueued != 0 ? detail::latency_clock() : 0;
+    // messages sent by the handler belong to the trace of this message
+    auto prev_trace = detail::t_current_trace;
+    detail::t_current_trace = node_ptr->trace;
+    if (node_ptr->trace.trace_id == 0 && detail::sample_trace()) {
+      detail::t_current_trace = detail::make_trace();
+    }
+    auto trace_guard = detail::make_scope_guard([&] {
+      detail::t_current_trace = prev_trace;
+    });
     switch (handle_message(self, node_ptr.get(), fun, awaited_response)) {
       case hm_msg_handled:
         node_ptr.reset();
+        self->message_processed();
+        if (enqueued != 0) {
+          detail::record_message_latency(typeid(*self), enqueued, started,
+                                         detail::latency_clock());
+        }
         return true;
       case hm_cache_msg:
       case hm_skip_msg:
@@ -100,6 +118,7 @@ class invoke_policy {
         return false;
       default: // drop message
         node_ptr.reset();
+        self->message_processed();
         return false;
     }
   }
@@ -125,7 +144,11 @@ class invoke_policy {
                                Fun& fun,
                                MaybeResponseHdl hdl = MaybeResponseHdl{}) {
 #   ifdef CAF_LOG_LEVEL
-      auto msg_str = to_string(msg);
+      // the handler might change msg, hence we render it beforehand
+      std::string msg_str;
+      if (CAF_LOG_ENABLED(CAF_DEBUG)) {
+        msg_str = to_string(msg);
+      }
 #   endif
     CAF_LOG_TRACE(CAF_MARG(mid, integer_value) << ", msg = " << msg_str);
     auto res = fun(msg); // might change mid
@@ -0,0 +1,104 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_RUNTIME_INSPECTOR_HPP
+#define CAF_RUNTIME_INSPECTOR_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "caf/atom.hpp"
+#include "caf/actor.hpp"
+
+namespace caf {
+
+/**
+ * Selects the live actors in a query to the runtime inspector.
+ */
+using actors_atom = atom_constant<atom("ACTORS")>;
+
+/**
+ * Selects the scheduler workers in a query to the runtime inspector.
+ */
+using workers_atom = atom_constant<atom("WORKERS")>;
+
+/**
+ * Selects the memory caches in a query to the runtime inspector.
+ */
+using memory_atom = atom_constant<atom("MEMORY")>;
+
+/**
+ * Subscribes to periodic snapshots of the runtime inspector.
+ */
+using subscribe_atom = atom_constant<atom("SUBSCRIBE")>;
+
+/**
+ * Tags a snapshot of the runtime inspector.
+ */
+using snapshot_atom = atom_constant<atom("SNAPSHOT")>;
+
+/**
+ * Enables or disables collecting runtime statistics (disabled by default).
+ * While enabled, the actor registry keeps track of all actors spawned
+ * without the `hidden` flag, actors count their enqueued and processed
+ * messages, and scheduler workers measure the time spent running actors.
+ */
+void inspect_runtime(bool enable);
+
+/**
+ * Queries whether runtime statistics are collected.
+ */
+bool inspect_runtime();
+
+/**
+ * Enables runtime statistics and returns a hidden actor answering the
+ * following requests with the requested atom and a message containing
+ * one message per row:
+ * - `(get_atom, actors_atom)`: one row per live actor consisting of
+ *   `(actor_id, std::string name, uint64_t mailbox_size,
+ *   uint64_t processed, double messages_per_second)`
+ * - `(get_atom, workers_atom)`: one row per scheduler worker consisting of
+ *   `(uint64_t worker, uint64_t resumed, uint64_t busy_ns, double load)`
+ * - `(get_atom, memory_atom)`: one row per type of `detail::memory`
+ *   consisting of `(std::string type, int64_t in_use, uint64_t cached)`
+ *
+ * The actors table contains all actors spawned while runtime statistics
+ * are enabled. Mailbox sizes include messages skipped by the current
+ * behavior. Rates and loads refer to the time since the previous query of
+ * the same table, whereas a load of 1 means that a worker was busy all
+ * the time. The memory table lists the instances of each type in use and
+ * the free instances held by per-thread caches.
+ *
+ * `(get_atom)` returns `(snapshot_atom, actors, workers, memory)`, i.e.,
+ * all three tables. The sender of `(subscribe_atom, uint32_t ms)` receives
+ * such a snapshot every `ms` milliseconds until it terminates or
+ * subscribes with an interval of 0.
+ */
+actor spawn_runtime_inspector();
+
+namespace detail {
+
+// enables counters for runtime inspection
+extern std::atomic<bool> s_inspect_runtime;
+
+} // namespace detail
+
+} // namespace caf
+
+#endif // CAF_RUNTIME_INSPECTOR_HPP
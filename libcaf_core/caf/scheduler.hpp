@@ -23,6 +23,7 @@
 #include "caf/set_scheduler.hpp"
 #include "caf/scheduler/worker.hpp"
 #include "caf/scheduler/coordinator.hpp"
+#include "caf/scheduler/test_coordinator.hpp"
 #include "caf/scheduler/abstract_coordinator.hpp"
 
 #endif // CAF_SCHEDULER_HPP
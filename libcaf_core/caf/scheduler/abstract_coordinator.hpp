@@ -22,7 +22,9 @@
 
 #include <chrono>
 #include <atomic>
+#include <vector>
 #include <cstddef>
+#include <cstdint>
 
 #include "caf/fwd.hpp"
 #include "caf/atom.hpp"
@@ -35,6 +37,20 @@
 namespace caf {
 namespace scheduler {
 
+/**
+ * Statistics of a worker collected while runtime inspection is enabled.
+ */
+struct worker_load {
+  /**
+   * Number of jobs resumed by the worker.
+   */
+  uint64_t resumed;
+  /**
+   * Nanoseconds the worker spent running jobs.
+   */
+  uint64_t busy_ns;
+};
+
 /**
  * A coordinator creates the workers, manages delayed sends and
  * the central printer instance for {@link aout}. It also forwards
@@ -64,16 +80,19 @@ class abstract_coordinator {
   template <class Duration, class... Data>
   void delayed_send(Duration rel_time, actor_addr from, channel to,
                     message_id mid, message data) {
-    m_timer->enqueue(invalid_actor_addr, invalid_message_id,
-                     make_message(duration{rel_time}, std::move(from),
-                                  std::move(to), mid, std::move(data)),
-                     nullptr);
+    delayed_send_impl(duration{rel_time}, std::move(from), std::move(to), mid,
+                      std::move(data));
   }
 
   inline size_t num_workers() const {
     return m_num_workers;
   }
 
+  /**
+   * Returns the statistics of all workers, ordered by worker ID.
+   */
+  virtual std::vector<worker_load> worker_loads() const;
+
  protected:
   abstract_coordinator();
 
@@ -83,6 +102,13 @@ class abstract_coordinator {
 
   void stop_actors();
 
+  /**
+   * Delivers `data` to `to` after `rel_time`, using the timer actor
+   * by default.
+   */
+  virtual void delayed_send_impl(const duration& rel_time, actor_addr from,
+                                 channel to, message_id mid, message data);
+
   // Creates a default instance.
   static abstract_coordinator* create_singleton();
 
@@ -58,6 +58,14 @@ class coordinator : public abstract_coordinator {
     return m_data;
   }
 
+  std::vector<worker_load> worker_loads() const override {
+    std::vector<worker_load> result;
+    for (auto& w : m_workers) {
+      result.push_back(w->load());
+    }
+    return result;
+  }
+
  protected:
   void initialize() override {
     super::initialize();
@@ -0,0 +1,154 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_SCHEDULER_TEST_COORDINATOR_HPP
+#define CAF_SCHEDULER_TEST_COORDINATOR_HPP
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <limits>
+#include <cstddef>
+
+#include "caf/channel.hpp"
+#include "caf/message.hpp"
+#include "caf/duration.hpp"
+#include "caf/actor_addr.hpp"
+#include "caf/message_id.hpp"
+#include "caf/execution_unit.hpp"
+
+#include "caf/scheduler/abstract_coordinator.hpp"
+
+namespace caf {
+namespace scheduler {
+
+/**
+ * A coordinator without worker threads that resumes actors only when
+ * told to and on the calling thread. Jobs run in FIFO order unless
+ * picked explicitly via `run_job`. Delayed messages, including
+ * timeouts, use a virtual clock that only advances via `advance_time`
+ * and `trigger_timeout`. Hence, any interleaving of messages can be
+ * replayed deterministically.
+ * @note Detached and blocking actors, including `scoped_actor`, still
+ *       run in their own threads. Waiting for an actor in the test
+ *       coordinator blocks forever unless another thread calls `run`.
+ */
+class test_coordinator : public abstract_coordinator, public execution_unit {
+ public:
+  using super = abstract_coordinator;
+
+  /**
+   * A point in virtual time, starting at the epoch of the clock.
+   */
+  using time_point = std::chrono::steady_clock::time_point;
+
+  /**
+   * Allows each actor to consume up to `max_throughput` messages
+   * per resume (must be > 0).
+   */
+  explicit test_coordinator(size_t max_throughput
+                            = std::numeric_limits<size_t>::max());
+
+  void enqueue(resumable* what) override;
+
+  void exec_later(resumable* what) override;
+
+  /**
+   * Returns the number of jobs waiting to be resumed.
+   */
+  size_t num_jobs() const;
+
+  /**
+   * Resumes the job at `position` in the queue of waiting jobs and
+   * returns `false` if no such job exists.
+   */
+  bool run_job(size_t position);
+
+  /**
+   * Resumes the first waiting job and returns `false` if there was none.
+   */
+  inline bool run_once() {
+    return run_job(0);
+  }
+
+  /**
+   * Resumes waiting jobs until none is left or `max_jobs` jobs ran and
+   * returns the number of resumed jobs.
+   */
+  size_t run(size_t max_jobs = std::numeric_limits<size_t>::max());
+
+  /**
+   * Returns the current virtual time.
+   */
+  time_point now() const;
+
+  /**
+   * Returns the number of delayed messages not yet delivered.
+   */
+  size_t num_delayed() const;
+
+  /**
+   * Advances the virtual time by `rel_time`, delivers all messages
+   * due until then and returns their number.
+   */
+  size_t advance_time(std::chrono::nanoseconds rel_time);
+
+  /**
+   * Sets the virtual time to the timestamp of the next delayed message,
+   * delivers it and returns `false` if there was none.
+   */
+  bool trigger_timeout();
+
+ protected:
+  void stop() override;
+
+  void delayed_send_impl(const duration& rel_time, actor_addr from,
+                         channel to, message_id mid, message data) override;
+
+ private:
+  struct delayed_msg {
+    actor_addr from;
+    channel to;
+    message_id mid;
+    message msg;
+  };
+
+  using delayed_map = std::multimap<time_point, delayed_msg>;
+
+  // removes the first delayed message if it is due at `tp`
+  bool pop_delayed(time_point tp, delayed_msg& result);
+
+  // protects all members below
+  mutable std::mutex m_mtx;
+  // jobs waiting to be resumed in FIFO order
+  std::deque<resumable*> m_jobs;
+  // delayed messages ordered by due time and order of arrival
+  delayed_map m_delayed;
+  // the virtual time
+  time_point m_now;
+  // number of messages each actor is allowed to consume per resume
+  size_t m_max_throughput;
+};
+
+} // namespace scheduler
+} // namespace caf
+
+#endif // CAF_SCHEDULER_TEST_COORDINATOR_HPP
@@ -20,9 +20,15 @@
 #ifndef CAF_SCHEDULER_WORKER_HPP
 #define CAF_SCHEDULER_WORKER_HPP
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 
 #include "caf/execution_unit.hpp"
+#include "caf/message_latency.hpp"
+#include "caf/runtime_inspector.hpp"
+
+#include "caf/scheduler/abstract_coordinator.hpp"
 
 #include "caf/detail/logging.hpp"
 #include "caf/detail/double_ended_queue.hpp"
@@ -46,7 +52,9 @@ class worker : public execution_unit {
   worker(size_t worker_id, coordinator_ptr worker_parent, size_t throughput)
       : m_max_throughput(throughput),
         m_id(worker_id),
-        m_parent(worker_parent) {
+        m_parent(worker_parent),
+        m_resumed(0),
+        m_busy_ns(0) {
     // nop
   }
 
@@ -117,6 +125,15 @@ class worker : public execution_unit {
     return m_max_throughput;
   }
 
+  /**
+   * Returns the number of jobs resumed and the nanoseconds spent
+   * running them while collecting runtime statistics.
+   */
+  worker_load load() const {
+    return {m_resumed.load(std::memory_order_relaxed),
+            m_busy_ns.load(std::memory_order_relaxed)};
+  }
+
  private:
   void run() {
     CAF_LOG_TRACE("worker with ID " << m_id);
@@ -126,7 +143,18 @@ class worker : public execution_unit {
       CAF_REQUIRE(job != nullptr);
       CAF_LOG_DEBUG("resume actor " << id_of(job));
       CAF_PUSH_AID_FROM_PTR(dynamic_cast<abstract_actor*>(job));
-      switch (job->resume(this, m_max_throughput)) {
+      auto started = detail::s_inspect_runtime.load(std::memory_order_relaxed)
+                     ? detail::latency_clock()
+                     : 0;
+      auto res = job->resume(this, m_max_throughput);
+      if (started != 0) {
+        // only this thread writes the counters
+        auto relaxed = std::memory_order_relaxed;
+        m_resumed.store(m_resumed.load(relaxed) + 1, relaxed);
+        m_busy_ns.store(m_busy_ns.load(relaxed) + detail::latency_clock()
+                        - started, relaxed);
+      }
+      switch (res) {
         case resumable::resume_later: {
           m_policy.resume_job_later(this, job);
           break;
@@ -159,6 +187,9 @@ class worker : public execution_unit {
   policy_data m_data;
   // instance of our policy object
   Policy m_policy;
+  // statistics for runtime inspection
+  std::atomic<uint64_t> m_resumed;
+  std::atomic<uint64_t> m_busy_ns;
 };
 
 } // namespace scheduler
@@ -0,0 +1,137 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_TRACE_CONTEXT_HPP
+#define CAF_TRACE_CONTEXT_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace caf {
+
+/**
+ * Identifies a message within a distributed trace. Messages inherit
+ * the context of the handler that sends them, while each transmission
+ * to another node starts a new span that refers to the span of the
+ * sender. Only sampled contexts are sent to other nodes.
+ */
+struct trace_context {
+  /**
+   * Identifies the trace, i.e., all messages caused by its first message.
+   */
+  uint64_t trace_id;
+  /**
+   * Identifies a hop of the trace.
+   */
+  uint64_t span_id;
+  /**
+   * Identifies the hop that caused this hop, 0 for the first hop.
+   */
+  uint64_t parent_id;
+  /**
+   * Denotes whether hooks record this trace.
+   */
+  bool sampled;
+
+  /**
+   * Returns the context of the calling thread, e.g., the context
+   * of the message an actor currently handles.
+   */
+  static const trace_context& current();
+
+  /**
+   * Returns a child of this context with a new span ID.
+   */
+  trace_context child() const;
+};
+
+/**
+ * @relates trace_context
+ */
+inline bool operator==(const trace_context& lhs, const trace_context& rhs) {
+  return lhs.trace_id == rhs.trace_id && lhs.span_id == rhs.span_id
+         && lhs.parent_id == rhs.parent_id && lhs.sampled == rhs.sampled;
+}
+
+/**
+ * @relates trace_context
+ */
+inline bool operator!=(const trace_context& lhs, const trace_context& rhs) {
+  return !(lhs == rhs);
+}
+
+/**
+ * Starts a new trace for each `n`th message an actor handles
+ * without belonging to a trace already (0, i.e., never, by default).
+ */
+void trace_sampling(uint32_t n);
+
+/**
+ * Queries how often handling a message starts a new trace.
+ */
+uint32_t trace_sampling();
+
+/**
+ * Sets the trace context of the calling thread for the lifetime of
+ * this object. All messages sent by this thread in the meantime belong
+ * to the trace. The default constructor starts a new sampled trace.
+ */
+class scoped_trace {
+
+ public:
+
+  scoped_trace();
+
+  scoped_trace(const trace_context& ctx);
+
+  scoped_trace(const scoped_trace&) = delete;
+
+  scoped_trace& operator=(const scoped_trace&) = delete;
+
+  ~scoped_trace();
+
+  inline const trace_context& context() const {
+    return trace_context::current();
+  }
+
+ private:
+
+  trace_context m_prev;
+
+};
+
+namespace detail {
+
+// context of the calling thread, copied into new mailbox elements
+extern thread_local trace_context t_current_trace;
+
+// number of messages per new trace, 0 disables sampling
+extern std::atomic<uint32_t> s_trace_sampling;
+
+// returns a new sampled context
+trace_context make_trace();
+
+// returns true for every `s_trace_sampling`th call per thread
+bool sample_trace();
+
+} // namespace detail
+
+} // namespace caf
+
+#endif // CAF_TRACE_CONTEXT_HPP
@@ -212,6 +212,19 @@ void abstract_coordinator::initialize() {
   m_printer = spawn<hidden + detached + blocking_api>(printer_loop);
 }
 
+std::vector<worker_load> abstract_coordinator::worker_loads() const {
+  return {};
+}
+
+void abstract_coordinator::delayed_send_impl(const duration& rel_time,
+                                             actor_addr from, channel to,
+                                             message_id mid, message data) {
+  m_timer->enqueue(invalid_actor_addr, invalid_message_id,
+                   make_message(rel_time, std::move(from), std::move(to), mid,
+                                std::move(data)),
+                   nullptr);
+}
+
 void abstract_coordinator::stop_actors() {
   CAF_LOG_TRACE("");
   scoped_actor self(true);
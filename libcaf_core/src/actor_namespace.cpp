@@ -36,7 +36,15 @@ actor_namespace::backend::~backend() {
   // nop
 }
 
-actor_namespace::actor_namespace(backend& be) : m_backend(be) {
+actor_namespace::actor_namespace(backend& be)
+    : m_backend(be),
+      m_proxies(std::make_shared<proxies>()) {
+  // nop
+}
+
+actor_namespace::actor_namespace(backend& be, actor_namespace& other)
+    : m_backend(be),
+      m_proxies(other.m_proxies) {
   // nop
 }
 
@@ -83,13 +91,16 @@ actor_addr actor_namespace::read(deserializer* source) {
 }
 
 size_t actor_namespace::count_proxies(const key_type& node) {
-  auto i = m_proxies.find(node);
-  return (i != m_proxies.end()) ? i->second.size() : 0;
+  std::lock_guard<std::mutex> guard{m_proxies->mtx};
+  auto& nodes = m_proxies->nodes;
+  auto i = nodes.find(node);
+  return (i != nodes.end()) ? i->second.size() : 0;
 }
 
 std::vector<actor_proxy_ptr> actor_namespace::get_all(const key_type& node) {
   std::vector<actor_proxy_ptr> result;
-  auto& submap = m_proxies[node];
+  std::lock_guard<std::mutex> guard{m_proxies->mtx};
+  auto& submap = m_proxies->nodes[node];
   for (auto& kvp : submap) {
     auto ptr = kvp.second->get();
     if (ptr) {
@@ -100,7 +111,8 @@ std::vector<actor_proxy_ptr> actor_namespace::get_all(const key_type& node) {
 }
 
 actor_proxy_ptr actor_namespace::get(const key_type& node, actor_id aid) {
-  auto& submap = m_proxies[node];
+  std::lock_guard<std::mutex> guard{m_proxies->mtx};
+  auto& submap = m_proxies->nodes[node];
   auto i = submap.find(aid);
   if (i != submap.end()) {
     auto res = i->second->get();
@@ -114,7 +126,10 @@ actor_proxy_ptr actor_namespace::get(const key_type& node, actor_id aid) {
 
 actor_proxy_ptr actor_namespace::get_or_put(const key_type& node,
                                             actor_id aid) {
-  auto& submap = m_proxies[node];
+  // holding the lock while creating a proxy makes sure
+  // no two threads create a proxy for the same actor
+  std::lock_guard<std::mutex> guard{m_proxies->mtx};
+  auto& submap = m_proxies->nodes[node];
   auto& anchor = submap[aid];
   actor_proxy_ptr result;
   if (anchor) {
@@ -130,21 +145,25 @@ actor_proxy_ptr actor_namespace::get_or_put(const key_type& node,
 }
 
 bool actor_namespace::empty() const {
-  return m_proxies.empty();
+  std::lock_guard<std::mutex> guard{m_proxies->mtx};
+  return m_proxies->nodes.empty();
 }
 
 void actor_namespace::erase(const key_type& inf) {
   CAF_LOG_TRACE(CAF_TARG(inf, to_string));
-  m_proxies.erase(inf);
+  std::lock_guard<std::mutex> guard{m_proxies->mtx};
+  m_proxies->nodes.erase(inf);
 }
 
 void actor_namespace::erase(const key_type& inf, actor_id aid) {
   CAF_LOG_TRACE(CAF_TARG(inf, to_string) << ", " << CAF_ARG(aid));
-  auto i = m_proxies.find(inf);
-  if (i != m_proxies.end()) {
+  std::lock_guard<std::mutex> guard{m_proxies->mtx};
+  auto& nodes = m_proxies->nodes;
+  auto i = nodes.find(inf);
+  if (i != nodes.end()) {
     i->second.erase(aid);
     if (i->second.empty()) {
-      m_proxies.erase(i);
+      nodes.erase(i);
     }
   }
 }
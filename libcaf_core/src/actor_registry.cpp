@@ -43,7 +43,7 @@ actor_registry::~actor_registry() {
   // nop
 }
 
-actor_registry::actor_registry() : m_running(0), m_ids(1) {
+actor_registry::actor_registry() : m_running(0), m_ids(1), m_live_count(0) {
   // nop
 }
 
@@ -91,11 +91,9 @@ uint32_t actor_registry::next_id() {
 }
 
 void actor_registry::inc_running() {
-# if defined(CAF_LOG_LEVEL) && CAF_LOG_LEVEL >= CAF_DEBUG
-    CAF_LOG_DEBUG("new value = " << ++m_running);
-# else
-    ++m_running;
-# endif
+  size_t new_val = ++m_running;
+  CAF_LOG_DEBUG(CAF_ARG(new_val));
+  static_cast<void>(new_val); // keep compiler happy when not logging
 }
 
 size_t actor_registry::running() const {
@@ -121,5 +119,48 @@ void actor_registry::await_running_count_equal(size_t expected) {
   }
 }
 
+void actor_registry::add_live(const abstract_actor_ptr& value) {
+  exclusive_guard guard(m_live_mtx);
+  if (m_live.emplace(value->id(), value).second) {
+    ++m_live_count;
+  }
+}
+
+void actor_registry::remove_live(actor_id key) {
+  if (m_live_count == 0) {
+    return;
+  }
+  abstract_actor_ptr value;
+  { // lifetime scope of guard, releases the actor without holding the lock
+    exclusive_guard guard(m_live_mtx);
+    auto i = m_live.find(key);
+    if (i == m_live.end()) {
+      return;
+    }
+    value.swap(i->second);
+    m_live.erase(i);
+    --m_live_count;
+  }
+}
+
+void actor_registry::clear_live() {
+  std::map<actor_id, abstract_actor_ptr> tmp;
+  { // lifetime scope of guard
+    exclusive_guard guard(m_live_mtx);
+    tmp.swap(m_live);
+    m_live_count = 0;
+  }
+}
+
+std::vector<abstract_actor_ptr> actor_registry::live() const {
+  std::vector<abstract_actor_ptr> result;
+  shared_guard guard(m_live_mtx);
+  result.reserve(m_live.size());
+  for (auto& kvp : m_live) {
+    result.push_back(kvp.second);
+  }
+  return result;
+}
+
 } // namespace detail
 } // namespace caf
@@ -20,19 +20,29 @@
 #include "caf/forwarding_actor_proxy.hpp"
 
 #include "caf/send.hpp"
+#include "caf/atom.hpp"
 #include "caf/locks.hpp"
 #include "caf/to_string.hpp"
+#include "caf/exit_reason.hpp"
 
 #include "caf/detail/logging.hpp"
+#include "caf/detail/sync_request_bouncer.hpp"
 
 using namespace std;
 
 namespace caf {
 
 forwarding_actor_proxy::forwarding_actor_proxy(actor_id aid, node_id nid,
-                                               actor mgr)
+                                               actor mgr,
+                                               outbound_queue_ptr queue,
+                                               size_t high_water_mark,
+                                               backpressure_policy policy)
     : actor_proxy(aid, nid),
-      m_manager(mgr) {
+      m_manager(mgr),
+      m_queue(std::move(queue)),
+      m_high_water_mark(m_queue ? high_water_mark : 0),
+      m_policy(policy),
+      m_in_flight(0) {
   CAF_REQUIRE(mgr != invalid_actor);
   CAF_LOG_INFO(CAF_ARG(aid) << ", " << CAF_TARG(nid, to_string));
 }
@@ -60,6 +70,26 @@ void forwarding_actor_proxy::forward_msg(const actor_addr& sender,
   CAF_LOG_TRACE(CAF_ARG(id()) << ", " << CAF_TSARG(sender) << ", "
                               << CAF_MARG(mid, integer_value) << ", "
                               << CAF_TSARG(msg));
+  if (m_queue) {
+    auto flow_controlled = m_high_water_mark > 0;
+    if (flow_controlled) {
+      ++m_in_flight;
+    }
+    if (m_queue->enqueue(sender, address(), mid, msg, flow_controlled)) {
+      return;
+    }
+    // the broker closed the queue after losing the remote node
+    // or while shutting down, i.e., this message never leaves
+    CAF_LOG_DEBUG("outbound queue closed");
+    if (flow_controlled) {
+      grant(1);
+    }
+    if (mid.is_request()) {
+      detail::sync_request_bouncer f{exit_reason::remote_link_unreachable};
+      f(sender, mid);
+      return;
+    }
+  }
   shared_lock<detail::shared_spinlock> m_guard(m_manager_mtx);
   m_manager->enqueue(invalid_actor_addr, invalid_message_id,
                      make_message(atom("_Dispatch"), sender,
@@ -67,8 +97,67 @@ void forwarding_actor_proxy::forward_msg(const actor_addr& sender,
                      nullptr);
 }
 
+bool forwarding_actor_proxy::backpressure() const {
+  return m_high_water_mark > 0 && m_in_flight >= m_high_water_mark;
+}
+
+void forwarding_actor_proxy::grant(size_t num) {
+  auto prev = m_in_flight.load();
+  size_t next;
+  do {
+    // credit for messages that were not counted is ignored
+    next = prev > num ? prev - num : 0;
+  } while (!m_in_flight.compare_exchange_weak(prev, next));
+  if (m_policy == backpressure_policy::suspend && prev >= m_high_water_mark
+      && next < m_high_water_mark) {
+    std::lock_guard<std::mutex> guard{m_credit_mtx};
+    m_credit_cv.notify_all();
+  }
+}
+
+bool forwarding_actor_proxy::admit(const actor_addr& sender, message_id mid,
+                                   execution_unit* host) {
+  if (m_in_flight < m_high_water_mark || mid.is_response()) {
+    return true;
+  }
+  CAF_LOG_DEBUG("backpressure: " << m_in_flight << " messages in flight to "
+                << to_string(address()));
+  switch (m_policy) {
+    case backpressure_policy::drop:
+      if (!mid.is_request()) {
+        return false;
+      }
+      break;
+    case backpressure_policy::error_reply:
+      break;
+    case backpressure_policy::suspend:
+      // blocking a worker of the scheduler or the thread of our manager
+      // could stall the very actors that return credit to us, hence
+      // such senders receive an error instead
+      if (host == nullptr && m_queue->may_block()) {
+        std::unique_lock<std::mutex> guard{m_credit_mtx};
+        m_credit_cv.wait(guard, [&] {
+          return m_in_flight < m_high_water_mark
+                 || exit_reason() != caf::exit_reason::not_exited;
+        });
+        return true;
+      }
+      break;
+  }
+  if (sender) {
+    auto ptr = actor_cast<abstract_actor_ptr>(sender);
+    ptr->enqueue(address(), mid.is_request() ? mid.response_id()
+                                             : invalid_message_id,
+                 make_message(error_atom::value, "backpressure"), nullptr);
+  }
+  return false;
+}
+
 void forwarding_actor_proxy::enqueue(const actor_addr& sender, message_id mid,
-                                     message m, execution_unit*) {
+                                     message m, execution_unit* host) {
+  if (m_high_water_mark > 0 && !admit(sender, mid, host)) {
+    return;
+  }
   forward_msg(sender, mid, std::move(m));
 }
 
@@ -122,6 +211,9 @@ void forwarding_actor_proxy::local_unlink_from(const actor_addr& other) {
 
 void forwarding_actor_proxy::kill_proxy(uint32_t reason) {
   cleanup(reason);
+  // wake up suspended senders
+  std::lock_guard<std::mutex> guard{m_credit_mtx};
+  m_credit_cv.notify_all();
 }
 
 } // namespace caf
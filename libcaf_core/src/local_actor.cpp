@@ -35,7 +35,9 @@ local_actor::local_actor()
     : super(size_t{1}),
       m_dummy_node(),
       m_current_node(&m_dummy_node),
-      m_planned_exit_reason(exit_reason::not_exited) {
+      m_planned_exit_reason(exit_reason::not_exited),
+      m_enqueued_messages(0),
+      m_processed_messages(0) {
   // nop
 }
 
@@ -167,7 +169,7 @@ void local_actor::cleanup(uint32_t reason) {
 
 void local_actor::quit(uint32_t reason) {
   CAF_LOG_TRACE("reason = " << reason << ", class = "
-                            << class_name());
+                            << typeid(*this).name());
   planned_exit_reason(reason);
   if (is_blocking()) {
     throw actor_exited(reason);
@@ -215,10 +217,15 @@ void local_actor::is_registered(bool value) {
   if (is_registered() == value) {
     return;
   }
+  auto reg = detail::singletons::get_actor_registry();
   if (value) {
-    detail::singletons::get_actor_registry()->inc_running();
+    reg->inc_running();
+    if (detail::s_inspect_runtime) {
+      reg->add_live(this);
+    }
   } else {
-    detail::singletons::get_actor_registry()->dec_running();
+    reg->remove_live(id());
+    reg->dec_running();
   }
   set_flag(value, is_registered_flag);
 }
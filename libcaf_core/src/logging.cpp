@@ -17,13 +17,17 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#include <map>
 #include <ctime>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <thread>
 #include <cstring>
 #include <fstream>
 #include <algorithm>
-#include <pthread.h>
-#include <condition_variable>
+#include <unordered_map>
 
 #ifndef CAF_WINDOWS
 #include <unistd.h>
@@ -33,10 +37,12 @@
 #include "caf/string_algorithms.hpp"
 
 #include "caf/all.hpp"
+#include "caf/locks.hpp"
 #include "caf/actor_proxy.hpp"
 
 #include "caf/detail/logging.hpp"
-#include "caf/detail/single_reader_queue.hpp"
+#include "caf/detail/demangle.hpp"
+#include "caf/detail/shared_spinlock.hpp"
 
 namespace caf {
 namespace detail {
@@ -45,37 +51,198 @@ namespace {
 
 __thread actor_id t_self_id;
 
-constexpr struct pop_aid_log_event_t {
-  constexpr pop_aid_log_event_t() {
-    // nop
-  }
-} pop_aid_log_event;
-
-struct log_event {
-  log_event* next;
-  std::string msg;
-};
-
 #ifndef CAF_LOG_LEVEL
   constexpr int global_log_level = 0;
 #else
   constexpr int global_log_level = CAF_LOG_LEVEL;
 #endif
 
+// level of all classes without a component level
+std::atomic<int> s_level{global_log_level};
+
+// guards s_components and s_class_levels
+shared_spinlock s_levels_mtx;
+
+// maps normalized component names to their level
+std::map<std::string, int> s_components;
+
+// allows `logging::accepts` to skip the lookup if s_components is empty
+std::atomic<bool> s_has_components{false};
+
+// caches the level of each class name passed to `logging::accepts`
+std::unordered_map<const char*, int> s_class_levels;
+
+// converts `str` to a demangled name using '.' as separator
+std::string normalized_name(const char* str) {
+  auto result = demangle(str);
+  replace_all(result, "::", ".");
+  return result;
+}
+
+// returns the level of `class_name`, requires exclusive access to s_levels_mtx
+int class_level(const char* class_name) {
+  auto name = normalized_name(class_name);
+  auto result = s_level.load();
+  size_t best_match = 0;
+  for (auto& kvp : s_components) {
+    auto& component = kvp.first;
+    if (component.size() > best_match
+        && name.compare(0, component.size(), component) == 0
+        && (name.size() == component.size()
+            || name[component.size()] == '.'
+            || name[component.size()] == '<')) {
+      best_match = component.size();
+      result = kvp.second;
+    }
+  }
+  return result;
+}
+
+// requires exclusive access to s_levels_mtx
+void update_max_level(std::atomic<int>& max_level) {
+  auto result = s_level.load();
+  for (auto& kvp : s_components) {
+    result = std::max(result, kvp.second);
+  }
+  s_class_levels.clear();
+  max_level = std::min(result, global_log_level);
+}
+
+// size of the ring buffer of each thread
+constexpr size_t ring_size = 64 * 1024;
+
+// maximum time the logger thread sleeps if all buffers are empty
+constexpr int max_idle_ms = 16;
+
+// fixed-size prefix of each record
+struct record_header {
+  uint32_t size;
+  actor_id aid;
+  const log_site* site;
+  const char* class_name;
+  int64_t timestamp;
+};
+
+/*
+ * A single-producer, single-consumer ring buffer of records. The
+ * producer is the thread owning the buffer, the consumer is the
+ * thread of the logger. Positions grow monotonically and wrap only
+ * when indexing into the data.
+ */
+class log_ring {
+ public:
+  log_ring(size_t generation)
+      : m_generation(generation),
+        m_head(0),
+        m_tail(0),
+        m_closed(false),
+        m_data(ring_size) {
+    std::ostringstream oss;
+    oss << std::this_thread::get_id();
+    m_thread_id = oss.str();
+  }
+
+  size_t generation() const {
+    return m_generation;
+  }
+
+  const std::string& thread_id() const {
+    return m_thread_id;
+  }
+
+  // called by the producer, returns false if the ring is full
+  bool push(const char* buf, size_t size) {
+    auto head = m_head.load(std::memory_order_relaxed);
+    auto tail = m_tail.load(std::memory_order_acquire);
+    if (m_data.size() - (head - tail) < size) {
+      return false;
+    }
+    copy_in(head, buf, size);
+    m_head.store(head + size, std::memory_order_release);
+    return true;
+  }
+
+  // called by the consumer, appends all available records to `buf`
+  bool pop_all(std::vector<char>& buf) {
+    auto tail = m_tail.load(std::memory_order_relaxed);
+    auto head = m_head.load(std::memory_order_acquire);
+    if (head == tail) {
+      return false;
+    }
+    auto offset = buf.size();
+    buf.resize(offset + (head - tail));
+    copy_out(tail, buf.data() + offset, head - tail);
+    m_tail.store(head, std::memory_order_release);
+    return true;
+  }
+
+  // called by the producer when its thread exits
+  void close() {
+    m_closed.store(true, std::memory_order_release);
+  }
+
+  bool closed() const {
+    return m_closed.load(std::memory_order_acquire);
+  }
+
+ private:
+  void copy_in(uint64_t pos, const char* buf, size_t size) {
+    auto i = pos % m_data.size();
+    auto n = std::min(size, m_data.size() - i);
+    memcpy(m_data.data() + i, buf, n);
+    memcpy(m_data.data(), buf + n, size - n);
+  }
+
+  void copy_out(uint64_t pos, char* buf, size_t size) const {
+    auto i = pos % m_data.size();
+    auto n = std::min(size, m_data.size() - i);
+    memcpy(buf, m_data.data() + i, n);
+    memcpy(buf + n, m_data.data(), size - n);
+  }
+
+  size_t m_generation;
+  std::string m_thread_id;
+  std::atomic<uint64_t> m_head;
+  std::atomic<uint64_t> m_tail;
+  std::atomic<bool> m_closed;
+  std::vector<char> m_data;
+};
+
+using log_ring_ptr = std::shared_ptr<log_ring>;
+
+// closes the ring of a thread as the thread exits
+struct log_ring_holder {
+  log_ring_ptr ptr;
+  ~log_ring_holder() {
+    if (ptr) {
+      ptr->close();
+    }
+  }
+};
+
+thread_local log_ring_holder t_ring;
+
+std::atomic<size_t> s_generation{0};
+
 class logging_impl : public logging {
  public:
+  logging_impl() : m_generation(++s_generation), m_running(false) {
+    // nop
+  }
+
   void initialize() {
     const char* log_level_table[] = {"ERROR", "WARN", "INFO", "DEBUG", "TRACE"};
+    static const log_site site{"TRACE", "run", __FILE__, __LINE__};
+    m_running = true;
     m_thread = std::thread([this] { (*this)(); });
-    std::string msg = "ENTRY log level = ";
-    msg += log_level_table[global_log_level];
-    log("TRACE", "logging", "run", __FILE__, __LINE__, msg);
+    log_record{site, "logging", this} << "ENTRY log level = "
+                                      << log_level_table[global_log_level];
   }
 
   void stop() {
-    log("TRACE", "logging", "run", __FILE__, __LINE__, "EXIT");
-    // an empty string means: shut down
-    m_queue.synchronized_enqueue(m_queue_mtx, m_queue_cv, new log_event{0, ""});
+    static const log_site site{"TRACE", "run", __FILE__, __LINE__};
+    log_record{site, "logging", this} << "EXIT";
+    m_running = false;
     m_thread.join();
   }
 
@@ -83,72 +250,244 @@ class logging_impl : public logging {
     std::ostringstream fname;
     fname << "actor_log_" << getpid() << "_" << time(0) << ".log";
     std::fstream out(fname.str().c_str(), std::ios::out | std::ios::app);
-    std::unique_ptr<log_event> event;
+    auto idle_ms = 1;
     for (;;) {
-      // make sure we have data to read
-      m_queue.synchronized_await(m_queue_mtx, m_queue_cv);
-      // read & process event
-      event.reset(m_queue.try_pop());
-      CAF_REQUIRE(event != nullptr);
-      if (event->msg.empty()) {
+      // read the flag before draining to not miss final records
+      auto running = m_running.load();
+      if (drain(out)) {
+        out << std::flush;
+        idle_ms = 1;
+      } else if (!running) {
         out.close();
         return;
+      } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(idle_ms));
+        idle_ms = std::min(idle_ms * 2, max_idle_ms);
       }
-      out << event->msg << std::flush;
     }
   }
 
-  void log(const char* level, const char* c_class_name,
-           const char* function_name, const char* c_full_file_name,
-           int line_num, const std::string& msg) override {
-    std::string class_name = c_class_name;
-    replace_all(class_name, "::", ".");
-    replace_all(class_name, "(anonymous namespace)", "$anon$");
-    std::string file_name;
-    std::string full_file_name = c_full_file_name;
-    auto ri = find(full_file_name.rbegin(), full_file_name.rend(), '/');
-    if (ri != full_file_name.rend()) {
-      auto i = ri.base();
-      if (i == full_file_name.end()) {
-        file_name = std::move(full_file_name);
-      } else {
-        file_name = std::string(i, full_file_name.end());
+  void append(const char* buf, size_t size) override {
+    if (size > ring_size) {
+      return;
+    }
+    auto& ring = t_ring.ptr;
+    if (!ring || ring->generation() != m_generation) {
+      if (ring) {
+        ring->close();
+      }
+      ring = std::make_shared<log_ring>(m_generation);
+      std::lock_guard<std::mutex> guard{m_rings_mtx};
+      m_rings.push_back(ring);
+    }
+    // wait for the logger thread if the ring is full
+    while (!ring->push(buf, size)) {
+      if (!m_running) {
+        return;
       }
-    } else {
-      file_name = std::move(full_file_name);
+      std::this_thread::yield();
     }
-    std::ostringstream line;
-    line << time(0) << " " << level << " "
-         << "actor" << t_self_id << " " << std::this_thread::get_id() << " "
-         << class_name << " " << function_name << " " << file_name << ":"
-         << line_num << " " << msg << std::endl;
-    m_queue.synchronized_enqueue(m_queue_mtx, m_queue_cv,
-                                 new log_event{nullptr, line.str()});
   }
 
  private:
+  // formats all available records, returns whether any record was read
+  bool drain(std::fstream& out) {
+    std::vector<log_ring_ptr> rings;
+    { // lifetime scope of guard
+      std::lock_guard<std::mutex> guard{m_rings_mtx};
+      rings = m_rings;
+    }
+    auto result = false;
+    for (auto& ring : rings) {
+      // check before popping to read all records of an exited thread
+      auto closed = ring->closed();
+      m_records.clear();
+      if (ring->pop_all(m_records)) {
+        result = true;
+        format(out, ring->thread_id());
+      }
+      if (closed) {
+        std::lock_guard<std::mutex> guard{m_rings_mtx};
+        m_rings.erase(std::find(m_rings.begin(), m_rings.end(), ring));
+      }
+    }
+    return result;
+  }
+
+  template <class T>
+  T read(size_t& pos) {
+    T result;
+    memcpy(&result, m_records.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return result;
+  }
+
+  void format(std::fstream& out, const std::string& thread_id) {
+    size_t pos = 0;
+    while (pos < m_records.size()) {
+      auto first = pos;
+      auto hdr = read<record_header>(pos);
+      auto& site = *hdr.site;
+      out << (hdr.timestamp / 1000000000) << " " << site.level << " "
+          << "actor" << hdr.aid << " " << thread_id << " "
+          << class_name(hdr.class_name) << " " << site.function_name << " "
+          << file_name(site.file_name) << ":" << site.line_num << " ";
+      while (pos < first + hdr.size) {
+        switch (static_cast<log_record::arg_type>(m_records[pos++])) {
+          case log_record::signed_arg:
+            out << read<int64_t>(pos);
+            break;
+          case log_record::unsigned_arg:
+            out << read<uint64_t>(pos);
+            break;
+          case log_record::double_arg:
+            out << read<double>(pos);
+            break;
+          case log_record::bool_arg:
+            out << (read<char>(pos) != 0 ? "true" : "false");
+            break;
+          case log_record::char_arg:
+            out << read<char>(pos);
+            break;
+          case log_record::string_arg: {
+            auto size = read<uint32_t>(pos);
+            out.write(m_records.data() + pos, size);
+            pos += size;
+            break;
+          }
+        }
+      }
+      out << "\n";
+    }
+  }
+
+  const std::string& class_name(const char* str) {
+    auto i = m_class_names.find(str);
+    if (i != m_class_names.end()) {
+      return i->second;
+    }
+    std::string result = str;
+    replace_all(result, "::", ".");
+    replace_all(result, "(anonymous namespace)", "$anon$");
+    return m_class_names.emplace(str, std::move(result)).first->second;
+  }
+
+  static const char* file_name(const char* str) {
+    auto i = strrchr(str, '/');
+    return i ? i + 1 : str;
+  }
+
+  size_t m_generation;
+  std::atomic<bool> m_running;
   std::thread m_thread;
-  std::mutex m_queue_mtx;
-  std::condition_variable m_queue_cv;
-  detail::single_reader_queue<log_event> m_queue;
+  std::mutex m_rings_mtx;
+  std::vector<log_ring_ptr> m_rings;
+  // only accessed by the logger thread
+  std::vector<char> m_records;
+  std::unordered_map<const char*, std::string> m_class_names;
 };
 
 } // namespace <anonymous>
 
-logging::trace_helper::trace_helper(std::string class_name,
-                                    const char* fun_name, const char* file_name,
-                                    int line_num, const std::string& msg)
-    : m_class(std::move(class_name)),
-      m_fun_name(fun_name),
-      m_file_name(file_name),
-      m_line_num(line_num) {
-  singletons::get_logger()->log("TRACE", m_class.c_str(), fun_name, file_name,
-                                line_num, "ENTRY " + msg);
+constexpr size_t log_record::max_size;
+
+log_record::log_record(const log_site& site, const char* class_name,
+                       logging* target)
+    : m_target(target),
+      m_buf(thread_buffer()),
+      m_offset(m_buf.size()) {
+  // records of nested log statements are appended and removed again
+  record_header hdr;
+  hdr.size = 0;
+  hdr.aid = t_self_id;
+  hdr.site = &site;
+  hdr.class_name = class_name;
+  auto now = std::chrono::system_clock::now().time_since_epoch();
+  hdr.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now)
+                  .count();
+  auto first = reinterpret_cast<const char*>(&hdr);
+  m_buf.insert(m_buf.end(), first, first + sizeof(record_header));
+}
+
+log_record::~log_record() {
+  auto size = static_cast<uint32_t>(m_buf.size() - m_offset);
+  memcpy(m_buf.data() + m_offset, &size, sizeof(uint32_t));
+  auto target = m_target ? m_target : singletons::get_logger();
+  target->append(m_buf.data() + m_offset, size);
+  m_buf.resize(m_offset);
+}
+
+void log_record::append_string(const char* str, size_t size) {
+  auto used = m_buf.size() - m_offset;
+  auto available = max_size - std::min(max_size, used + 1 + sizeof(uint32_t));
+  auto len = static_cast<uint32_t>(std::min(size, available));
+  m_buf.push_back(string_arg);
+  auto first = reinterpret_cast<const char*>(&len);
+  m_buf.insert(m_buf.end(), first, first + sizeof(uint32_t));
+  m_buf.insert(m_buf.end(), str, str + len);
+}
+
+std::vector<char>& log_record::thread_buffer() {
+  thread_local std::vector<char> buf;
+  return buf;
+}
+
+logging::trace_helper::trace_helper(const log_site& site,
+                                    const char* class_name)
+    : m_site(site),
+      m_class(class_name),
+      m_enabled(logging::enabled(CAF_TRACE)
+                && logging::accepts(CAF_TRACE, class_name)) {
+  // nop
 }
 
 logging::trace_helper::~trace_helper() {
-  singletons::get_logger()->log("TRACE", m_class.c_str(), m_fun_name,
-                                m_file_name, m_line_num, "EXIT");
+  if (m_enabled) {
+    log_record{m_site, m_class} << "EXIT";
+  }
+}
+
+std::atomic<int> logging::s_max_level{global_log_level};
+
+void logging::set_level(int level) {
+  std::lock_guard<shared_spinlock> guard{s_levels_mtx};
+  s_level = level;
+  update_max_level(s_max_level);
+}
+
+void logging::set_level(const std::string& component, int level) {
+  std::lock_guard<shared_spinlock> guard{s_levels_mtx};
+  s_components[normalized_name(component.c_str())] = level;
+  s_has_components = true;
+  update_max_level(s_max_level);
+}
+
+void logging::reset_levels() {
+  std::lock_guard<shared_spinlock> guard{s_levels_mtx};
+  s_components.clear();
+  s_has_components = false;
+  update_max_level(s_max_level);
+}
+
+bool logging::accepts(int level, const char* class_name) {
+  // a component level may be below the global level, i.e., the global
+  // level only decides if no component matches
+  if (!s_has_components.load(std::memory_order_relaxed)) {
+    return level <= s_level.load(std::memory_order_relaxed);
+  }
+  { // lifetime scope of guard
+    shared_lock<shared_spinlock> guard{s_levels_mtx};
+    auto i = s_class_levels.find(class_name);
+    if (i != s_class_levels.end()) {
+      return level <= i->second;
+    }
+  }
+  std::lock_guard<shared_spinlock> guard{s_levels_mtx};
+  auto i = s_class_levels.find(class_name);
+  if (i == s_class_levels.end()) {
+    i = s_class_levels.emplace(class_name, class_level(class_name)).first;
+  }
+  return level <= i->second;
 }
 
 logging::~logging() {
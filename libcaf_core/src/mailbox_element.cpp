@@ -19,6 +19,8 @@
 
 #include "caf/mailbox_element.hpp"
 
+#include "caf/message_latency.hpp"
+
 namespace caf {
 
 mailbox_element::mailbox_element(actor_addr arg0, message_id arg1, message arg2)
@@ -26,7 +28,12 @@ mailbox_element::mailbox_element(actor_addr arg0, message_id arg1, message arg2)
       marked(false),
       sender(std::move(arg0)),
       mid(arg1),
-      msg(std::move(arg2)) {}
+      msg(std::move(arg2)),
+      trace(detail::t_current_trace) {
+  if (detail::s_trace_message_latency.load(std::memory_order_relaxed)) {
+    enqueued = detail::latency_clock();
+  }
+}
 
 mailbox_element::~mailbox_element() {
   // nop
@@ -19,8 +19,11 @@
 
 #include "caf/detail/memory.hpp"
 
+#include <map>
+#include <mutex>
 #include <vector>
 #include <typeinfo>
+#include <algorithm>
 
 #include "caf/mailbox_element.hpp"
 
@@ -28,12 +31,16 @@ using namespace std;
 
 #ifdef CAF_NO_MEM_MANAGEMENT
 
-int caf_memory_keep_compiler_happy() {
-  // this function shuts up a linker warning saying that the
-  // object file has no symbols
-  return 0;
+namespace caf {
+namespace detail {
+
+vector<memory_usage> memory::usage() {
+  return {};
 }
 
+} // namespace detail
+} // namespace caf
+
 #else // CAF_NO_MEM_MANAGEMENT
 
 namespace caf {
@@ -44,10 +51,54 @@ namespace {
 pthread_key_t s_key;
 pthread_once_t s_key_once = PTHREAD_ONCE_INIT;
 
+// keeps track of the caches of all threads for memory::usage()
+struct cache_registry {
+  mutex mtx;
+  vector<memory_cache*> caches;
+  map<const type_info*, atomic<int64_t>> in_use;
+};
+
+cache_registry& get_cache_registry() {
+  // never destroyed, since caches are released when their thread exits
+  static auto registry = new cache_registry;
+  return *registry;
+}
+
 } // namespace <anonymous>
 
+memory_cache::memory_cache(const type_info& type)
+    : m_type(&type),
+      m_cached(0) {
+  auto& registry = get_cache_registry();
+  lock_guard<mutex> guard{registry.mtx};
+  // elements of a map are value-initialized, i.e., zero
+  m_in_use = &registry.in_use[m_type];
+  registry.caches.push_back(this);
+}
+
 memory_cache::~memory_cache() {
-  // nop
+  auto& registry = get_cache_registry();
+  lock_guard<mutex> guard{registry.mtx};
+  auto& caches = registry.caches;
+  caches.erase(find(caches.begin(), caches.end(), this));
+}
+
+vector<memory_usage> memory::usage() {
+  auto& registry = get_cache_registry();
+  lock_guard<mutex> guard{registry.mtx};
+  vector<memory_usage> result;
+  for (auto& kvp : registry.in_use) {
+    uint64_t cached = 0;
+    for (auto c : registry.caches) {
+      if (&c->type() == kvp.first) {
+        cached += c->cached();
+      }
+    }
+    result.push_back(memory_usage{kvp.first,
+                                  kvp.second.load(memory_order_relaxed),
+                                  cached});
+  }
+  return result;
 }
 
 using cache_map = map<const type_info*, unique_ptr<memory_cache>>;
@@ -0,0 +1,214 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/message_latency.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <ostream>
+#include <typeindex>
+#include <algorithm>
+#include <unordered_map>
+
+#include "caf/locks.hpp"
+
+#include "caf/detail/demangle.hpp"
+#include "caf/detail/shared_spinlock.hpp"
+
+namespace caf {
+
+namespace {
+
+using latency_map = std::unordered_map<std::type_index,
+                                       std::unique_ptr<message_latency>>;
+
+// entries are never removed to keep references valid
+latency_map& latencies() {
+  static latency_map result;
+  return result;
+}
+
+detail::shared_spinlock& latencies_mtx() {
+  static detail::shared_spinlock result;
+  return result;
+}
+
+message_latency& latency_of(const std::type_info& tinf) {
+  std::type_index key{tinf};
+  auto& mtx = latencies_mtx();
+  { // lifetime scope of guard
+    shared_lock<detail::shared_spinlock> guard{mtx};
+    auto i = latencies().find(key);
+    if (i != latencies().end()) {
+      return *i->second;
+    }
+  }
+  std::lock_guard<detail::shared_spinlock> guard{mtx};
+  auto& ptr = latencies()[key];
+  if (!ptr) {
+    ptr.reset(new message_latency);
+  }
+  return *ptr;
+}
+
+inline size_t log2_of(uint64_t x) {
+# ifdef __GNUG__
+    return 63 - static_cast<size_t>(__builtin_clzll(x));
+# else
+    size_t result = 0;
+    while (x >>= 1) {
+      ++result;
+    }
+    return result;
+# endif
+}
+
+double to_us(double ns) {
+  return ns / 1000.;
+}
+
+} // namespace <anonymous>
+
+latency_histogram::latency_histogram() {
+  reset();
+}
+
+void latency_histogram::record(uint64_t ns) {
+  m_buckets[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(ns, std::memory_order_relaxed);
+  auto prev = m_max.load(std::memory_order_relaxed);
+  while (prev < ns && !m_max.compare_exchange_weak(prev, ns)) {
+    // prev was updated by compare_exchange_weak
+  }
+}
+
+uint64_t latency_histogram::count() const {
+  return m_count.load();
+}
+
+double latency_histogram::mean() const {
+  auto n = count();
+  return n == 0 ? 0. : static_cast<double>(m_sum.load()) / n;
+}
+
+uint64_t latency_histogram::max() const {
+  return m_max.load();
+}
+
+uint64_t latency_histogram::percentile(double p) const {
+  auto n = count();
+  if (n == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(p / 100. * n + 0.5);
+  rank = std::max<uint64_t>(1, std::min(rank, n));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < num_buckets; ++i) {
+    seen += m_buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(upper_bound_of(i), max());
+    }
+  }
+  return max();
+}
+
+void latency_histogram::reset() {
+  for (auto& bucket : m_buckets) {
+    bucket = 0;
+  }
+  m_count = 0;
+  m_sum = 0;
+  m_max = 0;
+}
+
+size_t latency_histogram::bucket_of(uint64_t ns) {
+  if (ns < sub_buckets) {
+    return static_cast<size_t>(ns);
+  }
+  auto e = log2_of(ns);
+  auto sub = static_cast<size_t>(ns >> (e - 4)) & (sub_buckets - 1);
+  return (e - 3) * sub_buckets + sub;
+}
+
+uint64_t latency_histogram::upper_bound_of(size_t index) {
+  if (index < sub_buckets) {
+    return index;
+  }
+  auto e = index / sub_buckets + 3;
+  auto sub = index % sub_buckets;
+  auto lower = static_cast<uint64_t>(sub_buckets + sub) << (e - 4);
+  return lower + ((uint64_t{1} << (e - 4)) - 1);
+}
+
+void trace_message_latency(bool enable) {
+  detail::s_trace_message_latency = enable;
+}
+
+bool trace_message_latency() {
+  return detail::s_trace_message_latency;
+}
+
+const message_latency& message_latency_of(const std::type_info& tinf) {
+  return latency_of(tinf);
+}
+
+void dump_message_latency(std::ostream& out) {
+  // sort by type name for a stable output
+  std::map<std::string, const message_latency*> entries;
+  { // lifetime scope of guard
+    shared_lock<detail::shared_spinlock> guard{latencies_mtx()};
+    for (auto& kvp : latencies()) {
+      entries.emplace(detail::demangle(kvp.first.name()), kvp.second.get());
+    }
+  }
+  for (auto& kvp : entries) {
+    auto& q = kvp.second->queueing;
+    auto& h = kvp.second->handling;
+    out << kvp.first << "," << q.count() << ","
+        << to_us(q.mean()) << "," << to_us(q.percentile(50)) << ","
+        << to_us(q.percentile(99)) << "," << to_us(q.max()) << ","
+        << to_us(h.mean()) << "," << to_us(h.percentile(50)) << ","
+        << to_us(h.percentile(99)) << "," << to_us(h.max()) << "\n";
+  }
+}
+
+void reset_message_latency() {
+  shared_lock<detail::shared_spinlock> guard{latencies_mtx()};
+  for (auto& kvp : latencies()) {
+    kvp.second->queueing.reset();
+    kvp.second->handling.reset();
+  }
+}
+
+namespace detail {
+
+std::atomic<bool> s_trace_message_latency{false};
+
+void record_message_latency(const std::type_info& tinf, uint64_t enqueued,
+                            uint64_t started, uint64_t finished) {
+  auto& entry = latency_of(tinf);
+  entry.queueing.record(started > enqueued ? started - enqueued : 0);
+  entry.handling.record(finished > started ? finished - started : 0);
+}
+
+} // namespace detail
+
+} // namespace caf
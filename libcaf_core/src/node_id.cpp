@@ -17,6 +17,9 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#include <map>
+#include <mutex>
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <sstream>
@@ -74,6 +77,58 @@ void host_id_from_string(const std::string& hash,
   }
 }
 
+// process-wide set of all node IDs, guaranteeing that
+// equal node IDs always share the same data instance
+class node_id_table {
+ public:
+  using data_ptr = intrusive_ptr<node_id::data>;
+
+  node_id_table() : m_purge_threshold(min_purge_threshold) {
+    // nop
+  }
+
+  data_ptr intern(uint32_t pid, const node_id::host_id_type& hid) {
+    std::unique_lock<std::mutex> guard{m_mtx};
+    auto& entry = m_entries[key_type{pid, hid}];
+    if (!entry) {
+      entry.reset(new node_id::data{pid, hid});
+      if (m_entries.size() >= m_purge_threshold) {
+        purge();
+      }
+    }
+    return entry;
+  }
+
+ private:
+  using key_type = std::pair<uint32_t, node_id::host_id_type>;
+
+  static constexpr size_t min_purge_threshold = 128;
+
+  // removes all IDs that are no longer used outside of this table; nobody
+  // can acquire a new reference to such an ID without holding m_mtx
+  void purge() {
+    for (auto i = m_entries.begin(); i != m_entries.end();) {
+      if (i->second->unique()) {
+        i = m_entries.erase(i);
+      } else {
+        ++i;
+      }
+    }
+    m_purge_threshold = std::max(min_purge_threshold, m_entries.size() * 2);
+  }
+
+  std::mutex m_mtx;
+  std::map<key_type, data_ptr> m_entries;
+  size_t m_purge_threshold;
+};
+
+constexpr size_t node_id_table::min_purge_threshold;
+
+node_id_table& get_node_id_table() {
+  static node_id_table instance;
+  return instance;
+}
+
 } // namespace <anonymous>
 
 bool equal(const std::string& hash, const node_id::host_id_type& node_id) {
@@ -116,15 +171,20 @@ node_id::node_id(intrusive_ptr<data> dataptr) : m_data(std::move(dataptr)) {
 }
 
 node_id::node_id(uint32_t procid, const std::string& b) {
-  m_data.reset(new data);
-  m_data->process_id = procid;
-  host_id_from_string(b, m_data->host_id);
+  host_id_type hid;
+  host_id_from_string(b, hid);
+  m_data = intern(procid, hid);
 }
 
-node_id::node_id(uint32_t a, const host_id_type& b) : m_data(new data{a, b}) {
+node_id::node_id(uint32_t a, const host_id_type& b) : m_data(intern(a, b)) {
   // nop
 }
 
+intrusive_ptr<node_id::data> node_id::intern(uint32_t process_id,
+                                             const host_id_type& host_id) {
+  return get_node_id_table().intern(process_id, host_id);
+}
+
 int node_id::compare(const invalid_node_id_t&) const {
   return m_data ? 1 : 0; // invalid instances are always smaller
 }
@@ -173,9 +233,9 @@ node_id::data* node_id::data::create_singleton() {
   auto hd_serial_and_mac_addr = join(macs, "") + detail::get_root_uuid();
   node_id::host_id_type nid;
   detail::ripemd_160(nid, hd_serial_and_mac_addr);
-  auto ptr = new node_id::data(static_cast<uint32_t>(getpid()), nid);
+  auto ptr = intern(static_cast<uint32_t>(getpid()), nid);
   ptr->ref(); // implicit ref count held by detail::singletons
-  return ptr;
+  return ptr.get();
 }
 
 uint32_t node_id::process_id() const {
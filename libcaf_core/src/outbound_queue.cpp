@@ -0,0 +1,95 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/outbound_queue.hpp"
+
+#include "caf/detail/sync_request_bouncer.hpp"
+
+namespace caf {
+
+outbound_message::outbound_message(actor_addr arg0, actor_addr arg1,
+                                   message_id arg2, message arg3, bool arg4)
+    : next(nullptr),
+      sender(std::move(arg0)),
+      receiver(std::move(arg1)),
+      mid(arg2),
+      msg(std::move(arg3)),
+      flow_controlled(arg4),
+      trace(detail::t_current_trace) {
+  // nop
+}
+
+outbound_message::~outbound_message() {
+  // nop
+}
+
+outbound_queue::outbound_queue() {
+  // the reader waits for a wakeup() before touching the queue
+  m_queue.try_block();
+}
+
+outbound_queue::~outbound_queue() {
+  // the single_reader_queue refuses to clear itself while blocked
+  m_queue.try_unblock();
+}
+
+bool outbound_queue::enqueue(const actor_addr& sender,
+                             const actor_addr& receiver, message_id mid,
+                             message msg, bool flow_controlled) {
+  auto ptr = outbound_message::create(sender, receiver, mid, std::move(msg),
+                                      flow_controlled);
+  switch (m_queue.enqueue(ptr)) {
+    case detail::enqueue_result::unblocked_reader:
+      wakeup();
+      return true;
+    case detail::enqueue_result::success:
+      return true;
+    case detail::enqueue_result::queue_closed:
+      return false;
+  }
+  return false;
+}
+
+outbound_message_ptr outbound_queue::try_pop() {
+  return outbound_message_ptr{m_queue.try_pop()};
+}
+
+bool outbound_queue::try_block() {
+  return m_queue.try_block();
+}
+
+void outbound_queue::close(uint32_t reason) {
+  if (!m_queue.closed()) {
+    m_queue.try_unblock();
+    detail::sync_request_bouncer f{reason};
+    m_queue.close([&](const outbound_message& x) {
+      f(x.sender, x.mid);
+    });
+  }
+}
+
+bool outbound_queue::closed() {
+  return m_queue.closed();
+}
+
+bool outbound_queue::may_block() const {
+  return true;
+}
+
+} // namespace caf
@@ -0,0 +1,233 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/runtime_inspector.hpp"
+
+#include <map>
+#include <chrono>
+#include <vector>
+#include <utility>
+#include <typeinfo>
+
+#include "caf/spawn.hpp"
+#include "caf/local_actor.hpp"
+#include "caf/system_messages.hpp"
+#include "caf/message_builder.hpp"
+#include "caf/event_based_actor.hpp"
+
+#include "caf/scheduler/abstract_coordinator.hpp"
+
+#include "caf/detail/memory.hpp"
+#include "caf/detail/demangle.hpp"
+#include "caf/detail/singletons.hpp"
+#include "caf/detail/actor_registry.hpp"
+
+namespace caf {
+
+namespace {
+
+using tick_atom = atom_constant<atom("TICK")>;
+
+using clock_type = std::chrono::steady_clock;
+
+double seconds_between(clock_type::time_point from,
+                       clock_type::time_point to) {
+  std::chrono::duration<double> diff = to - from;
+  return diff.count();
+}
+
+struct inspector_state {
+  // processed messages per actor at the previous query
+  std::map<actor_id, uint64_t> actors;
+  clock_type::time_point actors_time;
+  // statistics of the workers at the previous query
+  std::vector<scheduler::worker_load> workers;
+  clock_type::time_point workers_time;
+  // interval and generation of the subscription per subscriber,
+  // whereas ticks of an outdated generation are dropped
+  std::map<actor_addr, std::pair<uint32_t, uint64_t>> subscribers;
+  uint64_t generation = 0;
+};
+
+// strips the policies from the type name of actors created by `spawn`
+std::string actor_name(const abstract_actor& self) {
+  auto result = detail::demangle(typeid(self).name());
+  std::string prefix = "caf::detail::proper_actor<";
+  if (result.compare(0, prefix.size(), prefix) != 0) {
+    return result;
+  }
+  // the implementation type is the first template parameter
+  size_t depth = 0;
+  for (auto i = prefix.size(); i < result.size(); ++i) {
+    switch (result[i]) {
+      case '<':
+        ++depth;
+        break;
+      case '>':
+        --depth;
+        break;
+      case ',':
+        if (depth == 0) {
+          return result.substr(prefix.size(), i - prefix.size());
+        }
+    }
+  }
+  return result;
+}
+
+message actors_table(inspector_state& st) {
+  auto now = clock_type::now();
+  auto seconds = seconds_between(st.actors_time, now);
+  std::map<actor_id, uint64_t> samples;
+  message_builder rows;
+  for (auto& ptr : detail::singletons::get_actor_registry()->live()) {
+    uint64_t mailbox_size = 0;
+    uint64_t processed = 0;
+    auto lptr = dynamic_cast<local_actor*>(ptr.get());
+    if (lptr) {
+      // read processed first to never report negative mailbox sizes
+      processed = lptr->processed_messages();
+      auto enqueued = lptr->enqueued_messages();
+      mailbox_size = enqueued > processed ? enqueued - processed : 0;
+    }
+    double rate = 0;
+    auto i = st.actors.find(ptr->id());
+    if (i != st.actors.end() && seconds > 0) {
+      rate = static_cast<double>(processed - i->second) / seconds;
+    }
+    samples.emplace(ptr->id(), processed);
+    rows.append(make_message(ptr->id(), actor_name(*ptr),
+                             mailbox_size, processed, rate));
+  }
+  st.actors.swap(samples);
+  st.actors_time = now;
+  return rows.to_message();
+}
+
+message workers_table(inspector_state& st) {
+  auto now = clock_type::now();
+  auto ns = seconds_between(st.workers_time, now) * 1e9;
+  auto sched = detail::singletons::get_scheduling_coordinator();
+  auto loads = sched->worker_loads();
+  message_builder rows;
+  for (size_t i = 0; i < loads.size(); ++i) {
+    double load = 0;
+    if (i < st.workers.size() && ns > 0) {
+      auto busy = loads[i].busy_ns - st.workers[i].busy_ns;
+      load = static_cast<double>(busy) / ns;
+    }
+    rows.append(make_message(static_cast<uint64_t>(i), loads[i].resumed,
+                             loads[i].busy_ns, load));
+  }
+  st.workers.swap(loads);
+  st.workers_time = now;
+  return rows.to_message();
+}
+
+message memory_table() {
+  message_builder rows;
+  for (auto& usage : detail::memory::usage()) {
+    rows.append(make_message(detail::demangle(usage.type->name()),
+                             usage.in_use, usage.cached));
+  }
+  return rows.to_message();
+}
+
+} // namespace <anonymous>
+
+void inspect_runtime(bool enable) {
+  detail::s_inspect_runtime = enable;
+  if (!enable) {
+    // release all actors tracked so far
+    detail::singletons::get_actor_registry()->clear_live();
+  }
+}
+
+bool inspect_runtime() {
+  return detail::s_inspect_runtime;
+}
+
+actor spawn_runtime_inspector() {
+  inspect_runtime(true);
+  auto st = std::make_shared<inspector_state>();
+  st->actors_time = clock_type::now();
+  st->workers = detail::singletons::get_scheduling_coordinator()
+                ->worker_loads();
+  st->workers_time = st->actors_time;
+  return spawn<hidden>([=](event_based_actor* self) -> behavior {
+    auto send_snapshot = [=](const actor_addr& whom) {
+      self->send(actor_cast<actor>(whom), snapshot_atom::value,
+                 actors_table(*st), workers_table(*st), memory_table());
+    };
+    return {
+      [=](get_atom, actors_atom) {
+        return make_message(actors_atom::value, actors_table(*st));
+      },
+      [=](get_atom, workers_atom) {
+        return make_message(workers_atom::value, workers_table(*st));
+      },
+      [=](get_atom, memory_atom) {
+        return make_message(memory_atom::value, memory_table());
+      },
+      [=](get_atom) {
+        return make_message(snapshot_atom::value, actors_table(*st),
+                            workers_table(*st), memory_table());
+      },
+      [=](subscribe_atom, uint32_t ms) {
+        auto whom = self->last_sender();
+        auto i = st->subscribers.find(whom);
+        if (ms == 0) {
+          if (i != st->subscribers.end()) {
+            self->demonitor(whom);
+            st->subscribers.erase(i);
+          }
+          return;
+        }
+        if (i == st->subscribers.end()) {
+          self->monitor(whom);
+        }
+        auto gen = ++st->generation;
+        st->subscribers[whom] = std::make_pair(ms, gen);
+        self->delayed_send(self, std::chrono::milliseconds(ms),
+                           tick_atom::value, whom, gen);
+      },
+      [=](tick_atom, const actor_addr& whom, uint64_t gen) {
+        auto i = st->subscribers.find(whom);
+        if (i == st->subscribers.end() || i->second.second != gen) {
+          return;
+        }
+        send_snapshot(whom);
+        self->delayed_send(self, std::chrono::milliseconds(i->second.first),
+                           tick_atom::value, whom, gen);
+      },
+      [=](const down_msg& dm) {
+        st->subscribers.erase(dm.source);
+      }
+    };
+  });
+}
+
+namespace detail {
+
+std::atomic<bool> s_inspect_runtime{false};
+
+} // namespace detail
+
+} // namespace caf
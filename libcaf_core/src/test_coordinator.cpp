@@ -0,0 +1,175 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/scheduler/test_coordinator.hpp"
+
+#include <utility>
+#include <stdexcept>
+
+#include "caf/resumable.hpp"
+
+#include "caf/detail/logging.hpp"
+
+namespace caf {
+namespace scheduler {
+
+test_coordinator::test_coordinator(size_t max_throughput)
+    : super(1),
+      m_now(),
+      m_max_throughput(max_throughput) {
+  if (max_throughput == 0) {
+    throw std::invalid_argument("max_throughput must not be 0");
+  }
+}
+
+void test_coordinator::enqueue(resumable* what) {
+  std::lock_guard<std::mutex> guard{m_mtx};
+  m_jobs.push_back(what);
+}
+
+void test_coordinator::exec_later(resumable* what) {
+  enqueue(what);
+}
+
+size_t test_coordinator::num_jobs() const {
+  std::lock_guard<std::mutex> guard{m_mtx};
+  return m_jobs.size();
+}
+
+bool test_coordinator::run_job(size_t position) {
+  resumable* job;
+  { // lifetime scope of guard
+    std::lock_guard<std::mutex> guard{m_mtx};
+    if (position >= m_jobs.size()) {
+      return false;
+    }
+    auto i = m_jobs.begin() + static_cast<ptrdiff_t>(position);
+    job = *i;
+    m_jobs.erase(i);
+  }
+  switch (job->resume(this, m_max_throughput)) {
+    case resumable::resume_later:
+      enqueue(job);
+      break;
+    case resumable::done:
+      job->detach_from_scheduler();
+      break;
+    case resumable::awaiting_message:
+      // resumable will be enqueued again later
+      break;
+    case resumable::shutdown_execution_unit:
+      CAF_LOG_ERROR("test_coordinator cannot shut down");
+      break;
+  }
+  return true;
+}
+
+size_t test_coordinator::run(size_t max_jobs) {
+  size_t result = 0;
+  while (result < max_jobs && run_job(0)) {
+    ++result;
+  }
+  return result;
+}
+
+test_coordinator::time_point test_coordinator::now() const {
+  std::lock_guard<std::mutex> guard{m_mtx};
+  return m_now;
+}
+
+size_t test_coordinator::num_delayed() const {
+  std::lock_guard<std::mutex> guard{m_mtx};
+  return m_delayed.size();
+}
+
+size_t test_coordinator::advance_time(std::chrono::nanoseconds rel_time) {
+  time_point tp;
+  { // lifetime scope of guard
+    std::lock_guard<std::mutex> guard{m_mtx};
+    m_now += std::chrono::duration_cast<time_point::duration>(rel_time);
+    tp = m_now;
+  }
+  size_t result = 0;
+  delayed_msg dm;
+  // messages may schedule further messages, e.g., for periodic timeouts
+  while (pop_delayed(tp, dm)) {
+    dm.to->enqueue(dm.from, dm.mid, std::move(dm.msg), nullptr);
+    ++result;
+  }
+  return result;
+}
+
+bool test_coordinator::trigger_timeout() {
+  delayed_msg dm;
+  { // lifetime scope of guard
+    std::lock_guard<std::mutex> guard{m_mtx};
+    if (m_delayed.empty()) {
+      return false;
+    }
+    auto i = m_delayed.begin();
+    if (i->first > m_now) {
+      m_now = i->first;
+    }
+    dm = std::move(i->second);
+    m_delayed.erase(i);
+  }
+  dm.to->enqueue(dm.from, dm.mid, std::move(dm.msg), nullptr);
+  return true;
+}
+
+void test_coordinator::stop() {
+  CAF_LOG_TRACE("");
+  stop_actors();
+  std::deque<resumable*> jobs;
+  { // lifetime scope of guard
+    std::lock_guard<std::mutex> guard{m_mtx};
+    jobs.swap(m_jobs);
+    m_delayed.clear();
+  }
+  // run cleanup code for each resumable
+  for (auto job : jobs) {
+    job->detach_from_scheduler();
+  }
+}
+
+void test_coordinator::delayed_send_impl(const duration& rel_time,
+                                         actor_addr from, channel to,
+                                         message_id mid, message data) {
+  std::lock_guard<std::mutex> guard{m_mtx};
+  auto tp = m_now;
+  tp += rel_time;
+  m_delayed.insert(std::make_pair(tp, delayed_msg{std::move(from),
+                                                  std::move(to), mid,
+                                                  std::move(data)}));
+}
+
+bool test_coordinator::pop_delayed(time_point tp, delayed_msg& result) {
+  std::lock_guard<std::mutex> guard{m_mtx};
+  auto i = m_delayed.begin();
+  if (i == m_delayed.end() || i->first > tp) {
+    return false;
+  }
+  result = std::move(i->second);
+  m_delayed.erase(i);
+  return true;
+}
+
+} // namespace scheduler
+} // namespace caf
@@ -0,0 +1,93 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/trace_context.hpp"
+
+#include <random>
+
+namespace caf {
+
+namespace {
+
+uint64_t random_id() {
+  thread_local std::mt19937_64 engine{std::random_device{}()};
+  uint64_t result;
+  do {
+    result = engine();
+  } while (result == 0);
+  return result;
+}
+
+thread_local uint32_t t_countdown = 0;
+
+} // namespace <anonymous>
+
+const trace_context& trace_context::current() {
+  return detail::t_current_trace;
+}
+
+trace_context trace_context::child() const {
+  return {trace_id, random_id(), span_id, sampled};
+}
+
+void trace_sampling(uint32_t n) {
+  detail::s_trace_sampling = n;
+}
+
+uint32_t trace_sampling() {
+  return detail::s_trace_sampling;
+}
+
+scoped_trace::scoped_trace() : m_prev(detail::t_current_trace) {
+  detail::t_current_trace = detail::make_trace();
+}
+
+scoped_trace::scoped_trace(const trace_context& ctx)
+    : m_prev(detail::t_current_trace) {
+  detail::t_current_trace = ctx;
+}
+
+scoped_trace::~scoped_trace() {
+  detail::t_current_trace = m_prev;
+}
+
+namespace detail {
+
+thread_local trace_context t_current_trace{0, 0, 0, false};
+
+std::atomic<uint32_t> s_trace_sampling{0};
+
+trace_context make_trace() {
+  return {random_id(), random_id(), 0, true};
+}
+
+bool sample_trace() {
+  auto n = s_trace_sampling.load(std::memory_order_relaxed);
+  if (n == 0) {
+    return false;
+  }
+  if (t_countdown == 0 || t_countdown > n) {
+    t_countdown = n;
+  }
+  return --t_countdown == 0;
+}
+
+} // namespace detail
+
+} // namespace caf
@@ -22,6 +22,7 @@
 #include <tuple>
 #include <limits>
 #include <string>
+#include <stdexcept>
 #include <vector>
 #include <cstring> // memcmp
 #include <algorithm>
@@ -565,12 +566,11 @@ class default_meta_message : public uniform_type_info {
     CAF_REQUIRE(elements.size() > 0 && elements.front() == "@<>");
     // ignore first element, because it's always "@<>"
     for (size_t i = 1; i != elements.size(); ++i) {
-      try {
-        m_elements.push_back(uti_map->by_uniform_name(elements[i]));
-      }
-      catch (std::exception&) {
-        CAF_LOG_ERROR("type name " << elements[i] << " not found");
+      auto uti = uti_map->by_uniform_name(elements[i]);
+      if (!uti) {
+        throw std::invalid_argument("unknown type name: " + elements[i]);
       }
+      m_elements.push_back(uti);
     }
   }
   uniform_value create(const uniform_value& other) const override {
@@ -705,7 +705,12 @@ class utim_impl : public uniform_type_info_map {
     }
     if (!result && name.compare(0, 3, "@<>") == 0) {
       // create tuple UTI on-the-fly
-      result = insert(uniform_type_info_ptr{new default_meta_message(name)});
+      try {
+        result = insert(uniform_type_info_ptr{new default_meta_message(name)});
+      }
+      catch (std::invalid_argument& e) {
+        CAF_LOG_ERROR(e.what());
+      }
     }
     return result;
   }
@@ -24,7 +24,9 @@
 #include "caf/io/publish.hpp"
 #include "caf/io/spawn_io.hpp"
 #include "caf/io/middleman.hpp"
+#include "caf/io/io_threads.hpp"
 #include "caf/io/unpublish.hpp"
+#include "caf/io/local_transport.hpp"
 #include "caf/io/basp_broker.hpp"
 #include "caf/io/max_msg_size.hpp"
 #include "caf/io/remote_actor.hpp"
@@ -32,5 +34,10 @@
 #include "caf/io/receive_policy.hpp"
 #include "caf/io/system_messages.hpp"
 #include "caf/io/publish_local_groups.hpp"
+#include "caf/io/parallel_connections.hpp"
+#include "caf/io/flow_control.hpp"
+#include "caf/io/compression.hpp"
+#include "caf/io/trace_recorder.hpp"
+#include "caf/io/traffic_metrics.hpp"
 
 #endif // CAF_IO_ALL_HPP
@@ -51,14 +51,136 @@ struct header {
  * The current BASP version. Different BASP versions will not
  * be able to exchange messages.
  */
-constexpr uint64_t version = 1;
+constexpr uint64_t version = 8;
 
 /**
- * Size of a BASP header in serialized form
+ * Encodings for node IDs in a serialized BASP header. Both endpoints of a
+ * connection learn each other's node ID during the handshake. Hence, the
+ * IDs of sender and receiver of a frame are transmitted as short aliases,
+ * while all other node IDs follow the fixed part of the header in full.
+ * The first byte of a serialized header stores the encoding of
+ * `source_node` in bits 0-1 and the encoding of `dest_node` in bits 2-3.
+ * Bit 4 stores the `credit_flag`, bit 5 the `compressed_flag`, and
+ * bit 6 the `trace_flag`.
  */
-constexpr size_t header_size =
-  node_id::host_id_size * 2 + sizeof(uint32_t) * 2 +
-  sizeof(actor_id) * 2 + sizeof(uint32_t) * 2 + sizeof(uint64_t);
+enum node_encoding : uint8_t {
+  invalid_node_encoding = 0x00,
+  sender_node_encoding = 0x01,
+  receiver_node_encoding = 0x02,
+  full_node_encoding = 0x03
+};
+
+/**
+ * Size of a node ID in serialized form.
+ */
+constexpr size_t node_id_size = node_id::host_id_size + sizeof(uint32_t);
+
+/**
+ * Size of a BASP header in serialized form if both node IDs are aliases.
+ */
+constexpr size_t min_header_size =
+  sizeof(uint8_t) + sizeof(actor_id) * 2 + sizeof(uint32_t) * 2
+  + sizeof(uint64_t);
+
+/**
+ * Size of the trace context following the node IDs of a header
+ * with the `trace_flag`, i.e., trace ID, span ID, and parent ID.
+ */
+constexpr size_t trace_context_size = sizeof(uint64_t) * 3;
+
+/**
+ * Size of a BASP header in serialized form if both node IDs are sent
+ * in full and the header includes a trace context.
+ */
+constexpr size_t max_header_size = min_header_size + node_id_size * 2
+                                   + trace_context_size;
+
+/**
+ * Set in the flags of a `dispatch_message` or `dispatch_fragment` to
+ * request a `grant_credit` from the receiver once it has processed the
+ * frame. Only used for messages to direct neighbors.
+ */
+constexpr uint8_t credit_flag = 0x10;
+
+/**
+ * Set in the flags of a `dispatch_message` if its payload, including the
+ * payload of all preceding fragments, has been compressed by `lz_codec`.
+ * Only used for messages to direct neighbors that set this flag in their
+ * handshake. In a `server_handshake`, this flag offers compression to
+ * the client and in a `client_handshake` accepts the offer.
+ */
+constexpr uint8_t compressed_flag = 0x20;
+
+/**
+ * Set in the flags of a `dispatch_message` if the message belongs to a
+ * sampled trace, in which case the header ends with trace ID, span ID,
+ * and parent ID of the message. Each node sending a message starts a
+ * new span, whereas forwarding nodes leave the trace context unchanged.
+ */
+constexpr uint8_t trace_flag = 0x40;
+
+inline node_encoding source_encoding(uint8_t flags) {
+  return static_cast<node_encoding>(flags & 0x03);
+}
+
+inline node_encoding dest_encoding(uint8_t flags) {
+  return static_cast<node_encoding>((flags >> 2) & 0x03);
+}
+
+/**
+ * Returns whether `flags` contains only known bits.
+ */
+inline bool valid_flags(uint8_t flags) {
+  return (flags & 0x80) == 0;
+}
+
+/**
+ * Returns whether a header with given flags uses an alias for
+ * at least one node ID, i.e., whether it is only meaningful to
+ * the receiver of the frame and must be rewritten when forwarded.
+ */
+inline bool has_aliases(uint8_t flags) {
+  auto is_alias = [](node_encoding x) {
+    return x == sender_node_encoding || x == receiver_node_encoding;
+  };
+  return is_alias(source_encoding(flags)) || is_alias(dest_encoding(flags));
+}
+
+/**
+ * Returns the size of a serialized BASP header starting with `flags`.
+ */
+inline size_t header_size(uint8_t flags) {
+  return min_header_size
+         + (source_encoding(flags) == full_node_encoding ? node_id_size : 0)
+         + (dest_encoding(flags) == full_node_encoding ? node_id_size : 0)
+         + ((flags & trace_flag) != 0 ? trace_context_size : 0);
+}
+
+/**
+ * Maximum number of bytes a BASP broker reads from a connection at once.
+ * A single read usually contains several complete messages, which are
+ * then processed in one go.
+ */
+constexpr size_t read_ahead_size = 65536;
+
+/**
+ * Maximum number of connections between two nodes. All connections except
+ * the first one, i.e., the connection that established the route between
+ * the nodes, are called lanes and have IDs in the range `[1, max_lanes)`.
+ */
+constexpr uint64_t max_lanes = 64;
+
+/**
+ * ID of the lane that carries large messages.
+ */
+constexpr uint64_t bulk_lane = 0xFFFFFFFF;
+
+/**
+ * Returns whether `lane` is the ID of an additional connection.
+ */
+inline bool valid_lane(uint64_t lane) {
+  return (lane > 0 && lane < max_lanes) || lane == bulk_lane;
+}
 
 inline bool valid(const node_id& val) {
   return val != invalid_node_id;
@@ -89,6 +211,8 @@ inline bool nonzero(T aid) {
  * source_actor   | Optional: ID of published actor
  * dest_actor     | 0
  * payload_len    | Optional: size of actor id + interface definition
+ *                | + path of a Unix domain socket for local clients,
+ *                |   prefixed with `shm:` for shared memory
  * operation_data | BASP version of the server
  */
 constexpr uint32_t server_handshake = 0x00;
@@ -113,7 +237,7 @@ inline bool server_handshake_valid(const header& hdr) {
  * source_actor   | 0
  * dest_actor     | 0
  * payload_len    | 0
- * operation_data | 0
+ * operation_data | 0 or the lane ID of an additional connection
  */
 constexpr uint32_t client_handshake = 0x01;
 
@@ -124,7 +248,7 @@ inline bool client_handshake_valid(const header& hdr) {
        && zero(hdr.source_actor)
        && zero(hdr.dest_actor)
        && zero(hdr.payload_len)
-       && zero(hdr.operation_data);
+       && (zero(hdr.operation_data) || valid_lane(hdr.operation_data));
 }
 
 /**
@@ -200,6 +324,105 @@ inline bool kill_proxy_instance_valid(const header& hdr) {
        && nonzero(hdr.operation_data);
 }
 
+/**
+ * Send from server to client after receiving the client_handshake
+ * of an additional connection. The client uses its lanes only after
+ * the server confirmed all of them.
+ *
+ * Field          | Assignment
+ * ---------------|----------------------------------------------------------
+ * source_node    | ID of server
+ * dest_node      | ID of client
+ * source_actor   | 0
+ * dest_actor     | 0
+ * payload_len    | 0
+ * operation_data | lane ID
+ */
+constexpr uint32_t lane_confirmation = 0x05;
+
+inline bool lane_confirmation_valid(const header& hdr) {
+  return  valid(hdr.source_node)
+       && valid(hdr.dest_node)
+       && hdr.source_node != hdr.dest_node
+       && zero(hdr.source_actor)
+       && zero(hdr.dest_actor)
+       && zero(hdr.payload_len)
+       && valid_lane(hdr.operation_data);
+}
+
+/**
+ * Returns credit for messages with the `credit_flag` to their sender.
+ * A node sends one grant per receiving actor after processing data
+ * received on a connection, using the same connection.
+ *
+ * Field          | Assignment
+ * ---------------|----------------------------------------------------------
+ * source_node    | ID of receiving node
+ * dest_node      | ID of sending node
+ * source_actor   | ID of receiving actor
+ * dest_actor     | 0
+ * payload_len    | 0
+ * operation_data | size of the frames in bytes, including headers, in the
+ *                | upper 32 bits and number of messages in the lower 32
+ *                | bits, which is 0 if only fragments have been received
+ */
+constexpr uint32_t grant_credit = 0x06;
+
+inline bool grant_credit_valid(const header& hdr) {
+  return  valid(hdr.source_node)
+       && valid(hdr.dest_node)
+       && hdr.source_node != hdr.dest_node
+       && nonzero(hdr.source_actor)
+       && zero(hdr.dest_actor)
+       && zero(hdr.payload_len)
+       && nonzero(hdr.operation_data);
+}
+
+/**
+ * Transmits a part of a message from source_node:source_actor to
+ * dest_node:dest_actor. The receiver buffers all fragments until the
+ * remainder of the message arrives as regular `dispatch_message`. The
+ * sender interleaves fragments with other messages on the same connection,
+ * but never with other messages from source_actor to dest_actor.
+ *
+ * Field          | Assignment
+ * ---------------|----------------------------------------------------------
+ * source_node    | ID of sending node (invalid in case of anon_send)
+ * dest_node      | ID of receiving node
+ * source_actor   | ID of sending actor (invalid in case of anon_send)
+ * dest_actor     | ID of receiving actor, must not be invalid
+ * payload_len    | size of the fragment, must not be 0
+ * operation_data | message ID (0 for asynchronous messages)
+ */
+constexpr uint32_t dispatch_fragment = 0x07;
+
+inline bool dispatch_fragment_valid(const header& hdr) {
+  return dispatch_message_valid(hdr);
+}
+
+/**
+ * Computes the flags for sending `hdr` from node `self` to its direct
+ * neighbor `peer`. Aliases require a completed handshake and are only
+ * used for frames addressed to `peer`, so that frames passing through
+ * a node can be forwarded as they are.
+ */
+inline uint8_t make_flags(const header& hdr, const node_id& self,
+                          const node_id& peer) {
+  auto encode = [](const node_id& nid) {
+    return valid(nid) ? full_node_encoding : invalid_node_encoding;
+  };
+  auto src = encode(hdr.source_node);
+  auto dest = encode(hdr.dest_node);
+  if (hdr.operation != server_handshake && hdr.operation != client_handshake
+      && valid(peer) && hdr.dest_node == peer) {
+    dest = receiver_node_encoding;
+    if (hdr.source_node == self) {
+      src = sender_node_encoding;
+    }
+  }
+  return static_cast<uint8_t>(src | (dest << 2));
+}
+
 /**
  * Checks whether given header is valid.
  */
@@ -217,6 +440,12 @@ inline bool valid(header& hdr) {
       return announce_proxy_instance_valid(hdr);
     case kill_proxy_instance:
       return kill_proxy_instance_valid(hdr);
+    case lane_confirmation:
+      return lane_confirmation_valid(hdr);
+    case grant_credit:
+      return grant_credit_valid(hdr);
+    case dispatch_fragment:
+      return dispatch_fragment_valid(hdr);
   }
 }
 
@@ -22,10 +22,16 @@
 
 #include <map>
 #include <set>
+#include <deque>
+#include <tuple>
+#include <mutex>
+#include <memory>
 #include <string>
 #include <future>
 #include <vector>
 
+#include "caf/trace_context.hpp"
+#include "caf/outbound_queue.hpp"
 #include "caf/actor_namespace.hpp"
 #include "caf/binary_serializer.hpp"
 #include "caf/binary_deserializer.hpp"
@@ -34,11 +40,16 @@
 #include "caf/io/basp.hpp"
 #include "caf/io/broker.hpp"
 
+#include "caf/io/network/lz_codec.hpp"
+
 namespace caf {
 namespace io {
 
 /**
  * A broker implementation for the Binary Actor System Protocol (BASP).
+ * The middleman runs one instance per multiplexer. Each instance handles
+ * the connections registered at its multiplexer, whereas all instances
+ * share proxies and know which instance sends the messages to a node.
  */
 class basp_broker : public broker, public actor_namespace::backend {
  public:
@@ -46,6 +57,13 @@ class basp_broker : public broker, public actor_namespace::backend {
 
   basp_broker(middleman& parent_ref);
 
+  /**
+   * Creates a broker running on `backend_ref` that shares proxies
+   * and nodes with `first`, which handles all publish requests
+   * and distributes remote actor requests among all brokers.
+   */
+  basp_broker(basp_broker& first, network::multiplexer& backend_ref);
+
   behavior make_behavior() override;
 
   void add_published_actor(accept_handle hdl, const abstract_actor_ptr& whom,
@@ -66,10 +84,14 @@ class basp_broker : public broker, public actor_namespace::backend {
     virtual void write(binary_serializer&) = 0;
   };
 
-  void dispatch(connection_handle hdl, uint32_t operation,
-                const node_id& src_node, actor_id src_actor,
-                const node_id& dest_node, actor_id dest_actor,
-                uint64_t op_data = 0, payload_writer* writer = nullptr);
+  // returns the size of the frame, `flags` may contain
+  // `basp::credit_flag` and `basp::compressed_flag`, while
+  // sampled `trace` contexts are added to the header
+  size_t dispatch(connection_handle hdl, uint32_t operation,
+                  const node_id& src_node, actor_id src_actor,
+                  const node_id& dest_node, actor_id dest_actor,
+                  uint64_t op_data = 0, payload_writer* writer = nullptr,
+                  uint8_t flags = 0, const trace_context* trace = nullptr);
 
   node_id dispatch(uint32_t operation, const node_id& src_node,
                    actor_id src_actor, const node_id& dest_node,
@@ -84,6 +106,17 @@ class basp_broker : public broker, public actor_namespace::backend {
     int64_t request_id;
     actor client;
     std::set<std::string> expected_ifs;
+    // endpoint of the server for opening additional connections,
+    // `host` stores the path of a local socket if `port` is 0
+    std::string host;
+    uint16_t port;
+    // lane ID of an additional connection to `peer`, 0 otherwise
+    uint64_t lane;
+    node_id peer;
+    // TCP connection to `peer` that remains open while the handshake is
+    // repeated on a local socket and ID of the actor published by `peer`
+    connection_handle fallback;
+    actor_id remote_aid;
   };
 
   inline actor_namespace& get_namespace() {
@@ -91,8 +124,64 @@ class basp_broker : public broker, public actor_namespace::backend {
   }
 
  private:
+  class outbound_queue_impl;
+
+  // state shared by the brokers of all multiplexers
+  struct shared_state;
+
+  // the broker sending all messages to a node and the queue of its proxies
+  using node_owner = std::pair<basp_broker*,
+                               intrusive_ptr<outbound_queue_impl>>;
+
+  // returns the broker owning `nid`, i.e., the first broker that had a
+  // route to `nid`, or a null pointer if no broker has a route to `nid`
+  node_owner find_owner(const node_id& nid);
+
+  // makes this broker the owner of `nid` unless another broker owns
+  // `nid` already and returns the current owner
+  node_owner claim(const node_id& nid);
+
+  // releases `nid` if this broker owns it and returns the queue of its
+  // proxies in this case, the queue is a null pointer otherwise
+  intrusive_ptr<outbound_queue_impl> release(const node_id& nid);
+
+  // returns whether this broker handles publish and remote actor requests
+  bool is_first() const;
+
+  // returns all other brokers sharing state with this broker
+  std::vector<basp_broker*> other_shards() const;
+
+  // selects the broker for the next remote actor request round-robin
+  basp_broker* next_shard();
+
+  // lets all other brokers accept connections for `ptr` on the sockets
+  // of `hdl`, using shared memory if `shm` is set, and of `local_hdl`
+  // if the latter is valid, offering `local_path` to clients
+  void share_published_actor(accept_handle hdl, bool shm,
+                             const abstract_actor_ptr& ptr, uint16_t port,
+                             accept_handle local_hdl,
+                             const std::string& local_path);
+
   void erase_proxy(const node_id& nid, actor_id aid);
 
+  // dispatches all messages of an outbound queue to their remote receivers
+  // until the queue is empty or a connection runs out of credit
+  void drain(outbound_queue_impl& queue);
+
+  // dispatches a message from a local actor to a remote node, returns
+  // false if `may_wait` is set and the connection has no credit left;
+  // `flow_controlled` messages count against the credit of their proxy
+  bool try_dispatch(const actor_addr& from, const actor_addr& to,
+                    message_id mid, const message& msg, bool may_wait,
+                    bool flow_controlled);
+
+  // returns credit for a message to `proxy` that was sent without
+  // the credit flag, i.e., without the receiver returning credit
+  void return_credit(const actor_addr& proxy);
+
+  // dispatches messages to `nid` that wait for credit
+  void resume(const node_id& nid);
+
   // dispatches a message from a remote node to a local actor
   void local_dispatch(const basp::header& msg, message&& payload);
 
@@ -101,6 +190,9 @@ class basp_broker : public broker, public actor_namespace::backend {
     await_server_handshake,
     // server accepted new connection and sent handshake, await response
     await_client_handshake,
+    // client repeats the handshake on a local socket, keeps this
+    // connection as fallback and expects no data on it
+    await_local_handshake,
     // connection established, read series of broker messages
     await_header,
     // currently waiting for payload of a received message
@@ -109,6 +201,24 @@ class basp_broker : public broker, public actor_namespace::backend {
     close_connection
   };
 
+  // identifies all messages from one actor to another, i.e.,
+  // (source node, source actor, receiving actor)
+  using fragment_key = std::tuple<node_id, actor_id, actor_id>;
+
+  // a message sent in fragments or waiting for such a message
+  // from the same sender to the same receiver
+  struct transfer {
+    // header of the last fragment, i.e., the final `dispatch_message`
+    basp::header hdr;
+    network::shared_buffer_ptr payload;
+    // number of bytes sent so far
+    size_t offset;
+    bool credit;
+    bool compressed;
+    // sent with the last fragment if sampled
+    trace_context trace;
+  };
+
   struct connection_context {
     connection_state state;
     connection_handle hdl;
@@ -121,11 +231,69 @@ class basp_broker : public broker, public actor_namespace::backend {
     // a bug where re-using an "old" connection via
     // remote_actor() could return an expired proxy
     actor published_actor;
+    // stores the beginning of an incomplete message
+    // until the remaining bytes have been received
+    buffer_type pending;
+    // stores the payload of the message currently processed
+    buffer_type payload;
+    // size of the current header if its sender requested credit, 0 otherwise
+    size_t frame_credit;
+    // whether the current header has the compressed flag set
+    bool frame_compressed;
+    // trace context of the current header, unsampled if absent
+    trace_context frame_trace;
+    // whether both nodes agreed to use compression on this connection
+    bool compress;
+    // receiving actor => (bytes, number of messages) to return as credit
+    std::map<actor_id, std::pair<uint64_t, uint32_t>> grants;
+    // bytes sent with the credit flag and not returned by the receiver yet
+    size_t in_flight;
+    // fragments received so far for each incomplete message
+    std::map<fragment_key, buffer_type> fragments;
+    // sum of all buffer sizes in `fragments`
+    size_t fragment_bytes;
+    // outgoing messages sent in fragments, interleaved with other data
+    std::deque<transfer> transfers;
   };
 
-  void read(binary_deserializer& bs, basp::header& msg);
-
-  void write(binary_serializer& bs, const basp::header& msg);
+  // reads a header received on `ctx`, resolving node aliases;
+  // returns false if the header uses an unknown encoding
+  bool read(binary_deserializer& bs, basp::header& msg,
+            connection_context& ctx);
+
+  // writes a header for a connection to `peer`, using node aliases
+  // if the handshake has been completed and adding `extra_flags`
+  // as well as `trace` if it is sampled
+  void write(binary_serializer& bs, const basp::header& msg,
+             const node_id& peer, uint8_t extra_flags = 0,
+             const trace_context* trace = nullptr);
+
+  // returns the ID of the node connected via `hdl` if known
+  node_id peer(connection_handle hdl) const;
+
+  // returns credit for the frame received via `ctx` if requested by
+  // the sender, whereas fragments do not count as messages
+  void collect_credit(connection_context& ctx, uint32_t num_messages);
+
+  // sends all credit accumulated for messages received via `ctx`
+  void send_grants(connection_context& ctx);
+
+  // writes a frame to the buffer of `hdl` like `dispatch`
+  // but leaves flushing the buffer to the caller
+  size_t append_frame(connection_handle hdl, uint32_t operation,
+                      const node_id& src_node, actor_id src_actor,
+                      const node_id& dest_node, actor_id dest_actor,
+                      uint64_t op_data, payload_writer* writer,
+                      uint8_t flags, const trace_context* trace);
+
+  // sends the serialized message in `m_payload_buf` in fragments
+  // via `ctx`, `hdr` is the header of the last fragment
+  void add_transfer(connection_context& ctx, const basp::header& hdr,
+                    bool credit, bool compressed, const trace_context& trace);
+
+  // sends the next fragment of each transfer via `ctx`, skipping messages
+  // queued behind another message from the same sender to the same receiver
+  void send_fragments(connection_context& ctx);
 
   void send_kill_proxy_instance(const node_id& nid, actor_id aid,
                                 uint32_t reason);
@@ -140,10 +308,69 @@ class basp_broker : public broker, public actor_namespace::backend {
 
   void new_data(connection_context& ctx, buffer_type& buf);
 
+  // returns the size of the header or payload we are waiting for, whereas
+  // `first` points to the first received byte of the frame or is nullptr
+  inline size_t frame_size(const connection_context& ctx,
+                           const char* first) const {
+    if (ctx.state == await_payload) {
+      return ctx.hdr.payload_len;
+    }
+    return first ? basp::header_size(static_cast<uint8_t>(*first))
+                 : basp::min_header_size;
+  }
+
+  // processes a single header or payload, returns false
+  // if the connection has been closed as a result
+  bool handle_frame(connection_context& ctx, const char* data, size_t size);
+
+  // passes a complete message for another node starting at `frame` to
+  // the next hop without copying it, moving `buf` to `shared` on first
+  // use; returns false if there is no route to the destination
+  bool forward_frame(connection_context& ctx, buffer_type& buf,
+                     network::shared_buffer_ptr& shared, const char* frame);
+
   void init_handshake_as_client(connection_context& ctx);
 
+  // opens additional connections to `nid` after the handshake succeeded
+  // on the first connection, returns false if no lane is configured
+  bool open_lanes(const node_id& nid, const client_handshake_data& hd,
+                  const actor_addr& result);
+
+  // stores `hdl` as connection with ID `lane` to `nid`,
+  // returns false if the lane is already connected
+  bool add_lane(const node_id& nid, uint64_t lane, connection_handle hdl);
+
+  // completes a lane opened by `open_lanes`, `hdl` is invalid on failure;
+  // replies to `remote_actor` once the last pending lane has completed
+  // and ignores lanes completing after the first connection was lost
+  void lane_done(const node_id& nid, connection_handle hdl, uint64_t lane);
+
+  // reports failure of a lane if `ctx` is a pending lane
+  void abort_lane(connection_context& ctx);
+
+  // completes the handshake on the TCP connection kept open as fallback
+  // if `ctx` is a local socket that failed before the server responded
+  void fall_back_to_tcp(connection_context& ctx);
+
+  // connects `ctx` to `nid` after receiving the server handshake, unless
+  // another connection to `nid` exists, and replies to `remote_actor`
+  connection_state finish_client_handshake(connection_context& ctx,
+                                           const node_id& nid,
+                                           actor_id remote_aid);
+
+  // selects the connection for a message from `src` to `dest` on
+  // node `nid`, `primary` is the default route to `nid`
+  connection_handle select_lane(connection_handle primary, const node_id& nid,
+                                actor_id src, actor_id dest, bool bulk);
+
+  // connects to the Unix domain socket at `path`, using
+  // shared memory if `path` starts with `shm:`
+  connection_handle connect_local(std::string path);
+
+  // `local_path` is the Unix domain socket offered to clients on this host
   void init_handshake_as_server(connection_context& ctx,
-                                actor_addr published_actor);
+                                actor_addr published_actor,
+                                const std::string& local_path);
 
   void serialize_msg(const actor_addr& sender, message_id mid,
                      const message& msg, buffer_type& wr_buf);
@@ -152,6 +379,10 @@ class basp_broker : public broker, public actor_namespace::backend {
 
   void add_route(const node_id& nid, connection_handle hdl);
 
+  // removes all routes using `hdl` and kills proxies
+  // of nodes that are no longer reachable afterwards
+  void purge_routes(connection_handle hdl);
+
   struct connection_info {
     connection_handle hdl;
     node_id node;
@@ -168,6 +399,10 @@ class basp_broker : public broker, public actor_namespace::backend {
 
   connection_info get_route(const node_id& dest);
 
+  // passes a message for another node to the next hop via `route`
+  void forward(const connection_info& route, const basp::header& hdr,
+               const buffer_type* payload, const trace_context& trace);
+
   struct connection_info_less {
     inline bool operator()(const connection_info& lhs,
                            const connection_info& rhs) const {
@@ -205,10 +440,41 @@ class basp_broker : public broker, public actor_namespace::backend {
   std::map<connection_handle, connection_context> m_ctx;
   std::map<accept_handle, std::pair<abstract_actor_ptr, uint16_t>> m_acceptors;
   std::map<uint16_t, accept_handle> m_open_ports;
+  // TCP acceptor => path of its accompanying Unix domain socket
+  std::map<accept_handle, std::string> m_local_paths;
   routing_table m_routes; // stores non-direct routes
   std::set<blacklist_entry, blacklist_less> m_blacklist; // stores invalidated
                                                          // routes
   std::set<pending_request> m_pending_requests;
+  // proxies and nodes of all brokers
+  std::shared_ptr<shared_state> m_shared;
+  // connection attempts started on behalf of remote_actor()
+  std::map<connection_handle, client_handshake_data> m_pending_connections;
+
+  // additional connections to a node, i.e., lanes
+  struct lane_set {
+    std::vector<connection_handle> lanes; // lane ID - 1 => connection
+    connection_handle bulk;
+  };
+
+  std::map<node_id, lane_set> m_lanes;
+
+  // remote_actor() requests waiting for lanes to complete
+  struct lane_setup {
+    size_t pending;
+    actor_addr result;
+    std::vector<std::pair<actor, int64_t>> clients;
+  };
+
+  std::map<node_id, lane_setup> m_lane_setups;
+
+  // serialized payload for deciding whether a message
+  // uses the bulk lane or is sent in fragments
+  buffer_type m_payload_buf;
+
+  // compresses messages to neighbors that support compression
+  network::lz_codec m_codec;
+  buffer_type m_codec_buf;
 
   // needed to keep track to which node we are talking to at the moment
   connection_context* m_current_context;
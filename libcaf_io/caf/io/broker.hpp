@@ -39,6 +39,7 @@
 #include "caf/io/system_messages.hpp"
 #include "caf/io/connection_handle.hpp"
 #include "caf/io/network/native_socket.hpp"
+#include "caf/io/network/shared_buffer.hpp"
 #include "caf/io/network/stream_manager.hpp"
 #include "caf/io/network/acceptor_manager.hpp"
 
@@ -110,12 +111,25 @@ class broker : public extend<local_actor>::
      */
     virtual buffer_type& wr_buf() = 0;
 
+    /**
+     * Appends `num_bytes` bytes of `buf` starting at `offset` to the
+     * output. The default implementation copies the data to `wr_buf()`.
+     */
+    virtual void write(const network::shared_buffer_ptr& buf, size_t offset,
+                       size_t num_bytes);
+
     /**
      * Flushes the output buffer, i.e., sends the content of
      *    the buffer via the network.
      */
     virtual void flush() = 0;
 
+    /**
+     * Enables or disables `data_transferred_msg` notifications
+     * whenever this scribe has written data to the network.
+     */
+    virtual void ack_writes(bool enable) = 0;
+
     inline connection_handle hdl() const {
       return m_hdl;
     }
@@ -139,6 +153,8 @@ class broker : public extend<local_actor>::
 
     void consume(const void* data, size_t num_bytes) override;
 
+    void data_transferred(size_t num_bytes, size_t remaining) override;
+
     connection_handle m_hdl;
 
     message m_read_msg;
@@ -210,11 +226,24 @@ class broker : public extend<local_actor>::
    */
   void write(connection_handle hdl, size_t data_size, const void* data);
 
+  /**
+   * Writes `num_bytes` bytes of `buf` starting at `offset` to given
+   * connection, without copying them if the backend supports it.
+   */
+  void write(connection_handle hdl, const network::shared_buffer_ptr& buf,
+             size_t offset, size_t num_bytes);
+
   /**
    * Sends the content of the buffer for given connection.
    */
   void flush(connection_handle hdl);
 
+  /**
+   * Enables or disables `data_transferred_msg` notifications for given
+   * connection, e.g., to pace writes of large amounts of data.
+   */
+  void ack_writes(connection_handle hdl, bool enable);
+
   /**
    * Returns the number of open connections.
    */
@@ -241,7 +270,11 @@ class broker : public extend<local_actor>::
     auto sptr = i->second;
     CAF_REQUIRE(sptr->hdl() == hdl);
     m_scribes.erase(i);
-    return spawn_functor(nullptr, [sptr](broker* forked) {
+    auto bptr = m_backend;
+    return spawn_functor(nullptr, [sptr, bptr](broker* forked) {
+                                    // the scribe's socket is registered
+                                    // at our multiplexer
+                                    forked->m_backend = bptr;
                                     sptr->set_broker(forked);
                                     forked->m_scribes.insert(
                                       std::make_pair(sptr->hdl(), sptr));
@@ -255,6 +288,14 @@ class broker : public extend<local_actor>::
 
   connection_handle add_tcp_scribe(const std::string& host, uint16_t port);
 
+  /**
+   * Connects to `host` on given `port` in the background. The broker
+   * receives a `connection_attempt_msg` for the returned handle once
+   * the connection has been established or the attempt failed.
+   */
+  connection_handle add_tcp_scribe_async(const std::string& host,
+                                         uint16_t port);
+
   void assign_tcp_scribe(connection_handle hdl);
 
   connection_handle add_tcp_scribe(network::native_socket fd);
@@ -274,6 +315,42 @@ class broker : public extend<local_actor>::
 
   accept_handle add_tcp_doorman(network::native_socket fd);
 
+  /**
+   * Tries to connect to the Unix domain socket at `path`.
+   * @throws network_error
+   */
+  connection_handle add_unix_scribe(const std::string& path);
+
+  /**
+   * Tries to open a Unix domain socket at `path` for incoming
+   * connections. The socket file is removed once the doorman is closed.
+   * @throws bind_failure
+   * @throws network_error
+   */
+  accept_handle add_unix_doorman(const std::string& path);
+
+  /**
+   * Tries to connect to the shared memory doorman listening on the
+   * Unix domain socket at `path`.
+   * @throws network_error
+   */
+  connection_handle add_shm_scribe(const std::string& path);
+
+  /**
+   * Assigns a doorman created by `multiplexer::new_unix_doorman`
+   * to this broker, exchanging data via shared memory.
+   */
+  void assign_shm_doorman(accept_handle hdl);
+
+  /**
+   * Tries to open a Unix domain socket at `path` for incoming connections
+   * exchanging data via shared memory. The socket file is removed once
+   * the doorman is closed.
+   * @throws bind_failure
+   * @throws network_error
+   */
+  accept_handle add_shm_doorman(const std::string& path);
+
   void invoke_message(const actor_addr& sender, message_id mid, message& msg);
 
   void enqueue(const actor_addr&, message_id, message,
@@ -299,6 +376,16 @@ class broker : public extend<local_actor>::
 
   void launch(bool is_hidden, bool, execution_unit*);
 
+  /**
+   * Returns the multiplexer running this broker and all of its
+   * connections. Named brokers run on the primary backend of
+   * the middleman, all other brokers are distributed among
+   * all available backends.
+   */
+  inline network::multiplexer& backend() {
+    return *m_backend;
+  }
+
   // <backward_compatibility version="0.9">
 
   static constexpr auto at_least = receive_policy_flag::at_least;
@@ -319,6 +406,8 @@ class broker : public extend<local_actor>::
 
   broker(middleman& parent_ref);
 
+  broker(middleman& parent_ref, network::multiplexer& backend_ref);
+
   void cleanup(uint32_t reason);
 
   virtual behavior make_behavior() = 0;
@@ -329,8 +418,6 @@ class broker : public extend<local_actor>::
     return m_mm;
   }
 
-  network::multiplexer& backend();
-
  private:
   template <class Handle, class T>
   static T& by_id(Handle hdl, std::map<Handle, intrusive_ptr<T>>& elements) {
@@ -362,6 +449,7 @@ class broker : public extend<local_actor>::
   policy::sequential_invoke m_invoke_policy;
 
   middleman& m_mm;
+  network::multiplexer* m_backend;
 };
 
 class broker::functor_based : public extend<broker>::
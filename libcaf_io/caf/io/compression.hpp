@@ -0,0 +1,48 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_IO_COMPRESSION_HPP
+#define CAF_IO_COMPRESSION_HPP
+
+#include <cstddef>
+
+namespace caf {
+namespace io {
+
+/**
+ * Sets the serialized size from which on messages to remote nodes get
+ * compressed (0, i.e., no compression, by default). Two nodes negotiate
+ * compression per connection during the handshake, i.e., a connection
+ * uses compression only if both nodes enabled it. Connections to nodes
+ * on the same host, i.e., Unix domain sockets and shared memory, as well
+ * as messages passing through a node never use compression.
+ * @note Applies only to connections established after calling this function.
+ */
+void compression_threshold(size_t num_bytes);
+
+/**
+ * Queries the serialized size from which on messages get compressed.
+ */
+size_t compression_threshold();
+
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_COMPRESSION_HPP
@@ -0,0 +1,75 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_IO_FLOW_CONTROL_HPP
+#define CAF_IO_FLOW_CONTROL_HPP
+
+#include <cstddef>
+
+#include "caf/forwarding_actor_proxy.hpp"
+
+namespace caf {
+namespace io {
+
+/**
+ * Sets how many bytes of messages a node sends via a single connection
+ * before the receiver returns credit for them (0, i.e., unlimited, by
+ * default). Further messages wait in the outbound queue of the remote
+ * node until the receiver consumed enough data.
+ */
+void connection_credit(size_t num_bytes);
+
+/**
+ * Queries how many bytes of messages may be in flight per connection.
+ */
+size_t connection_credit();
+
+/**
+ * Sets how many messages to a remote actor may be in flight before its
+ * proxy reports backpressure (0, i.e., unlimited, by default). Messages
+ * count as in flight until the remote node has delivered them to the
+ * mailbox of the receiver, including the time they spend waiting for
+ * connection credit.
+ * @note Applies only to proxies created after calling this function.
+ */
+void actor_credit(size_t num_messages);
+
+/**
+ * Queries how many messages to a remote actor may be in flight.
+ */
+size_t actor_credit();
+
+/**
+ * Sets the policy for messages to a remote actor that
+ * reached its high-water mark (suspending the sender by default).
+ * @note Applies only to proxies created after calling this function.
+ */
+void on_backpressure(backpressure_policy policy);
+
+/**
+ * Queries the policy for messages to a remote actor
+ * that reached its high-water mark.
+ */
+backpressure_policy on_backpressure();
+
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_FLOW_CONTROL_HPP
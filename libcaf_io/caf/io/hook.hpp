@@ -43,7 +43,8 @@ class hook;
 using hook_uptr = std::unique_ptr<hook>;
 
 /**
- * Interface to define hooks into the IO layer.
+ * Interface to define hooks into the IO layer. While a message is received,
+ * sent, or forwarded, `trace_context::current()` returns its trace context.
  */
 class hook {
  public:
@@ -126,6 +127,30 @@ class hook {
                                            message_id mid,
                                            const message& msg);
 
+  /**
+   * Called after `message_sent_cb` with the number of bytes the
+   * serialized message occupies on the wire, i.e., after compression.
+   * The BASP broker only serializes messages for the sole purpose of
+   * this callback if at least one hook returns `true` from
+   * `needs_payload_size`. Otherwise, it calls this function
+   * only for messages it had to serialize anyway.
+   */
+  virtual void payload_sent_cb(const node_id& hop, const message& payload,
+                               size_t num_bytes);
+
+  /**
+   * Called whenever a message has arrived via the network with the number
+   * of bytes it occupied on the wire, even if its receiver is unknown.
+   */
+  virtual void payload_received_cb(const node_id& source,
+                                   const message& payload, size_t num_bytes);
+
+  /**
+   * Returns whether this hook relies on `payload_sent_cb` for each
+   * message sent to the network. The default returns `false`.
+   */
+  virtual bool needs_payload_size() const;
+
   /**
    * All possible events for IO hooks.
    */
@@ -139,7 +164,9 @@ class hook {
     new_remote_actor,
     new_connection_established,
     new_route_added,
-    invalid_message_received
+    invalid_message_received,
+    payload_sent,
+    payload_received
   };
 
   /**
@@ -180,6 +207,8 @@ class hook {
   CAF_IO_HOOK_DISPATCH(new_connection_established)
   CAF_IO_HOOK_DISPATCH(new_route_added)
   CAF_IO_HOOK_DISPATCH(invalid_message_received)
+  CAF_IO_HOOK_DISPATCH(payload_sent)
+  CAF_IO_HOOK_DISPATCH(payload_received)
 };
 
 } // namespace io
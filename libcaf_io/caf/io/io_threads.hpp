@@ -0,0 +1,51 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_IO_IO_THREADS_HPP
+#define CAF_IO_IO_THREADS_HPP
+
+#include <cstddef> // size_t
+
+namespace caf {
+namespace io {
+
+/**
+ * Sets the number of threads the middleman uses for network IO. Each
+ * thread runs its own multiplexer and new brokers are distributed among
+ * them, whereas all connections of a broker remain on the same thread.
+ * Connections to other nodes are distributed among all threads as well:
+ * each thread accepts incoming connections and connects to other nodes
+ * in turn, while messages to a node are sent by the thread that first
+ * connected to it. Hence, hooks may be invoked from any of these threads.
+ * @param num The number of multiplexer threads, at least 1.
+ * @note Must be called before the middleman is started, i.e., before
+ *       the first call to any function of the IO module.
+ */
+void io_threads(size_t num);
+
+/**
+ * Queries the number of threads the middleman uses for network IO.
+ * @returns The number of multiplexer threads.
+ */
+size_t io_threads();
+
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_IO_THREADS_HPP
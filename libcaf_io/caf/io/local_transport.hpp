@@ -0,0 +1,78 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_IO_LOCAL_TRANSPORT_HPP
+#define CAF_IO_LOCAL_TRANSPORT_HPP
+
+#include <string>
+#include <cstdint>
+
+namespace caf {
+namespace io {
+
+/**
+ * Enables or disables Unix domain sockets for connections between nodes
+ * running on the same host (enabled by default). If enabled, publishing
+ * an actor at a TCP port also opens a Unix domain socket for that port
+ * and the client switches to this socket after the handshake reveals
+ * that both nodes share the same host ID.
+ * @note Has no effect on Windows.
+ */
+void prefer_local_transport(bool value);
+
+/**
+ * Queries whether nodes on the same host connect via Unix domain sockets.
+ */
+bool prefer_local_transport();
+
+/**
+ * Returns the path of the Unix domain socket that accompanies
+ * TCP port `port` of this process. The socket resides in the
+ * directory given by the environment variable `TMPDIR` or in `/tmp`.
+ */
+std::string local_transport_path(uint16_t port);
+
+/**
+ * Enables or disables shared memory for connections between nodes on
+ * the same host (disabled by default). If enabled, the Unix domain socket
+ * that accompanies a published TCP port merely sets up a pair of ring
+ * buffers in shared memory, which then carry all BASP messages.
+ * Requires `prefer_local_transport()`.
+ * @note Has no effect on platforms other than Linux.
+ */
+void shared_memory_transport(bool value);
+
+/**
+ * Queries whether nodes on the same host connect via shared memory.
+ */
+bool shared_memory_transport();
+
+/**
+ * Returns whether `path` selects the shared memory transport, i.e.,
+ * starts with `shm:`, and removes this prefix from `path` if so.
+ * Publishing an actor at `shm:<path>` and connecting to `shm:<path>`
+ * uses the Unix domain socket `<path>` to set up shared memory.
+ */
+bool strip_shared_memory_prefix(std::string& path);
+
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_LOCAL_TRANSPORT_HPP
@@ -37,6 +37,36 @@ void max_msg_size(size_t size);
  */
 size_t max_msg_size();
 
+/**
+ * Sets the size of the fragments used for sending large messages over
+ * network (64 KiB by default). A message exceeding this size is sent in
+ * multiple fragments interleaved with other messages on the same
+ * connection, whereas a size of 0 disables fragmentation.
+ * @param size The maximum number of payload bytes per fragment.
+ */
+void fragment_size(size_t size);
+
+/**
+ * Queries the size of the fragments used for sending large messages.
+ * @returns The maximum number of payload bytes per fragment.
+ */
+size_t fragment_size();
+
+/**
+ * Sets the maximum number of bytes buffered per connection for incomplete
+ * messages received in fragments (64 MiB by default). A peer exceeding
+ * this limit or `max_msg_size()` for a single message gets disconnected.
+ * @param size The maximum number of buffered bytes per connection.
+ */
+void max_reassembly_size(size_t size);
+
+/**
+ * Queries the maximum number of bytes buffered per connection
+ * for incomplete messages received in fragments.
+ * @returns The maximum number of buffered bytes per connection.
+ */
+size_t max_reassembly_size();
+
 } // namespace io
 } // namespace caf
 
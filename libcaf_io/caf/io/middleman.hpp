@@ -21,6 +21,7 @@
 #define CAF_IO_MIDDLEMAN_HPP
 
 #include <map>
+#include <atomic>
 #include <vector>
 #include <memory>
 #include <thread>
@@ -84,16 +85,37 @@ class middleman : public detail::abstract_singleton {
    */
   template <class F>
   void run_later(F fun) {
-    m_backend->post(fun);
+    backend().post(fun);
   }
 
   /**
-   * Returns the IO backend used by this middleman.
+   * Returns the primary IO backend used by this middleman, which runs
+   * all named brokers, e.g. the BASP broker handling publish requests.
    */
   inline network::multiplexer& backend() {
-    return *m_backend;
+    return *m_backends.front();
   }
 
+  /**
+   * Returns the IO backend at position `index`.
+   */
+  inline network::multiplexer& backend(size_t index) {
+    return *m_backends[index];
+  }
+
+  /**
+   * Returns the number of IO backends, each running in its own thread.
+   */
+  inline size_t num_backends() const {
+    return m_backends.size();
+  }
+
+  /**
+   * Selects the IO backend for a new broker in a round-robin fashion.
+   * @note This member function is thread-safe.
+   */
+  network::multiplexer& next_backend();
+
   /**
    * Invokes the callback(s) associated with given event.
    */
@@ -104,6 +126,22 @@ class middleman : public detail::abstract_singleton {
     }
   }
 
+  /**
+   * Returns whether at least one hook has been added to the middleman.
+   */
+  inline bool has_hooks() const {
+    return m_hooks != nullptr;
+  }
+
+  /**
+   * Returns whether at least one hook needs the number of bytes
+   * of each message sent to the network.
+   * @see hook::needs_payload_size
+   */
+  inline bool has_payload_hooks() const {
+    return m_payload_hooks;
+  }
+
   /**
    * Adds a new hook to the middleman.
    */
@@ -114,6 +152,9 @@ class middleman : public detail::abstract_singleton {
     backend().dispatch([=] {
       ptr->next.swap(m_hooks);
       m_hooks.reset(ptr);
+      if (ptr->needs_payload_size()) {
+        m_payload_hooks = true;
+      }
     });
   }
 
@@ -133,18 +174,24 @@ class middleman : public detail::abstract_singleton {
  private:
   // guarded by singleton-getter `instance`
   middleman();
-  // networking backend
-  std::unique_ptr<network::multiplexer> m_backend;
-  // prevents backend from shutting down unless explicitly requested
-  network::multiplexer::supervisor_ptr m_backend_supervisor;
-  // runs the backend
-  std::thread m_thread;
+  // networking backends, the first one is the primary backend
+  std::vector<network::multiplexer_ptr> m_backends;
+  // prevents backends from shutting down unless explicitly requested
+  std::vector<network::multiplexer::supervisor_ptr> m_backend_supervisors;
+  // runs the backends
+  std::vector<std::thread> m_threads;
+  // position of the backend returned by the next call to next_backend()
+  std::atomic<size_t> m_next_backend;
   // keeps track of "singleton-like" brokers
   std::map<atom_value, broker_ptr> m_named_brokers;
+  // BASP brokers of all backends except the primary one
+  std::vector<broker_ptr> m_basp_shards;
   // keeps track of anonymous brokers
   std::set<broker_ptr> m_brokers;
   // user-defined hooks
   hook_uptr m_hooks;
+  // whether any hook in `m_hooks` needs payload sizes
+  bool m_payload_hooks;
   // actor offering asyncronous IO by managing this singleton instance
   middleman_actor m_manager;
 };
@@ -45,6 +45,11 @@ namespace io {
  *
  *   put_result <- (put_atom, actor_addr whom, uint16_t port);
  *
+ *   using put_local_result = either (ok_atom)
+ *                            or     (error_atom, std::string error_string);
+ *
+ *   put_local_result <- (put_atom, actor_addr whom, std::string path);
+ *
  *   using get_result = either (ok_atom, actor_addr remote_address)
  *                      or     (error_atom, std::string error_string);
  *
@@ -53,6 +58,11 @@ namespace io {
  *   get_result <- (get_atom, std::string hostname, uint16_t port,
  *                  std::set<std::string> expected_ifs);
  *
+ *   get_result <- (get_atom, std::string path);
+ *
+ *   get_result <- (get_atom, std::string path,
+ *                  std::set<std::string> expected_ifs);
+ *
  *   using delete_result = either (ok_atom)
  *                         or     (error_atom, std::string error_string);
  *
@@ -72,6 +82,12 @@ namespace io {
  *   port          | Unused TCP port or 0 for any.
  *   addr          | Optional; the IP address to listen to or INADDR_ANY
  *   reuse_addr    | Optional; enable SO_REUSEPORT option (default: false)
+ * * `PUT` with a `path` instead of a port publishes an actor
+ *   at a Unix domain socket.
+ *   Parameter     | Description
+ *   --------------|------------------------------------------------------------
+ *   whom          | Actor that should be published at path.
+ *   path          | File system path for the new socket.
  * * `GET` queries remote node and returns an `actor_addr` to the remote
  *   actor on success. This handle must be cast to either `actor` or
  *   `typed_actor` using `actor_cast`.
@@ -80,6 +96,12 @@ namespace io {
  *   hostname      | Valid hostname or IP address.
  *   port          | TCP port.
  *   expected_ifs  | Optional; Interface of typed remote actor.
+ * * `GET` with a `path` instead of hostname and port connects
+ *   to an actor published at a Unix domain socket.
+ *   Parameter     | Description
+ *   --------------|------------------------------------------------------------
+ *   path          | File system path of the socket.
+ *   expected_ifs  | Optional; Interface of typed remote actor.
  * * `DELETE` removes either all `port <-> actor` mappings for an actor or
  *   only a single one if the optional `port` parameter is set.
  *   Parameter     | Description
@@ -101,12 +123,21 @@ using middleman_actor =
     replies_to<put_atom, actor_addr, uint16_t>
     ::with_either<ok_atom, uint16_t>
     ::or_else<error_atom, std::string>,
+    replies_to<put_atom, actor_addr, std::string>
+    ::with_either<ok_atom>
+    ::or_else<error_atom, std::string>,
     replies_to<get_atom, std::string, uint16_t>
     ::with_either<ok_atom, actor_addr>
     ::or_else<error_atom, std::string>,
     replies_to<get_atom, std::string, uint16_t, std::set<std::string>>
     ::with_either<ok_atom, actor_addr>
     ::or_else<error_atom, std::string>,
+    replies_to<get_atom, std::string>
+    ::with_either<ok_atom, actor_addr>
+    ::or_else<error_atom, std::string>,
+    replies_to<get_atom, std::string, std::set<std::string>>
+    ::with_either<ok_atom, actor_addr>
+    ::or_else<error_atom, std::string>,
     replies_to<delete_atom, actor_addr>
     ::with_either<ok_atom>
     ::or_else<error_atom, std::string>,
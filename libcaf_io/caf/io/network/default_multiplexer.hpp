@@ -20,11 +20,13 @@
 #ifndef CAF_IO_NETWORK_DEFAULT_MULTIPLEXER_HPP
 #define CAF_IO_NETWORK_DEFAULT_MULTIPLEXER_HPP
 
+#include <deque>
 #include <thread>
-
+#include <memory>
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <unordered_set>
 
 #include "caf/config.hpp"
 #include "caf/extend.hpp"
@@ -43,8 +45,11 @@
 #include "caf/io/network/acceptor_manager.hpp"
 
 #include "caf/io/network/native_socket.hpp"
+#include "caf/io/network/shared_buffer.hpp"
 
 #include "caf/detail/logging.hpp"
+#include "caf/detail/shared_spinlock.hpp"
+#include "caf/detail/single_reader_queue.hpp"
 
 #ifdef CAF_WINDOWS
 #   include <w32api.h>
@@ -58,6 +63,7 @@
 #else
 #   include <unistd.h>
 #   include <errno.h>
+#   include <sys/uio.h>
 #   include <sys/socket.h>
 #endif
 
@@ -76,6 +82,7 @@
 #else
 # define CAF_EPOLL_MULTIPLEXER
 # include <sys/epoll.h>
+# include <sys/eventfd.h>
 #endif
 
 namespace caf {
@@ -85,6 +92,7 @@ namespace network {
 // annoying platform-dependent bootstrapping
 #ifdef CAF_WINDOWS
   using setsockopt_ptr = const char*;
+  using getsockopt_ptr = char*;
   using socket_send_ptr = const char*;
   using socket_recv_ptr = char*;
   using socklen_t = int;
@@ -94,8 +102,14 @@ namespace network {
   }
   constexpr int ec_out_of_memory = WSAENOBUFS;
   constexpr int ec_interrupted_syscall = WSAEINTR;
+  using io_vec = WSABUF;
+  inline void set_io_vec(io_vec& x, char* data, size_t len) {
+    x.buf = data;
+    x.len = static_cast<ULONG>(len);
+  }
 #else
   using setsockopt_ptr = const void*;
+  using getsockopt_ptr = void*;
   using socket_send_ptr = const void*;
   using socket_recv_ptr = void*;
   inline void closesocket(int fd) { close(fd); }
@@ -105,6 +119,11 @@ namespace network {
   }
   constexpr int ec_out_of_memory = ENOMEM;
   constexpr int ec_interrupted_syscall = EINTR;
+  using io_vec = iovec;
+  inline void set_io_vec(io_vec& x, char* data, size_t len) {
+    x.iov_base = data;
+    x.iov_len = len;
+  }
 #endif
 
 // poll vs epoll backend
@@ -165,6 +184,11 @@ void throw_io_failure(const char* what, bool add_errno = true);
  */
 void tcp_nodelay(native_socket fd, bool new_value);
 
+/**
+ * Returns whether `fd` is an IPv4 or IPv6 socket.
+ */
+bool is_tcp_socket(native_socket fd);
+
 /**
  * Throws `network_error` if `result` is invalid.
  */
@@ -191,6 +215,20 @@ bool read_some(size_t& result, native_socket fd, void* buf, size_t len);
  */
 bool write_some(size_t& result, native_socket fd, const void* buf, size_t len);
 
+/**
+ * Maximum number of buffers passed to a single gather-write operation.
+ */
+constexpr size_t max_io_vecs = 64;
+
+/**
+ * Writes up to `num_bufs` buffers from `bufs` to `fd` using a single
+ * gather-write operation (`sendmsg` or `WSASend`). Returns `true` as long
+ * as `fd` is writable and `false` if the socket has been closed or an IO
+ * error occured. The number of written bytes is stored in `result` (can be 0).
+ */
+bool write_some(size_t& result, native_socket fd,
+                io_vec* bufs, size_t num_bufs);
+
 /**
  * Tries to accept a new connection from `fd`. On success,
  * the new connection is stored in `result`. Returns true
@@ -200,6 +238,8 @@ bool try_accept(native_socket& result, native_socket fd);
 
 class default_multiplexer;
 
+class name_resolver;
+
 /**
  * A socket IO event handler.
  */
@@ -297,6 +337,7 @@ class default_multiplexer : public multiplexer {
 
   friend class io::middleman; // disambiguate reference
   friend class supervisor;
+  friend class default_socket;
 
  public:
 
@@ -306,18 +347,6 @@ class default_multiplexer : public multiplexer {
     event_handler* ptr;
   };
 
-  struct event_less {
-    inline bool operator()(native_socket lhs, const event& rhs) const {
-      return lhs < rhs.fd;
-    }
-    inline bool operator()(const event& lhs, native_socket rhs) const {
-      return lhs.fd < rhs;
-    }
-    inline bool operator()(const event& lhs, const event& rhs) const {
-      return lhs.fd < rhs.fd;
-    }
-  };
-
   connection_handle new_tcp_scribe(const std::string&, uint16_t) override;
 
   void assign_tcp_scribe(broker* ptr, connection_handle hdl) override;
@@ -329,6 +358,9 @@ class default_multiplexer : public multiplexer {
   connection_handle add_tcp_scribe(broker*, const std::string& h,
                                     uint16_t port) override;
 
+  connection_handle add_tcp_scribe_async(broker*, const std::string& h,
+                                         uint16_t port) override;
+
   std::pair<accept_handle, uint16_t>
   new_tcp_doorman(uint16_t p, const char* in, bool rflag) override;
 
@@ -338,9 +370,23 @@ class default_multiplexer : public multiplexer {
 
   accept_handle add_tcp_doorman(broker*, native_socket fd) override;
 
+  accept_handle new_shared_doorman(accept_handle hdl) override;
+
   std::pair<accept_handle, uint16_t>
   add_tcp_doorman(broker*, uint16_t p, const char* in, bool rflag) override;
 
+  connection_handle add_unix_scribe(broker*, const std::string& p) override;
+
+  accept_handle new_unix_doorman(const std::string& p) override;
+
+  accept_handle add_unix_doorman(broker*, const std::string& p) override;
+
+  connection_handle add_shm_scribe(broker*, const std::string& p) override;
+
+  void assign_shm_doorman(broker* ptr, accept_handle hdl) override;
+
+  accept_handle add_shm_doorman(broker*, const std::string& p) override;
+
   void dispatch_runnable(runnable_ptr ptr) override;
 
   default_multiplexer();
@@ -355,11 +401,26 @@ class default_multiplexer : public multiplexer {
 
   void del(operation op, native_socket fd, event_handler* ptr);
 
+  /**
+   * Returns whether `fd` is wrapped by a socket of this multiplexer,
+   * i.e., whether one of its brokers owns `fd`.
+   */
+  bool owns(native_socket fd) const;
+
  private:
 
   // platform-dependent additional initialization code
   void init();
 
+  // creates a doorman whose connections use TCP-like streams
+  // or shared memory streams, depending on `shared_memory`
+  accept_handle add_doorman(broker*, default_socket_acceptor&& sock,
+                            bool shared_memory);
+
+  // `accepted` is true for sockets accepted by a shared memory doorman
+  connection_handle add_shm_scribe(broker*, default_socket&& sock,
+                                   bool accepted);
+
   template <class F>
   void new_event(F fun, operation op, native_socket fd, event_handler* ptr) {
     CAF_REQUIRE(fd != invalid_native_socket);
@@ -371,9 +432,8 @@ class default_multiplexer : public multiplexer {
     CAF_LOG_TRACE(CAF_TARG(op, static_cast<int>)
              << ", " << CAF_ARG(fd) << ", " CAF_ARG(ptr)
              << ", " << CAF_ARG(old_bf));
-    auto last = m_events.end();
-    auto i = std::lower_bound(m_events.begin(), last, fd, event_less{});
-    if (i != last && i->fd == fd) {
+    auto i = pending_event(fd);
+    if (i) {
       CAF_REQUIRE(ptr == i->ptr);
       // squash events together
       CAF_LOG_DEBUG("squash events: " << i->mask << " -> "
@@ -386,7 +446,7 @@ class default_multiplexer : public multiplexer {
       } else if (i->mask == old_bf) {
         // just turned into a nop
         CAF_LOG_DEBUG("squashing events resulted in a NOP");
-        m_events.erase(i);
+        erase_pending_event(fd);
       }
     } else {
       // insert new element
@@ -395,11 +455,27 @@ class default_multiplexer : public multiplexer {
         CAF_LOG_DEBUG("event has no effect (discarded): "
                  << CAF_ARG(bf) << ", " << CAF_ARG(old_bf));
       } else {
-        m_events.insert(i, event{fd, bf, ptr});
+        add_pending_event(event{fd, bf, ptr});
       }
     }
   }
 
+  // returns the pending event for `fd` or `nullptr`
+  inline event* pending_event(native_socket fd) {
+    auto i = static_cast<size_t>(fd);
+    if (i < m_event_index.size() && m_event_index[i] > 0) {
+      return &m_events[m_event_index[i] - 1];
+    }
+    return nullptr;
+  }
+
+  void add_pending_event(const event& e);
+
+  void erase_pending_event(native_socket fd);
+
+  // applies all pending events to the pollset and clears them afterwards
+  void handle_pending_events();
+
   void handle(const event& event);
 
   bool socket_had_rd_shutdown_event(native_socket fd);
@@ -408,18 +484,39 @@ class default_multiplexer : public multiplexer {
 
   void close_pipe();
 
-  void wr_dispatch_request(runnable* ptr);
+  // wakes up the event loop after enqueueing to an empty m_dispatch_queue
+  void wr_dispatch_request();
 
-  runnable* rd_dispatch_request();
+  // consumes a wakeup signal and runs all pending runnables
+  void rd_dispatch_request();
+
+  // discards all pending runnables and rejects new ones
+  void close_dispatch_queue();
 
   native_socket m_epollfd; // unused in poll() implementation
   std::vector<multiplexer_data> m_pollset;
-  std::vector<event> m_events; // always sorted by .fd
+  std::vector<event> m_events; // pending changes, at most one per socket
+  // maps a socket to its position in m_events plus one (0 means
+  // no pending event), i.e., updating events is always O(1)
+  std::vector<size_t> m_event_index;
   multiplexer_poll_shadow_data m_shadow;
+  // read and write handle for waking up the event loop; both
+  // elements refer to the same eventfd on Linux
   std::pair<native_socket, native_socket> m_pipe;
+  // runnables from other threads, blocked while the event loop
+  // does not look at it, i.e., the next enqueue must wake it up
+  detail::single_reader_queue<runnable, detail::disposer> m_dispatch_queue;
 
   std::thread::id m_tid;
 
+  // resolves host names for add_tcp_scribe_async, started on first use
+  std::unique_ptr<name_resolver> m_resolver;
+
+  // sockets wrapped by a `default_socket` of this multiplexer, other
+  // multiplexers only read this set when assigning handles
+  mutable detail::shared_spinlock m_sockets_mtx;
+  std::unordered_set<native_socket> m_sockets;
+
 };
 
 default_multiplexer& get_multiplexer_singleton();
@@ -458,7 +555,9 @@ class stream : public event_handler {
   stream(default_multiplexer& backend_ref)
       : event_handler(backend_ref),
         m_sock(backend_ref),
-        m_writing(false) {
+        m_writing(false),
+        m_ack_writes(false),
+        m_written(0) {
     configure_read(receive_policy::at_most(1024));
   }
 
@@ -532,13 +631,42 @@ class stream : public event_handler {
     return m_wr_offline_buf;
   }
 
+  /**
+   * Appends `num_bytes` bytes of `buf` starting at `offset` to the
+   * data sent on the next write event without copying them.
+   * @note Not thread safe.
+   */
+  void write(const shared_buffer_ptr& buf, size_t offset, size_t num_bytes) {
+    CAF_LOG_TRACE(CAF_ARG(offset) << ", " << CAF_ARG(num_bytes));
+    // preserve the order of previously written data
+    if (!m_wr_offline_buf.empty()) {
+      enqueue_offline_buf();
+    }
+    m_wr_chain.emplace_back();
+    auto& x = m_wr_chain.back();
+    x.ref = buf;
+    x.offset = offset;
+    x.len = num_bytes;
+  }
+
   buffer_type& rd_buf() {
     return m_rd_buf;
   }
 
+  /**
+   * Enables or disables `data_transferred` callbacks
+   * to the manager after each write event.
+   */
+  void ack_writes(bool enable) {
+    m_ack_writes = enable;
+  }
+
   /**
    * Sends the content of the write buffer, calling the `io_failure`
-   * member function of `mgr` in case of an error.
+   * member function of `mgr` in case of an error. Flushing only registers
+   * this stream for write events, i.e., all data written to the buffer
+   * until the socket becomes writable is sent using a single syscall.
+   * Hence, calling this member function repeatedly is cheap.
    * @warning Must not be called outside the IO multiplexers event loop
    *          once the stream has been started.
    */
@@ -547,11 +675,10 @@ class stream : public event_handler {
     CAF_LOG_TRACE("offline buf size: " << m_wr_offline_buf.size()
              << ", mgr = " << mgr.get()
              << ", m_writer = " << m_writer.get());
-    if (!m_wr_offline_buf.empty() && !m_writing) {
+    if ((!m_wr_offline_buf.empty() || !m_wr_chain.empty()) && !m_writing) {
       backend().add(operation::write, m_sock.fd(), this);
       m_writer = mgr;
       m_writing = true;
-      write_loop();
     }
   }
 
@@ -581,18 +708,30 @@ class stream : public event_handler {
         break;
       }
       case operation::write: {
+        // move everything written since the last event to the chain
+        if (!m_wr_offline_buf.empty()) {
+          enqueue_offline_buf();
+        }
+        // send as many chunks as possible with a single syscall
+        io_vec vec[max_io_vecs];
+        size_t num_vecs = 0;
+        auto offset = m_written;
+        for (auto i = m_wr_chain.begin();
+             i != m_wr_chain.end() && num_vecs < max_io_vecs; ++i) {
+          set_io_vec(vec[num_vecs++], i->data() + offset, i->size() - offset);
+          offset = 0;
+        }
         size_t wb; // written bytes
-        if (!write_some(wb, m_sock.fd(),
-                m_wr_buf.data() + m_written,
-                m_wr_buf.size() - m_written)) {
+        if (!write_some(wb, m_sock.fd(), vec, num_vecs)) {
           m_writer->io_failure(operation::write);
           backend().del(operation::write, m_sock.fd(), this);
         }
         else if (wb > 0) {
-          m_written += wb;
-          if (m_written >= m_wr_buf.size()) {
-            // prepare next send (or stop sending)
-            write_loop();
+          // write_loop() may release the manager
+          auto mgr = m_writer;
+          write_loop(wb);
+          if (m_ack_writes) {
+            mgr->data_transferred(wb, pending_bytes());
           }
         }
         break;
@@ -644,19 +783,65 @@ class stream : public event_handler {
     }
   }
 
-  void write_loop() {
-    CAF_LOG_TRACE("wr_buf size: " << m_wr_buf.size()
+  // moves the content of the offline buffer to the end of the chain
+  // and replaces it with a recycled buffer
+  void enqueue_offline_buf() {
+    m_wr_chain.emplace_back();
+    m_wr_chain.back().buf.swap(m_wr_offline_buf);
+    if (!m_wr_cache.empty()) {
+      m_wr_offline_buf.swap(m_wr_cache.back());
+      m_wr_cache.pop_back();
+    }
+  }
+
+  // drops `num_bytes` sent bytes from the chain and
+  // stops writing once there is no more data to send
+  void write_loop(size_t num_bytes) {
+    CAF_LOG_TRACE(CAF_ARG(num_bytes) << ", chain size: " << m_wr_chain.size()
              << ", offline buf size: " << m_wr_offline_buf.size());
-    m_written = 0;
-    m_wr_buf.clear();
-    if (m_wr_offline_buf.empty()) {
+    m_written += num_bytes;
+    while (!m_wr_chain.empty() && m_written >= m_wr_chain.front().size()) {
+      auto& x = m_wr_chain.front();
+      m_written -= x.size();
+      if (!x.ref && m_wr_cache.size() < max_cached_buffers) {
+        m_wr_cache.push_back(std::move(x.buf));
+        m_wr_cache.back().clear();
+      }
+      m_wr_chain.pop_front();
+    }
+    if (m_wr_chain.empty() && m_wr_offline_buf.empty()) {
       m_writing = false;
       backend().del(operation::write, m_sock.fd(), this);
-    } else {
-      m_wr_buf.swap(m_wr_offline_buf);
     }
   }
 
+  // returns the number of bytes not written to the socket yet
+  size_t pending_bytes() const {
+    auto result = m_wr_offline_buf.size();
+    for (auto& x : m_wr_chain) {
+      result += x.size();
+    }
+    return result - m_written;
+  }
+
+  // maximum number of sent buffers we keep for later re-use
+  static constexpr size_t max_cached_buffers = 4;
+
+  // an element of the write chain, either owning its bytes
+  // or referring to a part of a shared buffer
+  struct chunk {
+    buffer_type buf;
+    shared_buffer_ptr ref;
+    size_t offset;
+    size_t len;
+    inline char* data() {
+      return ref ? ref->data() + offset : buf.data();
+    }
+    inline size_t size() const {
+      return ref ? len : buf.size();
+    }
+  };
+
   // reading & writing
   Socket        m_sock;
   // reading
@@ -669,8 +854,10 @@ class stream : public event_handler {
   // writing
   manager_ptr     m_writer;
   bool        m_writing;
-  size_t        m_written;
-  buffer_type     m_wr_buf;
+  bool        m_ack_writes;
+  size_t        m_written; // sent bytes of m_wr_chain.front()
+  std::deque<chunk> m_wr_chain;
+  std::vector<buffer_type> m_wr_cache;
   buffer_type     m_wr_offline_buf;
 };
 
@@ -796,6 +983,27 @@ std::pair<default_socket_acceptor, uint16_t>
 new_ipv4_acceptor(uint16_t port, const char* addr = nullptr,
                   bool reuse_addr = false);
 
+/**
+ * Connects to the Unix domain socket at `path`.
+ * @throws network_error
+ */
+native_socket new_unix_connection_impl(const std::string& path);
+
+/**
+ * Creates a Unix domain socket listening at `path`. Replaces socket
+ * files left behind by terminated processes, i.e., socket files that
+ * refuse all connection attempts.
+ * @throws bind_failure
+ * @throws network_error
+ */
+native_socket new_unix_acceptor_impl(const std::string& path);
+
+/**
+ * Removes the socket file of the Unix domain socket acceptor `fd`.
+ * Does nothing if `fd` is not bound to a path in the file system.
+ */
+void remove_unix_socket_file(native_socket fd);
+
 template <class SocketAcceptor>
 uint16_t ipv4_bind(SocketAcceptor& sock,
          uint16_t port,
@@ -0,0 +1,84 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_IO_NETWORK_LZ_CODEC_HPP
+#define CAF_IO_NETWORK_LZ_CODEC_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace caf {
+namespace io {
+namespace network {
+
+/**
+ * A fast LZ77 compressor in the spirit of LZ4, trading compression ratio
+ * for speed. The compressed form starts with the size of the original
+ * data as 32-bit little-endian integer, followed by a series of sequences.
+ * Each sequence consists of a token, literals, and a back-reference into
+ * the previously decompressed data. The upper four bits of the token store
+ * the number of literals and the lower four bits the length of the match
+ * minus `min_match`, whereas a value of 15 means that additional bytes
+ * follow, each adding up to 255. The offset of a match is a 16-bit
+ * little-endian integer. The last sequence consists of literals only.
+ */
+class lz_codec {
+ public:
+  using buffer_type = std::vector<char>;
+
+  /**
+   * Minimum length of a back-reference.
+   */
+  static constexpr size_t min_match = 4;
+
+  /**
+   * Maximum distance of a back-reference.
+   */
+  static constexpr size_t max_offset = 65535;
+
+  lz_codec();
+
+  /**
+   * Appends the compressed form of `size` bytes starting
+   * at `data` to `out`. Reuses its hash table between calls.
+   */
+  void compress(const char* data, size_t size, buffer_type& out);
+
+  /**
+   * Appends the original data of `size` compressed bytes starting at
+   * `data` to `out`, returns `false` if the input is malformed or if the
+   * original data would exceed `max_size` bytes.
+   */
+  static bool decompress(const char* data, size_t size, buffer_type& out,
+                         size_t max_size = 0xFFFFFFFF);
+
+ private:
+  static constexpr size_t table_bits = 12;
+
+  // position + 1 of the last occurrence of each hashed 4-byte sequence
+  std::vector<uint32_t> m_table;
+};
+
+} // namespace network
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_NETWORK_LZ_CODEC_HPP
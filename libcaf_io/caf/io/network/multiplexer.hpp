@@ -64,7 +64,9 @@ class multiplexer {
                                            uint16_t port) = 0;
 
   /**
-   * Assigns an unbound scribe identified by `hdl` to `ptr`.
+   * Assigns an unbound scribe identified by `hdl` to `ptr`. The scribe moves
+   * to this multiplexer unless a broker of another multiplexer owns it.
+   * @throws network_error if `hdl` is registered at another multiplexer
    * @warning Do not call from outside the multiplexer's event loop.
    */
   virtual void assign_tcp_scribe(broker* ptr, connection_handle hdl) = 0;
@@ -83,6 +85,17 @@ class multiplexer {
   virtual connection_handle add_tcp_scribe(broker* ptr, const std::string& host,
                                            uint16_t port) = 0;
 
+  /**
+   * Starts connecting to `host` on given `port` without blocking the event
+   * loop and returns the handle for the new connection immediately. Host
+   * names are resolved on a helper thread. `ptr` receives a
+   * `connection_attempt_msg` once the attempt succeeded or failed.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual connection_handle add_tcp_scribe_async(broker* ptr,
+                                                 const std::string& host,
+                                                 uint16_t port) = 0;
+
   /**
    * Tries to create an unbound TCP doorman running `port`, optionally
    * accepting only connections from IP address `in`.
@@ -93,7 +106,9 @@ class multiplexer {
                   bool reuse_addr = false) = 0;
 
   /**
-   * Assigns an unbound doorman identified by `hdl` to `ptr`.
+   * Assigns an unbound doorman identified by `hdl` to `ptr`. The doorman moves
+   * to this multiplexer unless a broker of another multiplexer owns it.
+   * @throws network_error if `hdl` is registered at another multiplexer
    * @warning Do not call from outside the multiplexer's event loop.
    */
   virtual void assign_tcp_doorman(broker* ptr, accept_handle hdl) = 0;
@@ -104,6 +119,14 @@ class multiplexer {
    */
   virtual accept_handle add_tcp_doorman(broker* ptr, native_socket fd) = 0;
 
+  /**
+   * Returns an unbound doorman for the socket of `hdl`, allowing brokers
+   * of several multiplexers to accept connections on the same socket.
+   * @throws network_error if the socket cannot be shared
+   * @threadsafe
+   */
+  virtual accept_handle new_shared_doorman(accept_handle hdl) = 0;
+
   /**
    * Tries to create a new TCP doorman running on port `p`, optionally
    * accepting only connections from IP address `in`.
@@ -113,10 +136,61 @@ class multiplexer {
   add_tcp_doorman(broker* ptr, uint16_t port, const char* in = nullptr,
                   bool reuse_addr = false) = 0;
 
+  /**
+   * Tries to connect to the Unix domain socket at `path` and returns a
+   * new scribe managing the connection on success.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual connection_handle add_unix_scribe(broker* ptr,
+                                            const std::string& path) = 0;
+
+  /**
+   * Tries to create an unbound doorman listening on a Unix domain
+   * socket at `path`. The socket file is removed once the doorman
+   * has been closed. Use `assign_tcp_doorman` to bind it to a broker.
+   * @threadsafe
+   */
+  virtual accept_handle new_unix_doorman(const std::string& path) = 0;
+
+  /**
+   * Tries to create a new doorman listening on a Unix domain socket
+   * at `path`. The socket file is removed once the doorman has been closed.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual accept_handle add_unix_doorman(broker* ptr,
+                                         const std::string& path) = 0;
+
+  /**
+   * Tries to connect to the shared memory doorman listening on the Unix
+   * domain socket at `path` and returns a new scribe exchanging data with
+   * the peer via shared memory on success.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual connection_handle add_shm_scribe(broker* ptr,
+                                           const std::string& path) = 0;
+
+  /**
+   * Assigns an unbound doorman identified by `hdl`, as created by
+   * `new_unix_doorman`, to `ptr`. Connections accepted by this doorman
+   * exchange data via shared memory.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual void assign_shm_doorman(broker* ptr, accept_handle hdl) = 0;
+
+  /**
+   * Tries to create a new doorman listening on a Unix domain socket at
+   * `path`. Connections accepted by this doorman exchange data via
+   * shared memory. The socket file is removed once the doorman is closed.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual accept_handle add_shm_doorman(broker* ptr,
+                                        const std::string& path) = 0;
+
   /**
    * Simple wrapper for runnables
    */
   struct runnable : extend<memory_managed>::with<mixin::memory_cached> {
+    runnable* next = nullptr; // intrusive next pointer
     virtual void run() = 0;
     virtual ~runnable();
   };
@@ -0,0 +1,74 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_IO_NETWORK_SHARED_BUFFER_HPP
+#define CAF_IO_NETWORK_SHARED_BUFFER_HPP
+
+#include <vector>
+#include <cstddef>
+
+#include "caf/ref_counted.hpp"
+#include "caf/intrusive_ptr.hpp"
+
+namespace caf {
+namespace io {
+namespace network {
+
+/**
+ * A reference-counted byte buffer, allowing streams to send
+ * (parts of) received data without copying it.
+ * @warning The content must not change once the buffer is shared.
+ */
+class shared_buffer : public ref_counted {
+ public:
+  using buffer_type = std::vector<char>;
+
+  shared_buffer() = default;
+
+  explicit shared_buffer(buffer_type&& buf) : m_buf(std::move(buf)) {
+    // nop
+  }
+
+  inline buffer_type& buf() {
+    return m_buf;
+  }
+
+  inline char* data() {
+    return m_buf.data();
+  }
+
+  inline size_t size() const {
+    return m_buf.size();
+  }
+
+ private:
+  buffer_type m_buf;
+};
+
+/**
+ * @relates shared_buffer
+ */
+using shared_buffer_ptr = intrusive_ptr<shared_buffer>;
+
+} // namespace network
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_NETWORK_SHARED_BUFFER_HPP
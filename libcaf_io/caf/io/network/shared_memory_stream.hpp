@@ -0,0 +1,195 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_IO_NETWORK_SHARED_MEMORY_STREAM_HPP
+#define CAF_IO_NETWORK_SHARED_MEMORY_STREAM_HPP
+
+#include <vector>
+#include <cstddef>
+
+#include "caf/config.hpp"
+
+#include "caf/io/receive_policy.hpp"
+#include "caf/io/network/spsc_ring.hpp"
+#include "caf/io/network/stream_manager.hpp"
+#include "caf/io/network/default_multiplexer.hpp"
+
+namespace caf {
+namespace io {
+namespace network {
+
+/**
+ * A stream exchanging data with a process on the same host via a pair
+ * of {@link spsc_ring rings} in shared memory. A Unix domain socket
+ * serves as control channel: it passes the shared memory segment to the
+ * connecting side, signals termination of the peer and wakes up the peer
+ * if it waits for data. Busy connections thus transfer data without any
+ * syscall. The input data is forwarded to the stream's manager.
+ * @note Available on Linux only.
+ */
+class shared_memory_stream : public event_handler {
+ public:
+  /**
+   * A smart pointer to a stream manager.
+   */
+  using manager_ptr = intrusive_ptr<stream_manager>;
+
+  using buffer_type = std::vector<char>;
+
+  /**
+   * Number of bytes each ring buffer can hold.
+   */
+  static constexpr size_t ring_capacity = 1024 * 1024;
+
+  shared_memory_stream(default_multiplexer& backend_ref);
+
+  ~shared_memory_stream();
+
+  /**
+   * Returns the `multiplexer` this stream belongs to.
+   */
+  inline default_multiplexer& backend() {
+    return static_cast<default_multiplexer&>(m_sock.backend());
+  }
+
+  /**
+   * Returns the control socket.
+   */
+  inline default_socket& socket_handle() {
+    return m_sock;
+  }
+
+  /**
+   * Initializes this stream for an accepted control socket, i.e.,
+   * creates the shared memory segment and passes it to the peer.
+   * @throws network_error
+   */
+  void init_as_server(default_socket sock);
+
+  /**
+   * Initializes this stream for a connected control socket. Written data
+   * remains buffered until the peer passed the shared memory segment.
+   */
+  void init_as_client(default_socket sock);
+
+  /**
+   * Starts reading data, forwarding incoming data to `mgr`.
+   */
+  void start(const manager_ptr& mgr);
+
+  void removed_from_loop(operation op) override;
+
+  /**
+   * Configures how much data will be provided
+   * for the next `consume` callback.
+   */
+  void configure_read(receive_policy::config config);
+
+  /**
+   * Returns the write buffer of this stream.
+   */
+  inline buffer_type& wr_buf() {
+    return m_wr_buf;
+  }
+
+  inline buffer_type& rd_buf() {
+    return m_rd_buf;
+  }
+
+  /**
+   * Copies the content of the write buffer to the outbound ring and
+   * wakes up the peer if it waits for data. Data that does not fit into
+   * the ring remains buffered until the peer consumed enough data.
+   */
+  void flush(const manager_ptr& mgr);
+
+  /**
+   * Enables or disables `data_transferred` callbacks to the
+   * manager after writing data to the outbound ring.
+   */
+  void ack_writes(bool enable);
+
+  void stop_reading();
+
+  void handle_event(operation op) override;
+
+ protected:
+  native_socket fd() const override {
+    return m_sock.fd();
+  }
+
+ private:
+  // maps the segment `memfd` and attaches the rings to it
+  void map_segment(native_socket memfd, size_t capacity, bool is_server);
+
+  // receives the shared memory segment from the peer, returns
+  // false if the control socket has been closed or is invalid
+  bool receive_segment();
+
+  // moves data between the rings and the buffers until either
+  // side runs out of work or this stream processed a full batch
+  void process();
+
+  // returns true if at least one byte has been written to the ring
+  bool send_data();
+
+  // returns true if at least one byte has been read from the ring
+  bool receive_data();
+
+  // notifies the writer about sent data from the event loop, i.e.,
+  // never while the writer is calling `flush`
+  void schedule_ack();
+
+  void read_loop();
+
+  // wakes up the peer via the control socket
+  void ring_doorbell();
+
+  // reports an IO failure and stops reading from the control socket
+  void fail();
+
+  default_socket m_sock;
+  void* m_segment;
+  size_t m_segment_size;
+  spsc_ring m_in;
+  spsc_ring m_out;
+  // reading
+  manager_ptr m_reader;
+  bool m_reading;
+  size_t m_threshold;
+  size_t m_collected;
+  size_t m_max;
+  receive_policy_flag m_rd_flag;
+  buffer_type m_rd_buf;
+  // writing
+  manager_ptr m_writer;
+  buffer_type m_wr_buf;
+  buffer_type m_wr_pending; // data that did not fit into the ring
+  size_t m_wr_pos;          // sent bytes of m_wr_pending
+  bool m_ack_writes;
+  bool m_ack_scheduled;
+  size_t m_unacked;         // sent bytes not reported to the writer yet
+};
+
+} // namespace network
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_NETWORK_SHARED_MEMORY_STREAM_HPP
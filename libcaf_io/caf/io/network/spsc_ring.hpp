@@ -0,0 +1,229 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_IO_NETWORK_SPSC_RING_HPP
+#define CAF_IO_NETWORK_SPSC_RING_HPP
+
+#include <new>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+namespace caf {
+namespace io {
+namespace network {
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "shared memory rings require lock-free atomics");
+
+/**
+ * A single-producer, single-consumer byte ring residing in memory
+ * shared between two processes. The ring itself never blocks; both
+ * sides announce via the waiting flags that they went idle and expect
+ * the other side to wake them up once there is something to do.
+ */
+class spsc_ring {
+ public:
+  static constexpr size_t cache_line_size = 64;
+
+  /**
+   * The control block placed in front of the ring's data.
+   */
+  struct header {
+    // number of bytes written so far, modified by the producer only
+    std::atomic<uint64_t> head;
+    char pad1[cache_line_size - sizeof(std::atomic<uint64_t>)];
+    // number of bytes read so far, modified by the consumer only
+    std::atomic<uint64_t> tail;
+    char pad2[cache_line_size - sizeof(std::atomic<uint64_t>)];
+    // set by an idle consumer waiting for a wakeup from the producer
+    std::atomic<uint32_t> consumer_waiting;
+    // set by a producer waiting for the consumer to free up space
+    std::atomic<uint32_t> producer_waiting;
+    char pad3[cache_line_size - 2 * sizeof(std::atomic<uint32_t>)];
+  };
+
+  static_assert(sizeof(header) == 3 * cache_line_size,
+                "unexpected padding in spsc_ring::header");
+
+  /**
+   * Returns the number of bytes required for a ring with `capacity` bytes.
+   */
+  static constexpr size_t required_size(size_t capacity) {
+    return sizeof(header) + capacity;
+  }
+
+  spsc_ring() : m_hdr(nullptr), m_data(nullptr), m_mask(0) {
+    // nop
+  }
+
+  /**
+   * Attaches this ring to `mem`, which must be suitably aligned
+   * and provide `required_size(capacity)` bytes. The capacity
+   * must be a power of two.
+   */
+  void attach(void* mem, size_t capacity) {
+    m_hdr = reinterpret_cast<header*>(mem);
+    m_data = reinterpret_cast<char*>(mem) + sizeof(header);
+    m_mask = capacity - 1;
+  }
+
+  /**
+   * Initializes the control block of a freshly created ring at `mem`.
+   */
+  static void init(void* mem) {
+    auto hdr = new (mem) header;
+    hdr->head = 0;
+    hdr->tail = 0;
+    hdr->consumer_waiting = 0;
+    hdr->producer_waiting = 0;
+  }
+
+  inline bool attached() const {
+    return m_hdr != nullptr;
+  }
+
+  inline size_t capacity() const {
+    return m_mask + 1;
+  }
+
+  /**
+   * Returns the number of bytes available to the consumer.
+   * The result exceeds `capacity()` only if the peer corrupted the ring.
+   */
+  inline uint64_t readable() const {
+    return m_hdr->head.load() - m_hdr->tail.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns whether the peer left the ring in an inconsistent state.
+   */
+  inline bool corrupted() const {
+    return m_hdr->head.load() - m_hdr->tail.load() > capacity();
+  }
+
+  /**
+   * Copies up to `len` bytes from `buf` into the ring
+   * and returns the number of copied bytes.
+   * @warning Must be called by the producer only.
+   */
+  size_t write(const char* buf, size_t len) {
+    auto head = m_hdr->head.load(std::memory_order_relaxed);
+    auto used = head - m_hdr->tail.load(std::memory_order_acquire);
+    if (used >= capacity()) {
+      return 0;
+    }
+    auto n = std::min<size_t>(len, capacity() - used);
+    auto pos = static_cast<size_t>(head) & m_mask;
+    auto first_chunk = std::min(n, capacity() - pos);
+    memcpy(m_data + pos, buf, first_chunk);
+    memcpy(m_data, buf + first_chunk, n - first_chunk);
+    // sequentially consistent to order this store before
+    // reading `consumer_waiting` in `wake_consumer`
+    m_hdr->head.store(head + n);
+    return n;
+  }
+
+  /**
+   * Copies up to `len` bytes from the ring into `buf`
+   * and returns the number of copied bytes.
+   * @warning Must be called by the consumer only.
+   */
+  size_t read(char* buf, size_t len) {
+    auto tail = m_hdr->tail.load(std::memory_order_relaxed);
+    auto avail = m_hdr->head.load(std::memory_order_acquire) - tail;
+    if (avail == 0 || avail > capacity()) {
+      return 0;
+    }
+    auto n = std::min<size_t>(len, avail);
+    auto pos = static_cast<size_t>(tail) & m_mask;
+    auto first_chunk = std::min(n, capacity() - pos);
+    memcpy(buf, m_data + pos, first_chunk);
+    memcpy(buf + first_chunk, m_data, n - first_chunk);
+    m_hdr->tail.store(tail + n);
+    return n;
+  }
+
+  /**
+   * Announces that the consumer goes idle. Returns `false` if
+   * data arrived in the meantime, i.e., if the consumer must
+   * keep reading instead of waiting for a wakeup.
+   */
+  bool consumer_sleep() {
+    m_hdr->consumer_waiting.store(1);
+    if (readable() > 0) {
+      m_hdr->consumer_waiting.store(0);
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * Announces that the consumer is awake.
+   */
+  inline void consumer_awake() {
+    m_hdr->consumer_waiting.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * Announces that the producer waits for free space. Returns
+   * `false` if the consumer made room in the meantime.
+   */
+  bool producer_sleep() {
+    m_hdr->producer_waiting.store(1);
+    if (m_hdr->head.load(std::memory_order_relaxed) - m_hdr->tail.load()
+        < capacity()) {
+      m_hdr->producer_waiting.store(0);
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * Returns whether the producer must wake up the consumer
+   * after writing to the ring, resetting the flag.
+   */
+  inline bool wake_consumer() {
+    return m_hdr->consumer_waiting.load() != 0
+           && m_hdr->consumer_waiting.exchange(0) != 0;
+  }
+
+  /**
+   * Returns whether the consumer must wake up the producer
+   * after reading from the ring, resetting the flag.
+   */
+  inline bool wake_producer() {
+    return m_hdr->producer_waiting.load() != 0
+           && m_hdr->producer_waiting.exchange(0) != 0;
+  }
+
+ private:
+  header* m_hdr;
+  char* m_data;
+  size_t m_mask;
+};
+
+} // namespace network
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_NETWORK_SPSC_RING_HPP
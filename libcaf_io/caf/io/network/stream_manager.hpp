@@ -43,6 +43,15 @@ class stream_manager : public manager {
    */
   virtual void consume(const void* data, size_t num_bytes) = 0;
 
+  /**
+   * Called by the underlying IO device after writing data to the network
+   * if write notifications have been enabled. The default implementation
+   * does nothing.
+   * @param num_bytes Number of bytes written since the last notification.
+   * @param remaining Number of bytes still waiting in the write buffers.
+   */
+  virtual void data_transferred(size_t num_bytes, size_t remaining);
+
 };
 
 } // namespace network
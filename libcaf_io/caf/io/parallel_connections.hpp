@@ -0,0 +1,64 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_IO_PARALLEL_CONNECTIONS_HPP
+#define CAF_IO_PARALLEL_CONNECTIONS_HPP
+
+#include <cstddef>
+
+namespace caf {
+namespace io {
+
+/**
+ * Sets the number of connections `remote_actor` opens to a node (1 by
+ * default). The first connection carries the handshake and all control
+ * messages, while messages between actors are striped across all
+ * connections by their pair of source and destination actor. Hence,
+ * messages between two actors never overtake each other, but a large
+ * message only delays messages that share its connection.
+ * @note Termination of remote actors is reported via the first
+ *       connection and may thus overtake messages on other connections.
+ */
+void connections_per_peer(size_t num);
+
+/**
+ * Queries how many connections `remote_actor` opens to a node.
+ */
+size_t connections_per_peer();
+
+/**
+ * Sets the size in bytes from which on messages to a node travel via a
+ * dedicated bulk connection instead (0, i.e., disabled, by default).
+ * If enabled, `remote_actor` opens the bulk connection in addition to
+ * the connections configured via `connections_per_peer`.
+ * @note Messages sent via the bulk connection may overtake smaller
+ *       messages between the same actors and vice versa.
+ */
+void bulk_connection_threshold(size_t num_bytes);
+
+/**
+ * Queries the size from which on messages travel via the bulk connection.
+ */
+size_t bulk_connection_threshold();
+
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_PARALLEL_CONNECTIONS_HPP
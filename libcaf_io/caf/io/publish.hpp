@@ -20,6 +20,7 @@
 #ifndef CAF_IO_PUBLISH_HPP
 #define CAF_IO_PUBLISH_HPP
 
+#include <string>
 #include <cstdint>
 
 #include "caf/actor.hpp"
@@ -32,6 +33,8 @@ namespace io {
 uint16_t publish_impl(abstract_actor_ptr whom, uint16_t port,
                       const char* in, bool reuse_addr);
 
+void publish_impl(abstract_actor_ptr whom, const std::string& path);
+
 /**
  * Publishes `whom` at `port`. The connection is managed by the middleman.
  * @param whom Actor that should be published at `port`.
@@ -50,6 +53,23 @@ inline uint16_t publish(caf::actor whom, uint16_t port,
                       reuse_addr);
 }
 
+/**
+ * Publishes `whom` at the Unix domain socket `path`, allowing
+ * other processes on the same host to connect via `remote_actor(path)`.
+ * The socket file is removed once `whom` has been unpublished.
+ * Prefixing `path` with `shm:` lets clients exchange messages
+ * with `whom` via shared memory (Linux only).
+ * @param whom Actor that should be published at `path`.
+ * @param path File system path for the new socket.
+ * @throws bind_failure
+ * @throws network_error
+ */
+inline void publish(caf::actor whom, const std::string& path) {
+  if (whom) {
+    publish_impl(actor_cast<abstract_actor_ptr>(whom), path);
+  }
+}
+
 /**
  * @copydoc publish(actor,uint16_t,const char*)
  */
@@ -63,6 +83,16 @@ uint16_t typed_publish(typed_actor<Rs...> whom, uint16_t port,
                       reuse_addr);
 }
 
+/**
+ * @copydoc publish(actor,const std::string&)
+ */
+template <class... Rs>
+void typed_publish(typed_actor<Rs...> whom, const std::string& path) {
+  if (whom) {
+    publish_impl(actor_cast<abstract_actor_ptr>(whom), path);
+  }
+}
+
 } // namespace io
 } // namespace caf
 
@@ -34,6 +34,9 @@ namespace io {
 abstract_actor_ptr remote_actor_impl(std::set<std::string> ifs,
                                      const std::string& host, uint16_t port);
 
+abstract_actor_ptr remote_actor_impl(std::set<std::string> ifs,
+                                     const std::string& path);
+
 template <class List>
 struct typed_remote_actor_helper;
 
@@ -61,6 +64,20 @@ inline actor remote_actor(const std::string& host, uint16_t port) {
   return actor_cast<actor>(res);
 }
 
+/**
+ * Establish a new connection to the actor published at
+ * the Unix domain socket `path`. Paths starting with `shm:`
+ * connect via shared memory (see `publish`).
+ * @param path File system path of the socket.
+ * @returns An {@link actor_ptr} to the proxy instance
+ *          representing a remote actor.
+ * @throws network_error Thrown when the socket is not available.
+ */
+inline actor remote_actor(const std::string& path) {
+  auto res = remote_actor_impl(std::set<std::string>{}, path);
+  return actor_cast<actor>(res);
+}
+
 /**
  * Establish a new connection to the typed actor at `host` on given `port`.
  * @param host Valid hostname or IP address.
@@ -76,6 +93,21 @@ typed_remote_actor(const std::string& host, uint16_t port) {
   return f(host, port);
 }
 
+/**
+ * Establish a new connection to the typed actor
+ * published at the Unix domain socket `path`.
+ * @param path File system path of the socket.
+ * @returns An {@link actor_ptr} to the proxy instance
+ *          representing a typed remote actor.
+ * @throws network_error Thrown when the socket is not available.
+ */
+template <class List>
+typename typed_remote_actor_helper<List>::return_type
+typed_remote_actor(const std::string& path) {
+  typed_remote_actor_helper<List> f;
+  return f(path);
+}
+
 } // namespace io
 } // namespace caf
 
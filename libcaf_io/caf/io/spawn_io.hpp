@@ -66,8 +66,7 @@ actor spawn_io_client(F fun, const std::string& host,
   return spawn_class<broker::functor_based>(
         nullptr,
         [&](broker::functor_based* ptr) {
-          auto mm = middleman::instance();
-          auto hdl = mm->backend().add_tcp_scribe(ptr, host, port);
+          auto hdl = ptr->backend().add_tcp_scribe(ptr, host, port);
           init(ptr, fun, hdl);
         });
 }
@@ -86,8 +85,7 @@ actor spawn_io_server(F fun, uint16_t port, Ts&&... args) {
   return spawn_class<broker::functor_based>(
         nullptr,
         [&](broker::functor_based* ptr) {
-          auto mm = middleman::instance();
-          mm->backend().add_tcp_doorman(ptr, port);
+          ptr->backend().add_tcp_doorman(ptr, port);
           init(ptr, std::move(fun));
         });
 }
@@ -20,6 +20,9 @@
 #ifndef CAF_IO_SYSTEM_MESSAGES_HPP
 #define CAF_IO_SYSTEM_MESSAGES_HPP
 
+#include <string>
+#include <cstdint>
+
 #include "caf/io/handle.hpp"
 #include "caf/io/accept_handle.hpp"
 #include "caf/io/connection_handle.hpp"
@@ -137,6 +140,79 @@ inline bool operator!=(const acceptor_closed_msg& lhs,
   return !(lhs == rhs);
 }
 
+/**
+ * Signalizes the outcome of a connection attempt started
+ * with {@link broker::add_tcp_scribe_async}.
+ */
+struct connection_attempt_msg {
+  /**
+   * Handle to the new connection, which is only
+   * usable by the broker if `success == true`.
+   */
+  connection_handle handle;
+  /**
+   * Denotes whether the connection has been established.
+   */
+  bool success;
+  /**
+   * Describes why the connection attempt failed.
+   */
+  std::string reason;
+};
+
+/**
+ * @relates connection_attempt_msg
+ */
+inline bool operator==(const connection_attempt_msg& lhs,
+                       const connection_attempt_msg& rhs) {
+  return lhs.handle == rhs.handle && lhs.success == rhs.success
+         && lhs.reason == rhs.reason;
+}
+
+/**
+ * @relates connection_attempt_msg
+ */
+inline bool operator!=(const connection_attempt_msg& lhs,
+                       const connection_attempt_msg& rhs) {
+  return !(lhs == rhs);
+}
+
+/**
+ * Signalizes that a {@link broker} connection has written data
+ * to the network, sent only after calling {@link broker::ack_writes}.
+ */
+struct data_transferred_msg {
+  /**
+   * Handle to the related connection.
+   */
+  connection_handle handle;
+  /**
+   * Number of bytes written since the last notification.
+   */
+  uint64_t written;
+  /**
+   * Number of bytes still waiting in the write buffers.
+   */
+  uint64_t remaining;
+};
+
+/**
+ * @relates data_transferred_msg
+ */
+inline bool operator==(const data_transferred_msg& lhs,
+                       const data_transferred_msg& rhs) {
+  return lhs.handle == rhs.handle && lhs.written == rhs.written
+         && lhs.remaining == rhs.remaining;
+}
+
+/**
+ * @relates data_transferred_msg
+ */
+inline bool operator!=(const data_transferred_msg& lhs,
+                       const data_transferred_msg& rhs) {
+  return !(lhs == rhs);
+}
+
 } // namespace io
 } // namespace caf
 
@@ -0,0 +1,132 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_IO_TRACE_RECORDER_HPP
+#define CAF_IO_TRACE_RECORDER_HPP
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "caf/node_id.hpp"
+#include "caf/trace_context.hpp"
+
+#include "caf/io/hook.hpp"
+
+namespace caf {
+namespace io {
+
+/**
+ * A single hop of a sampled message as seen by one node.
+ */
+struct trace_event {
+  enum kind_type : uint8_t {
+    /**
+     * The message has been sent to `node`.
+     */
+    sent,
+    /**
+     * The message has been received from `node`.
+     */
+    received,
+    /**
+     * The message from `node` has been forwarded to another node.
+     */
+    forwarded
+  };
+  kind_type kind;
+  /**
+   * Trace context of the message during this hop.
+   */
+  trace_context context;
+  /**
+   * The next hop for sent messages, the original sender otherwise.
+   */
+  node_id node;
+  /**
+   * Nanoseconds since the epoch of the system clock.
+   */
+  uint64_t timestamp;
+};
+
+/**
+ * Stores the most recent trace events of a node.
+ * Member functions are thread-safe.
+ */
+class trace_log {
+ public:
+  /**
+   * Creates a log that drops the oldest event when
+   * exceeding `max_events` recorded events.
+   */
+  explicit trace_log(size_t max_events = 4096);
+
+  void append(trace_event event);
+
+  /**
+   * Returns all events recorded so far in chronological order.
+   */
+  std::vector<trace_event> events() const;
+
+  /**
+   * Returns the number of events dropped because the log was full.
+   */
+  size_t dropped() const;
+
+  void clear();
+
+ private:
+  mutable std::mutex m_mtx;
+  size_t m_max_events;
+  size_t m_dropped;
+  std::deque<trace_event> m_events;
+};
+
+/**
+ * A hook that records each hop of a sampled message to a {@link trace_log}.
+ * Install it via `middleman::instance()->add_hook<trace_recorder>(log)`.
+ * Messages that do not belong to a sampled trace pass through unrecorded.
+ */
+class trace_recorder : public hook {
+ public:
+  explicit trace_recorder(std::shared_ptr<trace_log> log);
+
+  void message_received_cb(const node_id& source, const actor_addr& from,
+                           const actor_addr& dest, message_id mid,
+                           const message& msg) override;
+
+  void message_sent_cb(const actor_addr& from, const node_id& hop,
+                       const actor_addr& dest, message_id mid,
+                       const message& payload) override;
+
+  void message_forwarded_cb(const node_id& from, const node_id& dest,
+                            const std::vector<char>* payload) override;
+
+ private:
+  void record(trace_event::kind_type kind, const node_id& node);
+
+  std::shared_ptr<trace_log> m_log;
+};
+
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_TRACE_RECORDER_HPP
@@ -0,0 +1,177 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_IO_TRAFFIC_METRICS_HPP
+#define CAF_IO_TRAFFIC_METRICS_HPP
+
+#include <map>
+#include <array>
+#include <tuple>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "caf/atom.hpp"
+#include "caf/actor.hpp"
+#include "caf/message.hpp"
+#include "caf/node_id.hpp"
+
+#include "caf/io/hook.hpp"
+
+#include "caf/detail/shared_spinlock.hpp"
+
+namespace caf {
+namespace io {
+
+/**
+ * Counts messages and bytes exchanged with remote nodes, once per peer
+ * node and once per message type. Recording a message increments
+ * atomic counters and only locks when seeing a node or type for the
+ * first time, i.e., the counters never block each other or snapshots.
+ */
+class traffic_metrics {
+ public:
+  /**
+   * Position of a counter in each row of a snapshot, following the key.
+   */
+  enum counter_index {
+    messages_sent,
+    bytes_sent,
+    messages_received,
+    bytes_received,
+    messages_forwarded,
+    bytes_forwarded,
+    failures,
+    num_counters
+  };
+
+  traffic_metrics() = default;
+
+  traffic_metrics(const traffic_metrics&) = delete;
+
+  traffic_metrics& operator=(const traffic_metrics&) = delete;
+
+  void sent(const node_id& hop, const message& msg, size_t num_bytes);
+
+  void received(const node_id& source, const message& msg, size_t num_bytes);
+
+  void forwarded(const node_id& source, size_t num_bytes);
+
+  void failed(const node_id& peer, const message* msg = nullptr);
+
+  /**
+   * Returns `(peers, types)`, both being a message with one row
+   * per key. Rows of `peers` consist of a `node_id` and the
+   * counters as `uint64_t` in the order of `counter_index`, while
+   * rows of `types` start with the type name of the messages.
+   * @note Messages passing through this node have no type.
+   */
+  message snapshot() const;
+
+  /**
+   * Sets all counters to zero.
+   */
+  void reset();
+
+  /**
+   * Returns the name for the type of `msg` used as key for its counters,
+   * e.g., `'GET'+@str` for a message consisting of an atom and a string.
+   */
+  static std::string type_name(const message& msg);
+
+ private:
+  using counters = std::array<std::atomic<uint64_t>, num_counters>;
+
+  template <class Map, class Key>
+  counters& get(Map& map, const Key& key);
+
+  counters& peer(const node_id& nid);
+
+  counters& type(const message& msg);
+
+  // maximum number of elements in a message for caching its type
+  static constexpr size_t max_cached_types = 4;
+
+  // identifies a message type without building its type name, i.e.,
+  // consists of the number of elements, the leading atom if any,
+  // and the uniform type info of each element
+  using type_key = std::tuple<size_t, atom_value,
+                              std::array<const uniform_type_info*,
+                                         max_cached_types>>;
+
+  template <class Map>
+  static message make_rows(const Map& map);
+
+  mutable detail::shared_spinlock m_lock;
+  // map nodes are never erased, i.e., references to counters stay valid
+  std::map<node_id, counters> m_peers;
+  std::map<std::string, counters> m_types;
+  // caches the counters in `m_types` for each type of message seen so far
+  std::map<type_key, counters*> m_type_cache;
+};
+
+/**
+ * A hook that records all traffic of the BASP broker to a
+ * {@link traffic_metrics} instance. Install it via
+ * `middleman::instance()->add_hook<traffic_metrics_hook>(metrics)`.
+ */
+class traffic_metrics_hook : public hook {
+ public:
+  explicit traffic_metrics_hook(std::shared_ptr<traffic_metrics> metrics);
+
+  void message_forwarded_cb(const node_id& from, const node_id& dest,
+                            const std::vector<char>* payload) override;
+
+  void message_sending_failed_cb(const actor_addr& from,
+                                 const actor_addr& dest, message_id mid,
+                                 const message& payload) override;
+
+  void message_forwarding_failed_cb(const node_id& from, const node_id& to,
+                                    const std::vector<char>* payload) override;
+
+  void invalid_message_received_cb(const node_id& source,
+                                   const actor_addr& sender,
+                                   actor_id invalid_dest, message_id mid,
+                                   const message& msg) override;
+
+  void payload_sent_cb(const node_id& hop, const message& payload,
+                       size_t num_bytes) override;
+
+  void payload_received_cb(const node_id& source, const message& payload,
+                           size_t num_bytes) override;
+
+  bool needs_payload_size() const override;
+
+ private:
+  std::shared_ptr<traffic_metrics> m_metrics;
+};
+
+/**
+ * Installs a {@link traffic_metrics_hook} and returns a hidden actor
+ * replying to `get_atom` with a {@link traffic_metrics::snapshot snapshot}
+ * of all counters and resetting all counters on `delete_atom`.
+ */
+actor spawn_traffic_monitor();
+
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_TRAFFIC_METRICS_HPP
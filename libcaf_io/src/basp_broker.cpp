@@ -19,6 +19,10 @@
 
 #include "caf/io/basp_broker.hpp"
 
+#include <limits>
+#include <thread>
+#include <algorithm>
+
 #include "caf/exception.hpp"
 #include "caf/binary_serializer.hpp"
 #include "caf/binary_deserializer.hpp"
@@ -27,10 +31,16 @@
 #include "caf/detail/singletons.hpp"
 #include "caf/detail/make_counted.hpp"
 #include "caf/detail/actor_registry.hpp"
+#include "caf/detail/sync_request_bouncer.hpp"
 
 #include "caf/io/basp.hpp"
 #include "caf/io/middleman.hpp"
 #include "caf/io/unpublish.hpp"
+#include "caf/io/max_msg_size.hpp"
+#include "caf/io/compression.hpp"
+#include "caf/io/flow_control.hpp"
+#include "caf/io/local_transport.hpp"
+#include "caf/io/parallel_connections.hpp"
 
 using std::string;
 
@@ -68,18 +78,181 @@ functor_payload_writer<F> make_payload_writer(F fun) {
   return {fun};
 }
 
-basp_broker::basp_broker() : m_namespace(*this) {
+// outbound queue that wakes up the broker via its multiplexer;
+// the broker outlives all queues, because each proxy keeps
+// a strong reference to it
+class basp_broker::outbound_queue_impl : public outbound_queue {
+ public:
+  outbound_queue_impl(basp_broker* parent) : m_parent(parent) {
+    // nop
+  }
+
+  void wakeup() override {
+    intrusive_ptr<basp_broker> bro = m_parent;
+    intrusive_ptr<outbound_queue_impl> self = this;
+    bro->broker::backend().post([=] {
+      bro->drain(*self);
+    });
+  }
+
+  bool may_block() const override {
+    auto& backend = m_parent->broker::backend();
+    return std::this_thread::get_id() != backend.thread_id();
+  }
+
+  // first message that waits for credit, the queue
+  // stays awake until the broker dispatched it
+  outbound_message_ptr held;
+
+ private:
+  basp_broker* m_parent;
+};
+
+struct basp_broker::shared_state {
+  std::mutex mtx;
+  // all brokers sharing this state, starting with the one
+  // handling publish and remote actor requests
+  std::vector<basp_broker*> shards;
+  // position of the broker handling the next remote actor request
+  size_t next_shard;
+  // node => (broker sending all messages to it, queue of its proxies)
+  std::map<node_id, node_owner> owners;
+};
+
+basp_broker::basp_broker()
+    : m_namespace(*this),
+      m_shared(std::make_shared<shared_state>()) {
+  m_shared->shards.push_back(this);
+  m_shared->next_shard = 0;
+  m_meta_msg = uniform_typeid<message>();
+  m_meta_id_type = uniform_typeid<node_id>();
+  CAF_LOG_DEBUG("BASP broker started: " << to_string(node()));
+}
+
+basp_broker::basp_broker(middleman& pref)
+    : broker(pref),
+      m_namespace(*this),
+      m_shared(std::make_shared<shared_state>()) {
+  m_shared->shards.push_back(this);
+  m_shared->next_shard = 0;
   m_meta_msg = uniform_typeid<message>();
   m_meta_id_type = uniform_typeid<node_id>();
   CAF_LOG_DEBUG("BASP broker started: " << to_string(node()));
 }
 
-basp_broker::basp_broker(middleman& pref) : broker(pref), m_namespace(*this) {
+basp_broker::basp_broker(basp_broker& first, network::multiplexer& bref)
+    : broker(first.parent(), bref),
+      m_namespace(*this, first.m_namespace),
+      m_shared(first.m_shared) {
+  std::lock_guard<std::mutex> guard{m_shared->mtx};
+  m_shared->shards.push_back(this);
   m_meta_msg = uniform_typeid<message>();
   m_meta_id_type = uniform_typeid<node_id>();
   CAF_LOG_DEBUG("BASP broker started: " << to_string(node()));
 }
 
+basp_broker::node_owner basp_broker::find_owner(const node_id& nid) {
+  std::lock_guard<std::mutex> guard{m_shared->mtx};
+  auto i = m_shared->owners.find(nid);
+  if (i == m_shared->owners.end()) {
+    return {nullptr, nullptr};
+  }
+  return i->second;
+}
+
+basp_broker::node_owner basp_broker::claim(const node_id& nid) {
+  std::lock_guard<std::mutex> guard{m_shared->mtx};
+  auto& entry = m_shared->owners[nid];
+  if (!entry.first) {
+    CAF_LOG_DEBUG("send all messages to " << to_string(nid)
+                  << " via this broker");
+    entry.first = this;
+    entry.second = make_counted<outbound_queue_impl>(this);
+  }
+  return entry;
+}
+
+intrusive_ptr<basp_broker::outbound_queue_impl>
+basp_broker::release(const node_id& nid) {
+  std::lock_guard<std::mutex> guard{m_shared->mtx};
+  auto i = m_shared->owners.find(nid);
+  if (i == m_shared->owners.end() || i->second.first != this) {
+    return nullptr;
+  }
+  auto result = std::move(i->second.second);
+  m_shared->owners.erase(i);
+  return result;
+}
+
+bool basp_broker::is_first() const {
+  std::lock_guard<std::mutex> guard{m_shared->mtx};
+  return m_shared->shards.front() == this;
+}
+
+std::vector<basp_broker*> basp_broker::other_shards() const {
+  std::vector<basp_broker*> result;
+  std::lock_guard<std::mutex> guard{m_shared->mtx};
+  for (auto shard : m_shared->shards) {
+    if (shard != this) {
+      result.push_back(shard);
+    }
+  }
+  return result;
+}
+
+basp_broker* basp_broker::next_shard() {
+  std::lock_guard<std::mutex> guard{m_shared->mtx};
+  auto& shards = m_shared->shards;
+  return shards[m_shared->next_shard++ % shards.size()];
+}
+
+void basp_broker::share_published_actor(accept_handle hdl, bool shm,
+                                        const abstract_actor_ptr& ptr,
+                                        uint16_t port, accept_handle local_hdl,
+                                        const std::string& local_path) {
+  CAF_LOG_TRACE(CAF_MARG(hdl, id) << ", " << CAF_ARG(port));
+  if (!ptr) {
+    return;
+  }
+  auto local_shm = local_path.compare(0, 4, "shm:") == 0;
+  for (auto shard : other_shards()) {
+    // each broker waits for connections on a duplicate of the socket,
+    // the first broker woken up by the kernel accepts a connection
+    accept_handle shared_hdl;
+    accept_handle shared_local_hdl;
+    try {
+      shared_hdl = broker::backend().new_shared_doorman(hdl);
+      if (!local_hdl.invalid()) {
+        shared_local_hdl = broker::backend().new_shared_doorman(local_hdl);
+      }
+    }
+    catch (network_error& e) {
+      CAF_LOG_INFO("unable to share doorman: " << e.what());
+      static_cast<void>(e); // keep compiler happy w/o logging
+      if (shared_hdl.invalid()) {
+        return;
+      }
+    }
+    intrusive_ptr<basp_broker> bro = shard;
+    bro->broker::backend().post([=] {
+      auto assign = [&](accept_handle x, bool x_shm) {
+        if (x_shm) {
+          bro->assign_shm_doorman(x);
+        } else {
+          bro->assign_tcp_doorman(x);
+        }
+      };
+      assign(shared_hdl, shm);
+      bro->add_published_actor(shared_hdl, ptr, port);
+      if (!shared_local_hdl.invalid()) {
+        assign(shared_local_hdl, local_shm);
+        bro->m_acceptors.emplace(shared_local_hdl, std::make_pair(ptr, port));
+        bro->m_local_paths.emplace(shared_hdl, local_path);
+      }
+    });
+  }
+}
+
 behavior basp_broker::make_behavior() {
   return {
     // received from underlying broker implementation
@@ -98,7 +271,10 @@ behavior basp_broker::make_behavior() {
       ctx.hdl = msg.handle;
       ctx.handshake_data = none;
       ctx.state = await_client_handshake;
-      init_handshake_as_server(ctx, m_acceptors[msg.source].first->address());
+      auto i = m_local_paths.find(msg.source);
+      init_handshake_as_server(ctx, m_acceptors[msg.source].first->address(),
+                               i != m_local_paths.end() ? i->second
+                                                        : std::string{});
     },
     // received from underlying broker implementation
     [=](const connection_closed_msg& msg) {
@@ -106,40 +282,28 @@ behavior basp_broker::make_behavior() {
                      CAF_MARG(msg.handle, id));
       auto j = m_ctx.find(msg.handle);
       if (j != m_ctx.end()) {
+        abort_lane(j->second);
+        fall_back_to_tcp(j->second);
         auto hd = j->second.handshake_data;
-        if (hd) {
+        // a fallback connection leaves replying to its local socket
+        if (hd && j->second.state != await_local_handshake) {
           send(hd->client, error_atom{}, hd->request_id,
                "disconnect during handshake");
         }
         m_ctx.erase(j);
       }
-      // purge handle from all routes
-      std::vector<node_id> lost_connections;
-      for (auto& kvp : m_routes) {
-        auto& entry = kvp.second;
-        if (entry.first.hdl == msg.handle) {
-          CAF_LOG_DEBUG("lost direct connection to " << to_string(kvp.first));
-          entry.first.hdl.set_invalid();
-        }
-        auto last = entry.second.end();
-        auto i = std::lower_bound(entry.second.begin(), last, msg.handle,
-                                  connection_info_less{});
-        if (i != last && i->hdl == msg.handle) {
-          entry.second.erase(i);
-        }
-        if (entry.first.invalid() && entry.second.empty()) {
-          lost_connections.push_back(kvp.first);
-        }
-      }
-      // remove routes that no longer have any path and kill all proxies
-      for (auto& lc : lost_connections) {
-        CAF_LOG_DEBUG("no more route to " << to_string(lc));
-        m_routes.erase(lc);
-        auto proxies = m_namespace.get_all(lc);
-        m_namespace.erase(lc);
-        for (auto& p : proxies) {
-          p->kill_proxy(exit_reason::remote_link_unreachable);
-        }
+      purge_routes(msg.handle);
+    },
+    // received from underlying broker implementation
+    [=](const data_transferred_msg& msg) {
+      CAF_LOGM_TRACE("make_behavior$data_transferred_msg",
+                     CAF_MARG(msg.handle, id) << ", "
+                     << CAF_ARG(msg.remaining));
+      auto i = m_ctx.find(msg.handle);
+      // send more fragments once the previous ones left the buffer
+      if (i != m_ctx.end() && !i->second.transfers.empty()
+          && msg.remaining <= fragment_size()) {
+        send_fragments(i->second);
       }
     },
     // received from underlying broker implementation
@@ -150,9 +314,13 @@ behavior basp_broker::make_behavior() {
         CAF_LOG_INFO("accept handle no longer in use");
         return;
       }
-      if (m_open_ports.erase(i->second.second) == 0) {
+      auto j = m_open_ports.find(i->second.second);
+      if (j != m_open_ports.end() && j->second == msg.handle) {
+        m_open_ports.erase(j);
+      } else {
         CAF_LOG_INFO("accept handle was not bound to a port");
       }
+      m_local_paths.erase(msg.handle);
       m_acceptors.erase(i);
     },
     // received from proxy instances
@@ -173,35 +341,158 @@ behavior basp_broker::make_behavior() {
     [=](put_atom, accept_handle hdl,
         const actor_addr& whom, uint16_t port) {
       assign_tcp_doorman(hdl);
-      add_published_actor(hdl, actor_cast<abstract_actor_ptr>(whom), port);
+      auto ptr = actor_cast<abstract_actor_ptr>(whom);
+      add_published_actor(hdl, ptr, port);
+      accept_handle local_hdl;
+      std::string path;
+      if (ptr && prefer_local_transport()) {
+        // offer a Unix domain socket to clients on the same host
+        path = local_transport_path(port);
+        try {
+          if (shared_memory_transport()) {
+            local_hdl = add_shm_doorman(path);
+            path.insert(0, "shm:");
+          } else {
+            local_hdl = add_unix_doorman(path);
+          }
+          m_acceptors.emplace(local_hdl, std::make_pair(ptr, port));
+          m_local_paths.emplace(hdl, path);
+        }
+        catch (std::exception& e) {
+          CAF_LOG_INFO("unable to open Unix domain socket: " << e.what());
+          static_cast<void>(e); // keep compiler happy w/o logging
+        }
+      }
+      share_published_actor(hdl, false, ptr, port, local_hdl, path);
       parent().notify<hook::actor_published>(whom, port);
     },
-    [=](get_atom, connection_handle hdl, int64_t request_id,
-        actor client, std::set<std::string>& expected_ifs) {
-      assign_tcp_scribe(hdl);
-      auto& ctx = m_ctx[hdl];
-      ctx.hdl = hdl;
+    [=](put_atom, accept_handle hdl,
+        const actor_addr& whom, const std::string& path) {
+      CAF_LOGM_TRACE("make_behavior$put_atom", CAF_ARG(path));
+      auto socket_path = path;
+      auto shm = strip_shared_memory_prefix(socket_path);
+      if (shm) {
+        assign_shm_doorman(hdl);
+      } else {
+        assign_tcp_doorman(hdl);
+      }
+      auto ptr = actor_cast<abstract_actor_ptr>(whom);
+      add_published_actor(hdl, ptr, 0);
+      share_published_actor(hdl, shm, ptr, 0, accept_handle{}, std::string{});
+      parent().notify<hook::actor_published>(whom, uint16_t{0});
+    },
+    [=](get_atom, const std::string& hostname, uint16_t port,
+        int64_t request_id, actor client,
+        std::set<std::string>& expected_ifs) {
+      CAF_LOGM_TRACE("make_behavior$get_atom",
+                     CAF_ARG(hostname) << ", " << CAF_ARG(port));
+      auto shard = is_first() ? next_shard() : this;
+      if (shard != this) {
+        // connect via the multiplexer of another broker
+        send(actor{shard}, get_atom{}, hostname, port, request_id,
+             std::move(client), std::move(expected_ifs));
+        return;
+      }
+      connection_handle hdl;
+      try {
+        hdl = add_tcp_scribe_async(hostname, port);
+      }
+      catch (network_error& err) {
+        send(client, error_atom{}, request_id,
+             std::string("network_error: ") + err.what());
+        return;
+      }
       // PODs are not movable, so passing expected_ifs to the ctor  would cause
       // a copy; we avoid this by calling the ctor with an empty set and
       // swap afterwards with expected_ifs
+      auto& hd = m_pending_connections[hdl];
+      hd = client_handshake_data{request_id, client, std::set<std::string>(),
+                                 hostname, port, 0, invalid_node_id,
+                                 connection_handle{}, invalid_actor_id};
+      hd.expected_ifs.swap(expected_ifs);
+    },
+    [=](get_atom, const std::string& path, int64_t request_id, actor client,
+        std::set<std::string>& expected_ifs) {
+      CAF_LOGM_TRACE("make_behavior$get_atom", CAF_ARG(path));
+      auto shard = is_first() ? next_shard() : this;
+      if (shard != this) {
+        send(actor{shard}, get_atom{}, path, request_id, std::move(client),
+             std::move(expected_ifs));
+        return;
+      }
+      connection_handle hdl;
+      try {
+        hdl = connect_local(path);
+      }
+      catch (network_error& err) {
+        send(client, error_atom{}, request_id,
+             std::string("network_error: ") + err.what());
+        return;
+      }
+      auto& ctx = m_ctx[hdl];
+      ctx.hdl = hdl;
       ctx.handshake_data = client_handshake_data{request_id, client,
-                                                 std::set<std::string>()};
+                                                 std::set<std::string>(),
+                                                 path, 0, 0, invalid_node_id,
+                                                 connection_handle{},
+                                                 invalid_actor_id};
       ctx.handshake_data->expected_ifs.swap(expected_ifs);
       init_handshake_as_client(ctx);
     },
+    // received from underlying broker implementation
+    [=](connection_attempt_msg& msg) {
+      CAF_LOGM_TRACE("make_behavior$connection_attempt_msg",
+                     CAF_MARG(msg.handle, id) << ", "
+                     << CAF_ARG(msg.success));
+      auto i = m_pending_connections.find(msg.handle);
+      if (i == m_pending_connections.end()) {
+        CAF_LOG_ERROR("received connection_attempt_msg for unknown handle");
+        return;
+      }
+      auto hd = std::move(i->second);
+      m_pending_connections.erase(i);
+      if (!msg.success) {
+        if (hd.lane != 0) {
+          CAF_LOG_INFO("unable to open lane: " << msg.reason);
+          lane_done(hd.peer, connection_handle{}, hd.lane);
+          return;
+        }
+        send(hd.client, error_atom{}, hd.request_id,
+             "network_error: " + msg.reason);
+        return;
+      }
+      auto& ctx = m_ctx[msg.handle];
+      ctx.hdl = msg.handle;
+      ctx.handshake_data = std::move(hd);
+      init_handshake_as_client(ctx);
+    },
     [=](delete_atom, int64_t request_id, const actor_addr& whom, uint16_t port)
     -> message {
       if (whom == invalid_actor_addr) {
-        return make_message(error_atom::value, "whom == invalid_actor_addr");
+        return make_message(error_atom::value, request_id,
+                            "whom == invalid_actor_addr");
       }
       auto ptr = actor_cast<abstract_actor_ptr>(whom);
+      // other brokers accept connections on the same sockets
+      for (auto shard : other_shards()) {
+        intrusive_ptr<basp_broker> bro = shard;
+        bro->broker::backend().post([=] {
+          if (port == 0) {
+            bro->remove_published_actor(ptr);
+          } else {
+            bro->remove_published_actor(ptr, port);
+          }
+        });
+      }
       if (port == 0) {
         if (!remove_published_actor(ptr)) {
-          return make_message(error_atom::value, "no mapping found");
+          return make_message(error_atom::value, request_id,
+                              "no mapping found");
         }
       } else {
         if (!remove_published_actor(ptr, port)) {
-          return make_message(error_atom::value, "port not bound to actor");
+          return make_message(error_atom::value, request_id,
+                              "port not bound to actor");
         }
       }
       return make_message(ok_atom::value, request_id);
@@ -216,37 +507,240 @@ behavior basp_broker::make_behavior() {
 
 void basp_broker::new_data(connection_context& ctx, buffer_type& buf) {
   CAF_LOG_TRACE(CAF_TARG(ctx.state, static_cast<int>) << ", "
-                CAF_MARG(ctx.hdl, id));
+                CAF_MARG(ctx.hdl, id) << ", " << CAF_ARG(buf.size()));
   m_current_context = &ctx;
+  auto first = static_cast<const char*>(buf.data());
+  auto last = first + buf.size();
+  // complete a header or payload we have received partially earlier,
+  // copying only the missing bytes to keep processing the rest of
+  // the data directly from `buf`
+  if (!ctx.pending.empty()) {
+    auto missing = frame_size(ctx, ctx.pending.data()) - ctx.pending.size();
+    if (static_cast<size_t>(last - first) < missing) {
+      ctx.pending.insert(ctx.pending.end(), first, last);
+      return;
+    }
+    ctx.pending.insert(ctx.pending.end(), first, first + missing);
+    first += missing;
+    if (!handle_frame(ctx, ctx.pending.data(), ctx.pending.size())) {
+      // ctx has been erased
+      return;
+    }
+    ctx.pending.clear();
+  }
+  // we pass received bytes on to other connections without copying them
+  // unless hooks are installed, since those need to see each payload
+  auto zero_copy = !parent().has_hooks();
+  network::shared_buffer_ptr shared; // takes ownership of `buf` if needed
+  // process all complete headers and payloads
+  for (;;) {
+    auto needed = frame_size(ctx, first != last ? first : nullptr);
+    if (static_cast<size_t>(last - first) < needed) {
+      break;
+    }
+    auto frame = first;
+    auto prev_state = ctx.state;
+    if (!handle_frame(ctx, first, needed)) {
+      // ctx has been erased
+      return;
+    }
+    first += needed;
+    // relay messages for other nodes by passing header and
+    // payload to the next hop without copying or parsing them;
+    // headers with node aliases need to be rewritten, though
+    if (zero_copy && prev_state == await_header && ctx.state == await_payload
+        && !basp::has_aliases(static_cast<uint8_t>(*frame))
+        && !ctx.frame_compressed // rejected by handle_basp_header
+        && ctx.hdr.dest_node != invalid_node_id
+        && ctx.hdr.dest_node != node()
+        && static_cast<size_t>(last - first) >= ctx.hdr.payload_len
+        && forward_frame(ctx, buf, shared, frame)) {
+      first += ctx.hdr.payload_len;
+      ctx.state = await_header;
+    }
+  }
+  // carry over remaining bytes
+  ctx.pending.assign(first, last);
+  if (!ctx.grants.empty()) {
+    send_grants(ctx);
+  }
+}
+
+bool basp_broker::forward_frame(connection_context& ctx, buffer_type& buf,
+                                network::shared_buffer_ptr& shared,
+                                const char* frame) {
+  auto& hdr = ctx.hdr;
+  auto route = get_route(hdr.dest_node);
+  if (route.invalid()) {
+    // let handle_basp_header report the error
+    return false;
+  }
+  CAF_LOG_DEBUG("forward message via " << to_string(route.node)
+                << " without copying it");
+  if (!shared) {
+    // moving the vector keeps its data (and thus `frame`) valid;
+    // the scribe allocates a new read buffer afterwards
+    shared.reset(new network::shared_buffer(std::move(buf)));
+    buf.clear();
+  }
+  broker::write(route.hdl, shared, static_cast<size_t>(frame - shared->data()),
+                basp::header_size(static_cast<uint8_t>(*frame))
+                + hdr.payload_len);
+  flush(route.hdl);
+  return true;
+}
+
+bool basp_broker::handle_frame(connection_context& ctx, const char* data,
+                               size_t size) {
+  CAF_LOG_TRACE(CAF_TARG(ctx.state, static_cast<int>) << ", "
+                << CAF_ARG(size));
   connection_state next_state;
   switch (ctx.state) {
     default: {
-      binary_deserializer bd{buf.data(), buf.size(), &m_namespace};
-      read(bd, ctx.hdr);
-      if (!basp::valid(ctx.hdr)) {
+      binary_deserializer bd{data, size, &m_namespace};
+      if (!read(bd, ctx.hdr, ctx) || !basp::valid(ctx.hdr)) {
         CAF_LOG_INFO("invalid broker message received");
-        close(ctx.hdl);
-        m_ctx.erase(ctx.hdl);
-        return;
+        abort_lane(ctx);
+        fall_back_to_tcp(ctx);
+        auto hdl = ctx.hdl;
+        close(hdl);
+        m_ctx.erase(hdl);
+        purge_routes(hdl);
+        return false;
       }
       next_state = handle_basp_header(ctx);
       break;
     }
     case await_payload: {
-      next_state = handle_basp_header(ctx, &buf);
+      ctx.payload.assign(data, data + size);
+      next_state = handle_basp_header(ctx, &ctx.payload);
+      break;
+    }
+    case await_local_handshake: {
+      CAF_LOG_INFO("received data while repeating handshake locally");
+      next_state = close_connection;
       break;
     }
   }
   CAF_LOG_DEBUG("transition: " << ctx.state << " -> " << next_state);
   if (next_state == close_connection) {
-    close(ctx.hdl);
-    m_ctx.erase(ctx.hdl);
-    return;
+    abort_lane(ctx);
+    fall_back_to_tcp(ctx);
+    auto hdl = ctx.hdl;
+    close(hdl);
+    m_ctx.erase(hdl);
+    purge_routes(hdl);
+    return false;
   }
   ctx.state = next_state;
-  configure_read(ctx.hdl, receive_policy::exactly(next_state == await_payload
-                                                    ? ctx.hdr.payload_len
-                                                    : basp::header_size));
+  return true;
+}
+
+void basp_broker::purge_routes(connection_handle hdl) {
+  CAF_LOG_TRACE(CAF_MARG(hdl, id));
+  // messages striped to a lost lane use the first connection from now on
+  for (auto& kvp : m_lanes) {
+    auto& ls = kvp.second;
+    std::replace(ls.lanes.begin(), ls.lanes.end(), hdl, connection_handle{});
+    if (ls.bulk == hdl) {
+      ls.bulk.set_invalid();
+    }
+  }
+  std::vector<node_id> lost_connections;
+  std::vector<node_id> lost_direct_connections;
+  for (auto& kvp : m_routes) {
+    auto& entry = kvp.second;
+    if (entry.first.hdl == hdl) {
+      CAF_LOG_DEBUG("lost direct connection to " << to_string(kvp.first));
+      entry.first.hdl.set_invalid();
+      lost_direct_connections.push_back(kvp.first);
+    }
+    auto last = entry.second.end();
+    auto i = std::lower_bound(entry.second.begin(), last, hdl,
+                              connection_info_less{});
+    if (i != last && i->hdl == hdl) {
+      entry.second.erase(i);
+    }
+    if (entry.first.invalid() && entry.second.empty()) {
+      lost_connections.push_back(kvp.first);
+    }
+  }
+  // lanes cannot outlive the connection that established the route
+  for (auto& nid : lost_direct_connections) {
+    auto i = m_lane_setups.find(nid);
+    if (i != m_lane_setups.end()) {
+      for (auto& c : i->second.clients) {
+        send(c.first, error_atom{}, c.second,
+             "disconnect during handshake");
+      }
+      m_lane_setups.erase(i);
+    }
+    auto j = m_lanes.find(nid);
+    if (j == m_lanes.end()) {
+      continue;
+    }
+    auto lanes = std::move(j->second.lanes);
+    lanes.push_back(j->second.bulk);
+    m_lanes.erase(j);
+    for (auto& lane : lanes) {
+      if (!lane.invalid()) {
+        close(lane);
+        m_ctx.erase(lane);
+        purge_routes(lane);
+      }
+    }
+  }
+  // remove routes that no longer have any path and kill all proxies
+  // if this broker sent their messages
+  for (auto& lc : lost_connections) {
+    CAF_LOG_DEBUG("no more route to " << to_string(lc));
+    m_routes.erase(lc);
+    // incomplete messages from the lost node are never completed
+    for (auto& kvp : m_ctx) {
+      auto& ctx = kvp.second;
+      for (auto i = ctx.fragments.begin(); i != ctx.fragments.end();) {
+        if (std::get<0>(i->first) == lc) {
+          ctx.fragment_bytes -= i->second.size();
+          i = ctx.fragments.erase(i);
+        } else {
+          ++i;
+        }
+      }
+    }
+    auto q = release(lc);
+    if (!q) {
+      // another broker sends messages to the lost node
+      continue;
+    }
+    auto proxies = m_namespace.get_all(lc);
+    m_namespace.erase(lc);
+    // proxies of the lost node still hold the queue, hence we close it
+    // to have them bounce requests instead of enqueueing new messages
+    auto& queue = *q;
+    if (queue.held) {
+      detail::sync_request_bouncer f{exit_reason::remote_link_unreachable};
+      f(queue.held->sender, queue.held->mid);
+      queue.held.reset();
+    }
+    queue.close(exit_reason::remote_link_unreachable);
+    for (auto& p : proxies) {
+      p->kill_proxy(exit_reason::remote_link_unreachable);
+    }
+  }
+  // messages waiting for credit of a closed connection
+  // either use another connection now or get dropped
+  std::vector<intrusive_ptr<outbound_queue_impl>> waiting;
+  { // lifetime scope of guard
+    std::lock_guard<std::mutex> guard{m_shared->mtx};
+    for (auto& kvp : m_shared->owners) {
+      if (kvp.second.first == this && kvp.second.second->held) {
+        waiting.push_back(kvp.second.second);
+      }
+    }
+  }
+  for (auto& queue : waiting) {
+    queue->wakeup();
+  }
 }
 
 void basp_broker::local_dispatch(const basp::header& hdr, message&& msg) {
@@ -319,16 +813,35 @@ void basp_broker::local_dispatch(const basp::header& hdr, message&& msg) {
   dest->enqueue(src, mid, std::move(msg), nullptr);
 }
 
-void basp_broker::dispatch(connection_handle hdl, uint32_t operation,
-                           const node_id& src_node, actor_id src_actor,
-                           const node_id& dest_node, actor_id dest_actor,
-                           uint64_t op_data, payload_writer* writer) {
+size_t basp_broker::dispatch(connection_handle hdl, uint32_t operation,
+                             const node_id& src_node, actor_id src_actor,
+                             const node_id& dest_node, actor_id dest_actor,
+                             uint64_t op_data, payload_writer* writer,
+                             uint8_t flags, const trace_context* trace) {
+  auto result = append_frame(hdl, operation, src_node, src_actor, dest_node,
+                             dest_actor, op_data, writer, flags, trace);
+  flush(hdl);
+  return result;
+}
+
+size_t basp_broker::append_frame(connection_handle hdl, uint32_t operation,
+                                 const node_id& src_node, actor_id src_actor,
+                                 const node_id& dest_node,
+                                 actor_id dest_actor, uint64_t op_data,
+                                 payload_writer* writer, uint8_t flags,
+                                 const trace_context* trace) {
   auto& buf = wr_buf(hdl);
+  auto remote = peer(hdl);
+  auto first = buf.size();
   if (writer) {
     // reserve space in the buffer to write the broker message later on
     auto wr_pos = static_cast<ptrdiff_t>(buf.size());
-    char placeholder[basp::header_size];
-    buf.insert(buf.end(), std::begin(placeholder), std::end(placeholder));
+    basp::header tmp{src_node, dest_node, src_actor, dest_actor,
+                     0, operation, op_data};
+    auto traced = trace != nullptr && trace->sampled;
+    buf.resize(buf.size()
+               + basp::header_size(basp::make_flags(tmp, node(), remote)
+                                   | (traced ? basp::trace_flag : 0)));
     auto before = buf.size();
     { // lifetime scope of first serializer (write payload)
       binary_serializer bs1{std::back_inserter(buf), &m_namespace};
@@ -336,15 +849,14 @@ void basp_broker::dispatch(connection_handle hdl, uint32_t operation,
     }
     // write broker message to the reserved space
     binary_serializer bs2{buf.begin() + wr_pos, &m_namespace};
-    auto payload_len = static_cast<uint32_t>(buf.size() - before);
-    write(bs2, {src_node,    dest_node, src_actor,   dest_actor,
-                payload_len, operation, op_data});
+    tmp.payload_len = static_cast<uint32_t>(buf.size() - before);
+    write(bs2, tmp, remote, flags, trace);
   } else {
-    binary_serializer bs(std::back_inserter(wr_buf(hdl)), &m_namespace);
+    binary_serializer bs(std::back_inserter(buf), &m_namespace);
     write(bs, {src_node, dest_node, src_actor, dest_actor,
-               0, operation, op_data});
+               0, operation, op_data}, remote, flags, trace);
   }
-  flush(hdl);
+  return buf.size() - first;
 }
 
 node_id basp_broker::dispatch(uint32_t operation, const node_id& src_node,
@@ -364,46 +876,361 @@ node_id basp_broker::dispatch(uint32_t operation, const node_id& src_node,
 
 void basp_broker::dispatch(const actor_addr& from, const actor_addr& to,
                            message_id mid, const message& msg) {
+  try_dispatch(from, to, mid, msg, false, false);
+}
+
+bool basp_broker::try_dispatch(const actor_addr& from, const actor_addr& to,
+                               message_id mid, const message& msg,
+                               bool may_wait, bool flow_controlled) {
   CAF_LOG_TRACE(CAF_TSARG(from) << ", " << CAF_MARG(mid, integer_value)
                 << ", " << CAF_TSARG(to) << ", " << CAF_TSARG(msg));
   if (to == invalid_actor_addr) {
-    return;
+    return true;
   }
   if (from != invalid_actor_addr && from.node() == node()) {
     // register locally running actors to be able to deserialize them later
     auto reg = detail::singletons::get_actor_registry();
     reg->put(from.id(), actor_cast<abstract_actor_ptr>(from));
   }
-  auto writer = make_payload_writer([&](binary_serializer& sink) {
-    sink.write(msg, m_meta_msg);
-  });
-  auto route_node = dispatch(basp::dispatch_message, from.node(), from.id(),
-                             to.node(), to.id(), mid.integer_value(), &writer);
-  if (route_node == invalid_node_id) {
+  auto route = get_route(to.node());
+  if (route.invalid()) {
+    CAF_LOG_INFO("unable to dispatch message: no route to "
+                 << CAF_TSARG(to.node()));
     parent().notify<hook::message_sending_failed>(from, to, mid, msg);
+    if (flow_controlled) {
+      return_credit(to);
+    }
+    return true;
+  }
+  auto serialize_payload = [&] {
+    m_payload_buf.clear();
+    binary_serializer bs{std::back_inserter(m_payload_buf), &m_namespace};
+    bs.write(msg, m_meta_msg);
+  };
+  auto hdl = route.hdl;
+  auto i = m_lanes.find(route.node);
+  auto threshold = bulk_connection_threshold();
+  auto bulk = i != m_lanes.end() && threshold > 0 && !i->second.bulk.invalid();
+  if (bulk) {
+    // only the serialized size tells us whether to use the bulk lane
+    serialize_payload();
+    hdl = select_lane(hdl, route.node, from.id(), to.id(),
+                      m_payload_buf.size() >= threshold);
+  } else if (i != m_lanes.end()) {
+    hdl = select_lane(hdl, route.node, from.id(), to.id(), false);
+  }
+  // only direct neighbors return credit
+  auto window = connection_credit();
+  auto j = m_ctx.find(hdl);
+  auto credit = (window > 0 || flow_controlled) && j != m_ctx.end()
+                && j->second.remote_id == to.node();
+  if (credit && may_wait && window > 0 && j->second.in_flight >= window) {
+    CAF_LOG_DEBUG("no credit left for connection " << hdl.id());
+    return false;
+  }
+  // a message must not overtake a large message from the same
+  // sender to the same receiver that is still sent in fragments
+  auto queued = j != m_ctx.end()
+                && std::any_of(j->second.transfers.begin(),
+                               j->second.transfers.end(),
+                               [&](const transfer& x) {
+                                 return x.hdr.source_node == from.node()
+                                        && x.hdr.source_actor == from.id()
+                                        && x.hdr.dest_actor == to.id();
+                               });
+  // only direct neighbors decompress messages
+  auto min_compressed = compression_threshold();
+  auto compress = min_compressed > 0 && j != m_ctx.end()
+                  && j->second.compress && j->second.remote_id == to.node();
+  auto max_fragment = fragment_size();
+  auto serialized = bulk;
+  // some hooks learn the size of each message on the wire
+  auto hooks = parent().has_hooks();
+  auto sizes = hooks && parent().has_payload_hooks();
+  if (!serialized && (queued || compress || sizes)) {
+    serialize_payload();
+    serialized = true;
+  }
+  auto compressed = false;
+  if (compress && m_payload_buf.size() >= min_compressed) {
+    m_codec_buf.clear();
+    m_codec.compress(m_payload_buf.data(), m_payload_buf.size(), m_codec_buf);
+    // incompressible messages are sent as they are
+    if (m_codec_buf.size() < m_payload_buf.size()) {
+      m_payload_buf.swap(m_codec_buf);
+      compressed = true;
+    }
+  }
+  auto payload_size = m_payload_buf.size();
+  auto flags = static_cast<uint8_t>((credit ? basp::credit_flag : 0)
+                                    | (compressed ? basp::compressed_flag
+                                                  : 0));
+  auto fragmented = j != m_ctx.end()
+                    && (queued || (serialized && max_fragment > 0
+                                   && m_payload_buf.size() > max_fragment));
+  // each message sent to another node starts a new span of its trace
+  auto& current = trace_context::current();
+  auto trace = current.sampled ? current.child() : current;
+  basp::header last_hdr{from.node(), to.node(), from.id(), to.id(), 0,
+                        basp::dispatch_message, mid.integer_value()};
+  size_t frame_size = 0; // transfers account for credit per fragment
+  if (fragmented) {
+    add_transfer(j->second, last_hdr, credit, compressed, trace);
+  } else if (serialized) {
+    auto writer = make_payload_writer([&](binary_serializer& sink) {
+      sink.write_raw(m_payload_buf.size(), m_payload_buf.data());
+    });
+    frame_size = dispatch(hdl, basp::dispatch_message, from.node(), from.id(),
+                          to.node(), to.id(), mid.integer_value(), &writer,
+                          flags, &trace);
   } else {
-    parent().notify<hook::message_sent>(from, route_node, to, mid, msg);
+    // serialize straight into the write buffer and move the payload
+    // to a transfer only if it turns out to exceed the fragment size
+    auto writer = make_payload_writer([&](binary_serializer& sink) {
+      sink.write(msg, m_meta_msg);
+    });
+    frame_size = append_frame(hdl, basp::dispatch_message, from.node(),
+                              from.id(), to.node(), to.id(),
+                              mid.integer_value(), &writer, flags, &trace);
+    auto& buf = wr_buf(hdl);
+    auto frame = buf.end() - static_cast<ptrdiff_t>(frame_size);
+    auto payload_len = frame_size
+                       - basp::header_size(static_cast<uint8_t>(*frame));
+    if (j != m_ctx.end() && max_fragment > 0 && payload_len > max_fragment) {
+      m_payload_buf.assign(buf.end() - static_cast<ptrdiff_t>(payload_len),
+                           buf.end());
+      buf.erase(frame, buf.end());
+      frame_size = 0;
+      add_transfer(j->second, last_hdr, credit, false, trace);
+    } else {
+      flush(hdl);
+    }
+  }
+  if (credit) {
+    j->second.in_flight += frame_size;
+  } else if (flow_controlled) {
+    return_credit(to);
   }
+  if (hooks) {
+    scoped_trace hop{trace};
+    parent().notify<hook::message_sent>(from, route.node, to, mid, msg);
+    if (serialized) {
+      parent().notify<hook::payload_sent>(route.node, msg, payload_size);
+    }
+  }
+  return true;
 }
 
-void basp_broker::read(binary_deserializer& bd, basp::header& msg) {
-  bd.read(msg.source_node, m_meta_id_type)
-    .read(msg.dest_node, m_meta_id_type)
+void basp_broker::return_credit(const actor_addr& proxy) {
+  auto ptr = actor_cast<abstract_actor_ptr>(proxy);
+  auto fwd = dynamic_cast<forwarding_actor_proxy*>(ptr.get());
+  if (fwd) {
+    fwd->grant(1);
+  }
+}
+
+void basp_broker::collect_credit(connection_context& ctx,
+                                 uint32_t num_messages) {
+  if (ctx.frame_credit == 0 || ctx.remote_id == invalid_node_id) {
+    return;
+  }
+  // return credit after processing all data received so far
+  auto& hdr = ctx.hdr;
+  uint64_t bytes = ctx.frame_credit + hdr.payload_len;
+  auto i = ctx.grants.find(hdr.dest_actor);
+  if (i != ctx.grants.end()
+      && i->second.first + bytes > std::numeric_limits<uint32_t>::max()) {
+    send_grants(ctx);
+  }
+  auto& entry = ctx.grants[hdr.dest_actor];
+  entry.first += bytes;
+  entry.second += num_messages;
+}
+
+void basp_broker::send_grants(connection_context& ctx) {
+  CAF_LOG_TRACE(CAF_MARG(ctx.hdl, id) << ", " << CAF_ARG(ctx.grants.size()));
+  binary_serializer bs{std::back_inserter(wr_buf(ctx.hdl)), &m_namespace};
+  for (auto& kvp : ctx.grants) {
+    write(bs, {node(), ctx.remote_id, kvp.first, invalid_actor_id, 0,
+               basp::grant_credit,
+               (kvp.second.first << 32) | kvp.second.second},
+          ctx.remote_id);
+  }
+  ctx.grants.clear();
+  flush(ctx.hdl);
+}
+
+void basp_broker::add_transfer(connection_context& ctx,
+                               const basp::header& hdr, bool credit,
+                               bool compressed, const trace_context& trace) {
+  CAF_LOG_TRACE(CAF_MARG(ctx.hdl, id) << ", "
+                << CAF_ARG(m_payload_buf.size()));
+  network::shared_buffer_ptr payload{
+    new network::shared_buffer(std::move(m_payload_buf))};
+  m_payload_buf.clear();
+  ctx.transfers.push_back(transfer{hdr, std::move(payload), 0, credit,
+                                  compressed, trace});
+  if (ctx.transfers.size() == 1) {
+    // write notifications trigger all further fragments
+    ack_writes(ctx.hdl, true);
+    send_fragments(ctx);
+  }
+}
+
+void basp_broker::send_fragments(connection_context& ctx) {
+  CAF_LOG_TRACE(CAF_MARG(ctx.hdl, id) << ", "
+                << CAF_ARG(ctx.transfers.size()));
+  auto max_fragment = fragment_size();
+  std::vector<fragment_key> busy;
+  auto i = ctx.transfers.begin();
+  while (i != ctx.transfers.end()) {
+    fragment_key key{i->hdr.source_node, i->hdr.source_actor,
+                     i->hdr.dest_actor};
+    if (std::find(busy.begin(), busy.end(), key) != busy.end()) {
+      ++i;
+      continue;
+    }
+    busy.push_back(std::move(key));
+    auto remaining = i->payload->size() - i->offset;
+    auto last = max_fragment == 0 || remaining <= max_fragment;
+    auto hdr = i->hdr;
+    hdr.payload_len = static_cast<uint32_t>(last ? remaining : max_fragment);
+    if (!last) {
+      hdr.operation = basp::dispatch_fragment;
+    }
+    auto& buf = wr_buf(ctx.hdl);
+    auto first = buf.size();
+    binary_serializer bs{std::back_inserter(buf), &m_namespace};
+    auto flags = static_cast<uint8_t>(
+      (i->credit ? basp::credit_flag : 0)
+      | (last && i->compressed ? basp::compressed_flag : 0));
+    write(bs, hdr, ctx.remote_id, flags, last ? &i->trace : nullptr);
+    if (i->credit) {
+      ctx.in_flight += buf.size() - first + hdr.payload_len;
+    }
+    // the stream refers to the serialized message instead of copying it
+    broker::write(ctx.hdl, i->payload, i->offset, hdr.payload_len);
+    i->offset += hdr.payload_len;
+    if (last) {
+      i = ctx.transfers.erase(i);
+    } else {
+      ++i;
+    }
+  }
+  flush(ctx.hdl);
+  if (ctx.transfers.empty()) {
+    ack_writes(ctx.hdl, false);
+  }
+}
+
+void basp_broker::resume(const node_id& nid) {
+  auto owner = find_owner(nid);
+  if (owner.first == this) {
+    if (owner.second->held) {
+      drain(*owner.second);
+    }
+  } else if (owner.first) {
+    // credit for messages sent by another broker
+    intrusive_ptr<basp_broker> bro = owner.first;
+    bro->broker::backend().post([=] {
+      bro->resume(nid);
+    });
+  }
+}
+
+bool basp_broker::read(binary_deserializer& bd, basp::header& msg,
+                       connection_context& ctx) {
+  uint8_t flags = 0;
+  bd.read(flags)
     .read(msg.source_actor)
     .read(msg.dest_actor)
     .read(msg.payload_len)
     .read(msg.operation)
     .read(msg.operation_data);
+  if (!basp::valid_flags(flags)) {
+    return false;
+  }
+  ctx.frame_credit = 0;
+  if (flags & basp::credit_flag) {
+    if (msg.operation != basp::dispatch_message
+        && msg.operation != basp::dispatch_fragment) {
+      return false;
+    }
+    ctx.frame_credit = basp::header_size(flags);
+  }
+  ctx.frame_compressed = (flags & basp::compressed_flag) != 0;
+  if (ctx.frame_compressed && msg.operation != basp::dispatch_message
+      && msg.operation != basp::server_handshake
+      && msg.operation != basp::client_handshake) {
+    return false;
+  }
+  if ((flags & basp::trace_flag) != 0
+      && msg.operation != basp::dispatch_message) {
+    return false;
+  }
+  auto decode = [&](basp::node_encoding encoding, node_id& nid) -> bool {
+    switch (encoding) {
+      case basp::invalid_node_encoding:
+        nid = invalid_node_id;
+        return true;
+      case basp::sender_node_encoding:
+        // aliases are not available until the handshake is done
+        nid = ctx.remote_id;
+        return nid != invalid_node_id;
+      case basp::receiver_node_encoding:
+        nid = node();
+        return true;
+      default:
+        bd.read(nid, m_meta_id_type);
+        return true;
+    }
+  };
+  if (!decode(basp::source_encoding(flags), msg.source_node)
+      || !decode(basp::dest_encoding(flags), msg.dest_node)) {
+    return false;
+  }
+  ctx.frame_trace = trace_context{0, 0, 0, false};
+  if (flags & basp::trace_flag) {
+    bd.read(ctx.frame_trace.trace_id)
+      .read(ctx.frame_trace.span_id)
+      .read(ctx.frame_trace.parent_id);
+    ctx.frame_trace.sampled = true;
+  }
+  return true;
 }
 
-void basp_broker::write(binary_serializer& bs, const basp::header& msg) {
-  bs.write(msg.source_node, m_meta_id_type)
-    .write(msg.dest_node, m_meta_id_type)
+void basp_broker::write(binary_serializer& bs, const basp::header& msg,
+                        const node_id& remote, uint8_t extra_flags,
+                        const trace_context* trace) {
+  auto traced = trace != nullptr && trace->sampled;
+  auto flags = static_cast<uint8_t>(basp::make_flags(msg, node(), remote)
+                                    | extra_flags
+                                    | (traced ? basp::trace_flag : 0));
+  bs.write(flags)
     .write(msg.source_actor)
     .write(msg.dest_actor)
     .write(msg.payload_len)
     .write(msg.operation)
     .write(msg.operation_data);
+  if (basp::source_encoding(flags) == basp::full_node_encoding) {
+    bs.write(msg.source_node, m_meta_id_type);
+  }
+  if (basp::dest_encoding(flags) == basp::full_node_encoding) {
+    bs.write(msg.dest_node, m_meta_id_type);
+  }
+  if (traced) {
+    bs.write(trace->trace_id)
+      .write(trace->span_id)
+      .write(trace->parent_id);
+  }
+}
+
+node_id basp_broker::peer(connection_handle hdl) const {
+  auto i = m_ctx.find(hdl);
+  if (i == m_ctx.end()) {
+    return invalid_node_id;
+  }
+  return i->second.remote_id;
 }
 
 basp_broker::connection_state
@@ -430,24 +1257,41 @@ basp_broker::handle_basp_header(connection_context& ctx,
   // that msg is a server_handshake
   if (hdr.dest_node != invalid_node_id && hdr.dest_node != node()) {
     auto route = get_route(hdr.dest_node);
+    intrusive_ptr<basp_broker> owner;
     if (route.invalid()) {
-      CAF_LOG_INFO("cannot forward message: no route to node "
-                   << to_string(hdr.dest_node));
-      parent().notify<hook::message_forwarding_failed>(hdr.source_node,
-                                                       hdr.dest_node, payload);
+      // the route may use a connection of another broker
+      owner = find_owner(hdr.dest_node).first;
+      if (!owner || owner == this) {
+        CAF_LOG_INFO("cannot forward message: no route to node "
+                     << to_string(hdr.dest_node));
+        parent().notify<hook::message_forwarding_failed>(hdr.source_node,
+                                                         hdr.dest_node,
+                                                         payload);
+        return close_connection;
+      }
+    }
+    if (ctx.frame_compressed) {
+      CAF_LOG_INFO("received compressed message for another node");
       return close_connection;
     }
-    CAF_LOG_DEBUG("received message that is not addressed to us -> "
-                  << "forward via " << to_string(route.node));
-    auto& buf = wr_buf(route.hdl);
-    binary_serializer bs{std::back_inserter(buf), &m_namespace};
-    write(bs, hdr);
-    if (payload) {
-      buf.insert(buf.end(), payload->begin(), payload->end());
+    if (owner) {
+      CAF_LOG_DEBUG("received message that is not addressed to us -> "
+                    << "forward via owner of " << to_string(hdr.dest_node));
+      auto trace = ctx.frame_trace;
+      auto bytes = payload ? *payload : buffer_type{};
+      auto has_payload = payload != nullptr;
+      owner->broker::backend().post([=] {
+        auto next = owner->get_route(hdr.dest_node);
+        if (next.invalid()) {
+          CAF_LOG_INFO("cannot forward message: no route to node "
+                       << to_string(hdr.dest_node));
+          return;
+        }
+        owner->forward(next, hdr, has_payload ? &bytes : nullptr, trace);
+      });
+      return await_header;
     }
-    flush(route.hdl);
-    parent().notify<hook::message_forwarded>(hdr.source_node,
-                                             hdr.dest_node, payload);
+    forward(route, hdr, payload, ctx.frame_trace);
     return await_header;
   }
   // handle a message that is addressed to us
@@ -457,10 +1301,74 @@ basp_broker::handle_basp_header(connection_context& ctx,
       throw std::logic_error("invalid operation");
     case basp::dispatch_message: {
       CAF_REQUIRE(payload != nullptr);
-      binary_deserializer bd{payload->data(), payload->size(), &m_namespace};
+      auto bytes = payload;
+      auto i = ctx.fragments.empty()
+               ? ctx.fragments.end()
+               : ctx.fragments.find(fragment_key{hdr.source_node,
+                                                 hdr.source_actor,
+                                                 hdr.dest_actor});
+      if (i != ctx.fragments.end()) {
+        // the last fragment completes the message
+        if (i->second.size() + payload->size() > max_msg_size()) {
+          CAF_LOG_INFO("received fragmented message exceeding max_msg_size");
+          return close_connection;
+        }
+        ctx.fragment_bytes -= i->second.size();
+        i->second.insert(i->second.end(), payload->begin(), payload->end());
+        bytes = &i->second;
+      }
+      auto wire_size = bytes->size();
+      if (ctx.frame_compressed) {
+        m_codec_buf.clear();
+        if (!network::lz_codec::decompress(bytes->data(), bytes->size(),
+                                           m_codec_buf, max_msg_size())) {
+          CAF_LOG_INFO("received malformed compressed message");
+          return close_connection;
+        }
+        bytes = &m_codec_buf;
+      }
       message content;
+      binary_deserializer bd{bytes->data(), bytes->size(), &m_namespace};
       bd.read(content, m_meta_msg);
-      local_dispatch(ctx.hdr, std::move(content));
+      if (i != ctx.fragments.end()) {
+        ctx.fragments.erase(i);
+      }
+      { // the receiver handles the message as part of its trace
+        scoped_trace hop{ctx.frame_trace};
+        parent().notify<hook::payload_received>(hdr.source_node, content,
+                                                wire_size);
+        local_dispatch(ctx.hdr, std::move(content));
+      }
+      collect_credit(ctx, 1);
+      break;
+    }
+    case basp::dispatch_fragment: {
+      CAF_REQUIRE(payload != nullptr);
+      auto& buf = ctx.fragments[fragment_key{hdr.source_node,
+                                             hdr.source_actor,
+                                             hdr.dest_actor}];
+      // peers must not make us buffer an unbounded number of bytes
+      if (buf.size() + payload->size() > max_msg_size()
+          || ctx.fragment_bytes + payload->size() > max_reassembly_size()) {
+        CAF_LOG_INFO("reassembly limit exceeded");
+        return close_connection;
+      }
+      buf.insert(buf.end(), payload->begin(), payload->end());
+      ctx.fragment_bytes += payload->size();
+      collect_credit(ctx, 0);
+      break;
+    }
+    case basp::grant_credit: {
+      CAF_REQUIRE(payload == nullptr);
+      auto bytes = static_cast<size_t>(hdr.operation_data >> 32);
+      auto num = static_cast<size_t>(hdr.operation_data & 0xFFFFFFFF);
+      ctx.in_flight -= std::min(ctx.in_flight, bytes);
+      auto ptr = m_namespace.get(hdr.source_node, hdr.source_actor);
+      auto fwd = dynamic_cast<forwarding_actor_proxy*>(ptr.get());
+      if (fwd) {
+        fwd->grant(num);
+      }
+      resume(hdr.source_node);
       break;
     }
     case basp::announce_proxy_instance: {
@@ -472,12 +1380,11 @@ basp_broker::handle_basp_header(connection_context& ctx,
       if (entry.second != exit_reason::not_exited) {
         send_kill_proxy_instance(nid, aid, entry.second);
       } else {
-        auto mm = middleman::instance();
+        intrusive_ptr<basp_broker> bro = this;
         entry.first->attach_functor([=](uint32_t reason) {
-          mm->backend().dispatch([=] {
+          bro->broker::backend().dispatch([=] {
             CAF_LOGM_TRACE("handle_basp_header$proxy_functor",
                          CAF_ARG(reason));
-            auto bro = mm->get_named_broker<basp_broker>(atom("_BASP"));
             bro->send_kill_proxy_instance(nid, aid, reason);
           });
         });
@@ -503,17 +1410,54 @@ basp_broker::handle_basp_header(connection_context& ctx,
         return close_connection;
       }
       ctx.remote_id = hdr.source_node;
+      ctx.compress = ctx.frame_compressed && compression_threshold() > 0;
       if (node() == ctx.remote_id) {
         CAF_LOG_INFO("incoming connection from self");
         return close_connection;
       }
-      else if (!try_set_default_route(ctx.remote_id, ctx.hdl)) {
+      if (hdr.operation_data != 0) {
+        // an additional connection of a client we are connected to
+        if (!add_lane(ctx.remote_id, hdr.operation_data, ctx.hdl)) {
+          CAF_LOG_INFO("lane " << hdr.operation_data << " already in use");
+          return close_connection;
+        }
+        if (get_route(ctx.remote_id).invalid()) {
+          // the first connection of the client is handled by another
+          // broker or has not completed its handshake yet
+          m_routes[ctx.remote_id].second.insert({ctx.hdl, ctx.remote_id});
+        }
+        dispatch(ctx.hdl, basp::lane_confirmation, node(), invalid_actor_id,
+                 ctx.remote_id, invalid_actor_id, hdr.operation_data);
+        break;
+      }
+      if (!try_set_default_route(ctx.remote_id, ctx.hdl)) {
         CAF_LOG_INFO("multiple incoming connections from the same node");
         return close_connection;
       }
+      // we only receive messages via this connection if another broker
+      // has a route to the client already
+      claim(ctx.remote_id);
       parent().notify<hook::new_connection_established>(ctx.remote_id );
       break;
     }
+    case basp::lane_confirmation: {
+      CAF_REQUIRE(payload == nullptr);
+      auto& hd = ctx.handshake_data;
+      if (!hd || hd->lane != hdr.operation_data) {
+        CAF_LOG_INFO("received unexpected lane confirmation");
+        return close_connection;
+      }
+      auto nid = hd->peer;
+      auto lane = hd->lane;
+      hd = none;
+      if (m_lane_setups.count(nid) == 0) {
+        CAF_LOG_INFO("first connection closed before lane " << lane
+                     << " became ready");
+        return close_connection;
+      }
+      lane_done(nid, ctx.hdl, lane);
+      break;
+    }
     case basp::server_handshake: {
       CAF_REQUIRE(payload != nullptr);
       if (!ctx.handshake_data) {
@@ -524,7 +1468,36 @@ basp_broker::handle_basp_header(connection_context& ctx,
         CAF_LOG_INFO("tried to connect to a node with different BASP version");
         return close_connection;
       }
+      auto fallback = ctx.handshake_data->fallback;
+      if (!fallback.invalid()) {
+        if (hdr.source_node != ctx.handshake_data->peer) {
+          CAF_LOG_INFO("local socket connected to a different node");
+          return close_connection;
+        }
+        // the local socket reached the same node, drop the TCP connection
+        ctx.handshake_data->fallback = connection_handle{};
+        auto i = m_ctx.find(fallback);
+        if (i != m_ctx.end()) {
+          close(fallback);
+          m_ctx.erase(i);
+        }
+      }
       ctx.remote_id = hdr.source_node;
+      // accept compression offered by the server unless it runs on this host
+      ctx.compress = ctx.frame_compressed && compression_threshold() > 0
+                     && ctx.handshake_data->port != 0;
+      if (ctx.handshake_data->lane != 0) {
+        // an additional connection, await confirmation from the server
+        auto& hd = *ctx.handshake_data;
+        if (hd.peer != ctx.remote_id) {
+          CAF_LOG_INFO("lane connected to a different node");
+          return close_connection;
+        }
+        dispatch(ctx.hdl, basp::client_handshake, node(), invalid_actor_id,
+                 hd.peer, invalid_actor_id, hd.lane, nullptr,
+                 ctx.compress ? basp::compressed_flag : 0);
+        return await_header;
+      }
       binary_deserializer bd{payload->data(), payload->size(), &m_namespace};
       auto remote_aid = bd.read<uint32_t>();
       auto remote_ifs_size = bd.read<uint32_t>();
@@ -533,6 +1506,7 @@ basp_broker::handle_basp_header(connection_context& ctx,
         auto str = bd.read<string>();
         remote_ifs.insert(std::move(str));
       }
+      auto local_path = bd.read<string>();
       auto& ifs = ctx.handshake_data->expected_ifs;
       auto hsclient = ctx.handshake_data->client;
       auto hsid = ctx.handshake_data->request_id;
@@ -587,27 +1561,92 @@ basp_broker::handle_basp_header(connection_context& ctx,
         ctx.handshake_data = none;
         return close_connection;
       }
-      if (!try_set_default_route(nid, ctx.hdl)) {
-        CAF_LOG_INFO("multiple connections to " << to_string(nid)
-                     << " (re-use old one)");
-        auto proxy = m_namespace.get_or_put(nid, remote_aid);
-        // discard this peer; there's already an open connection
-        send(hsclient, ok_atom{}, hsid, proxy->address());
-        ctx.handshake_data = none;
-        return close_connection;
+      if (!local_path.empty() && prefer_local_transport()
+          && ctx.handshake_data->port != 0
+          && nid.host_id() == node().host_id()
+          && m_routes.count(nid) == 0 && !find_owner(nid).first) {
+        // the server runs on this host, hence we repeat the handshake
+        // using its Unix domain socket and keep the TCP connection open
+        // until the server responded on the local socket
+        connection_handle local_hdl;
+        try {
+          local_hdl = connect_local(local_path);
+        }
+        catch (network_error& e) {
+          CAF_LOG_INFO("unable to use Unix domain socket: " << e.what());
+          static_cast<void>(e); // keep compiler happy w/o logging
+        }
+        if (!local_hdl.invalid()) {
+          CAF_LOG_DEBUG("switch to Unix domain socket " << local_path);
+          auto& local_ctx = m_ctx[local_hdl];
+          local_ctx.hdl = local_hdl;
+          local_ctx.handshake_data = ctx.handshake_data;
+          local_ctx.handshake_data->host = local_path;
+          local_ctx.handshake_data->port = 0;
+          local_ctx.handshake_data->peer = nid;
+          local_ctx.handshake_data->fallback = ctx.hdl;
+          local_ctx.handshake_data->remote_aid = remote_aid;
+          init_handshake_as_client(local_ctx);
+          return await_local_handshake;
+        }
       }
-      // finalize handshake
-      dispatch(ctx.hdl, basp::client_handshake,
-               node(), invalid_actor_id, nid, invalid_actor_id);
-      // prepare to receive messages
-      auto proxy = m_namespace.get_or_put(nid, remote_aid);
-      ctx.published_actor = proxy;
+      return finish_client_handshake(ctx, nid, remote_aid);
+    }
+  }
+  return await_header;
+}
+
+void basp_broker::forward(const connection_info& route,
+                          const basp::header& hdr, const buffer_type* payload,
+                          const trace_context& trace) {
+  CAF_LOG_DEBUG("received message that is not addressed to us -> "
+                << "forward via " << to_string(route.node));
+  auto& buf = wr_buf(route.hdl);
+  binary_serializer bs{std::back_inserter(buf), &m_namespace};
+  write(bs, hdr, peer(route.hdl), 0, &trace);
+  if (payload) {
+    buf.insert(buf.end(), payload->begin(), payload->end());
+  }
+  flush(route.hdl);
+  scoped_trace hop{trace};
+  parent().notify<hook::message_forwarded>(hdr.source_node,
+                                           hdr.dest_node, payload);
+}
+
+basp_broker::connection_state
+basp_broker::finish_client_handshake(connection_context& ctx,
+                                     const node_id& nid, actor_id remote_aid) {
+  CAF_LOG_TRACE(CAF_TSARG(nid) << ", " << CAF_ARG(remote_aid));
+  auto hsclient = ctx.handshake_data->client;
+  auto hsid = ctx.handshake_data->request_id;
+  // a connection to `nid` handled by another broker counts as well
+  if (claim(nid).first != this || !try_set_default_route(nid, ctx.hdl)) {
+    CAF_LOG_INFO("multiple connections to " << to_string(nid)
+                 << " (re-use old one)");
+    auto proxy = m_namespace.get_or_put(nid, remote_aid);
+    // discard this peer; there's already an open connection
+    auto i = m_lane_setups.find(nid);
+    if (i != m_lane_setups.end()) {
+      // reply once the lanes of the existing connection are ready
+      i->second.clients.emplace_back(hsclient, hsid);
+    } else {
       send(hsclient, ok_atom{}, hsid, proxy->address());
-      ctx.handshake_data = none;
-      parent().notify<hook::new_connection_established>(nid);
-      break;
     }
+    ctx.handshake_data = none;
+    return close_connection;
   }
+  // finalize handshake
+  dispatch(ctx.hdl, basp::client_handshake,
+           node(), invalid_actor_id, nid, invalid_actor_id, 0, nullptr,
+           ctx.compress ? basp::compressed_flag : 0);
+  // prepare to receive messages
+  auto proxy = m_namespace.get_or_put(nid, remote_aid);
+  ctx.published_actor = proxy;
+  if (!open_lanes(nid, *ctx.handshake_data, proxy->address())) {
+    send(hsclient, ok_atom{}, hsid, proxy->address());
+  }
+  ctx.handshake_data = none;
+  parent().notify<hook::new_connection_established>(nid);
   return await_header;
 }
 
@@ -617,6 +1656,14 @@ void basp_broker::send_kill_proxy_instance(const node_id& nid, actor_id aid,
   auto route_node = dispatch(basp::kill_proxy_instance, node(), aid,
                              nid, invalid_actor_id, reason);
   if (route_node == invalid_node_id) {
+    intrusive_ptr<basp_broker> owner = find_owner(nid).first;
+    if (owner && owner != this) {
+      // the connection we got the announcement from has been closed
+      owner->broker::backend().post([=] {
+        owner->send_kill_proxy_instance(nid, aid, reason);
+      });
+      return;
+    }
     CAF_LOG_INFO("message dropped, no route to node: " << to_string(nid));
   }
 }
@@ -649,8 +1696,11 @@ actor_proxy_ptr basp_broker::make_proxy(const node_id& nid, actor_id aid) {
   // we need to tell remote side we are watching this actor now;
   // use a direct route if possible, i.e., when talking to a third node
   auto route = get_route(nid);
-  if (route.invalid()) {
-    // this happens if and only if we don't have a path to `nid`
+  // all proxies of a node send their messages via the broker owning
+  // it, whereas we may receive messages from it via any broker
+  auto owner = route.invalid() ? find_owner(nid) : claim(nid);
+  if (!owner.first) {
+    // this happens if no broker has a path to `nid`
     // and m_current_context->hdl has been blacklisted
     CAF_LOG_INFO("cannot create a proxy instance for an actor "
            "running on a node we don't have a route to");
@@ -658,24 +1708,68 @@ actor_proxy_ptr basp_broker::make_proxy(const node_id& nid, actor_id aid) {
   }
   // create proxy and add functor that will be called if we
   // receive a kill_proxy_instance message
-  intrusive_ptr<basp_broker> self = this;
-  auto mm = middleman::instance();
-  auto res = make_counted<forwarding_actor_proxy>(aid, nid, self);
+  intrusive_ptr<basp_broker> mgr = owner.first;
+  auto res = make_counted<forwarding_actor_proxy>(aid, nid, mgr, owner.second,
+                                                 actor_credit(),
+                                                 on_backpressure());
   res->attach_functor([=](uint32_t) {
-    mm->backend().dispatch([=] {
+    mgr->broker::backend().dispatch([=] {
       // using res->id() instead of aid keeps this actor instance alive
       // until the original instance terminates, thus preventing subtle
       // bugs with attachables
-      erase_proxy(nid, res->id());
+      mgr->erase_proxy(nid, res->id());
     });
   });
   // tell remote side we are monitoring this actor now
-  dispatch(route.hdl, basp::announce_proxy_instance,
-           node(), invalid_actor_id, nid, aid);
+  if (!route.invalid()) {
+    dispatch(route.hdl, basp::announce_proxy_instance,
+             node(), invalid_actor_id, nid, aid);
+  } else {
+    mgr->broker::backend().post([=] {
+      mgr->dispatch(basp::announce_proxy_instance, mgr->node(),
+                    invalid_actor_id, nid, aid);
+    });
+  }
   parent().notify<hook::new_remote_actor>(res->address());
   return res;
 }
 
+void basp_broker::drain(outbound_queue_impl& queue) {
+  CAF_PUSH_AID(id());
+  CAF_LOG_TRACE("");
+  if (queue.closed()) {
+    // the remote node has been lost since the wakeup
+    return;
+  }
+  if (planned_exit_reason() != exit_reason::not_exited) {
+    CAF_LOG_DEBUG("broker already finished execution, drop messages");
+    queue.held.reset();
+    queue.close();
+    return;
+  }
+  do {
+    auto ptr = std::move(queue.held);
+    if (!ptr) {
+      ptr = queue.try_pop();
+    }
+    for (; ptr != nullptr; ptr = queue.try_pop()) {
+      try {
+        scoped_trace sender_trace{ptr->trace};
+        if (!try_dispatch(ptr->sender, ptr->receiver, ptr->mid, ptr->msg,
+                          true, ptr->flow_controlled)) {
+          // the queue stays awake until grant_credit resumes it
+          queue.held = std::move(ptr);
+          return;
+        }
+      }
+      catch (std::exception& e) {
+        CAF_LOG_ERROR("unable to dispatch message: " << to_verbose_string(e));
+        static_cast<void>(e); // keep compiler happy when compiling w/o logging
+      }
+    }
+  } while (!queue.try_block());
+}
+
 void basp_broker::erase_proxy(const node_id& nid, actor_id aid) {
   CAF_LOGM_TRACE("make_behavior$_DelProxy",
                  CAF_TSARG(nid) << ", " << CAF_ARG(aid));
@@ -705,16 +1799,167 @@ bool basp_broker::try_set_default_route(const node_id& nid,
   return false;
 }
 
+bool basp_broker::open_lanes(const node_id& nid,
+                             const client_handshake_data& hd,
+                             const actor_addr& result) {
+  CAF_LOG_TRACE(CAF_TSARG(nid));
+  auto num = connections_per_peer() - 1;
+  auto bulk = bulk_connection_threshold() > 0;
+  if (num == 0 && !bulk) {
+    return false;
+  }
+  auto& setup = m_lane_setups[nid];
+  setup.pending = num + (bulk ? 1 : 0);
+  setup.result = result;
+  setup.clients.emplace_back(hd.client, hd.request_id);
+  auto open = [&](uint64_t lane) {
+    client_handshake_data lhd{0, invalid_actor, std::set<std::string>(),
+                              hd.host, hd.port, lane, nid,
+                              connection_handle{}, invalid_actor_id};
+    connection_handle hdl;
+    try {
+      if (hd.port != 0) {
+        hdl = add_tcp_scribe_async(hd.host, hd.port);
+        m_pending_connections[hdl] = std::move(lhd);
+        return;
+      }
+      hdl = connect_local(hd.host);
+    }
+    catch (network_error& e) {
+      CAF_LOG_INFO("unable to open lane: " << e.what());
+      static_cast<void>(e); // keep compiler happy w/o logging
+      lane_done(nid, connection_handle{}, lane);
+      return;
+    }
+    auto& ctx = m_ctx[hdl];
+    ctx.hdl = hdl;
+    ctx.handshake_data = std::move(lhd);
+    init_handshake_as_client(ctx);
+  };
+  for (uint64_t lane = 1; lane <= num; ++lane) {
+    open(lane);
+  }
+  if (bulk) {
+    open(basp::bulk_lane);
+  }
+  return true;
+}
+
+bool basp_broker::add_lane(const node_id& nid, uint64_t lane,
+                           connection_handle hdl) {
+  CAF_LOG_TRACE(CAF_TSARG(nid) << ", " << CAF_ARG(lane));
+  auto& ls = m_lanes[nid];
+  if (lane == basp::bulk_lane) {
+    if (!ls.bulk.invalid()) {
+      return false;
+    }
+    ls.bulk = hdl;
+    return true;
+  }
+  auto pos = static_cast<size_t>(lane - 1);
+  if (ls.lanes.size() <= pos) {
+    ls.lanes.resize(pos + 1);
+  }
+  if (!ls.lanes[pos].invalid()) {
+    return false;
+  }
+  ls.lanes[pos] = hdl;
+  return true;
+}
+
+void basp_broker::lane_done(const node_id& nid, connection_handle hdl,
+                            uint64_t lane) {
+  CAF_LOG_TRACE(CAF_TSARG(nid) << ", " << CAF_MARG(hdl, id)
+                << ", " << CAF_ARG(lane));
+  auto i = m_lane_setups.find(nid);
+  if (i == m_lane_setups.end()) {
+    return;
+  }
+  if (!hdl.invalid()) {
+    add_lane(nid, lane, hdl);
+  }
+  if (--i->second.pending > 0) {
+    return;
+  }
+  for (auto& c : i->second.clients) {
+    send(c.first, ok_atom{}, c.second, i->second.result);
+  }
+  m_lane_setups.erase(i);
+}
+
+void basp_broker::abort_lane(connection_context& ctx) {
+  if (ctx.handshake_data && ctx.handshake_data->lane != 0) {
+    auto nid = ctx.handshake_data->peer;
+    auto lane = ctx.handshake_data->lane;
+    ctx.handshake_data = none;
+    lane_done(nid, connection_handle{}, lane);
+  }
+}
+
+void basp_broker::fall_back_to_tcp(connection_context& ctx) {
+  if (!ctx.handshake_data || ctx.handshake_data->fallback.invalid()) {
+    return;
+  }
+  auto nid = ctx.handshake_data->peer;
+  auto remote_aid = ctx.handshake_data->remote_aid;
+  auto i = m_ctx.find(ctx.handshake_data->fallback);
+  if (i == m_ctx.end()) {
+    // the TCP connection has been closed meanwhile
+    ctx.handshake_data->fallback = connection_handle{};
+    return;
+  }
+  CAF_LOG_INFO("handshake on local socket failed, fall back to TCP");
+  ctx.handshake_data = none;
+  auto& tcp_ctx = i->second;
+  tcp_ctx.state = finish_client_handshake(tcp_ctx, nid, remote_aid);
+  if (tcp_ctx.state == close_connection) {
+    close(tcp_ctx.hdl);
+    m_ctx.erase(i);
+  }
+}
+
+connection_handle basp_broker::select_lane(connection_handle primary,
+                                           const node_id& nid, actor_id src,
+                                           actor_id dest, bool bulk) {
+  auto i = m_lanes.find(nid);
+  if (i == m_lanes.end()) {
+    return primary;
+  }
+  auto& ls = i->second;
+  if (bulk && !ls.bulk.invalid()) {
+    return ls.bulk;
+  }
+  // map each pair of actors to the same connection to keep their
+  // messages in order; index 0 denotes the first connection
+  auto key = ((static_cast<uint64_t>(src) << 32) | dest)
+             * 0x9E3779B97F4A7C15ull;
+  auto pos = static_cast<size_t>((key >> 32) % (ls.lanes.size() + 1));
+  if (pos == 0 || ls.lanes[pos - 1].invalid()) {
+    return primary;
+  }
+  return ls.lanes[pos - 1];
+}
+
+connection_handle basp_broker::connect_local(std::string path) {
+  if (strip_shared_memory_prefix(path)) {
+    return add_shm_scribe(path);
+  }
+  return add_unix_scribe(path);
+}
+
 void basp_broker::init_handshake_as_client(connection_context& ctx) {
   CAF_LOG_TRACE(CAF_ARG(this));
   ctx.state = await_server_handshake;
-  configure_read(ctx.hdl, receive_policy::exactly(basp::header_size));
+  configure_read(ctx.hdl, receive_policy::at_most(basp::read_ahead_size));
 }
 
 void basp_broker::init_handshake_as_server(connection_context& ctx,
-                                           actor_addr addr) {
+                                           actor_addr addr,
+                                           const std::string& local_path) {
   CAF_LOG_TRACE(CAF_ARG(this));
   CAF_REQUIRE(node() != invalid_node_id);
+  // offer compression to the client
+  uint8_t flags = compression_threshold() > 0 ? basp::compressed_flag : 0;
   if (addr != invalid_actor_addr) {
     auto writer = make_payload_writer([&](binary_serializer& sink) {
       sink << addr.id();
@@ -723,16 +1968,19 @@ void basp_broker::init_handshake_as_server(connection_context& ctx,
       for (auto& sig : sigs) {
         sink << sig;
       }
+      sink << local_path;
     });
     dispatch(ctx.hdl, basp::server_handshake, node(), addr.id(),
-             invalid_node_id, invalid_actor_id, basp::version, &writer);
+             invalid_node_id, invalid_actor_id, basp::version, &writer,
+             flags);
   } else {
     dispatch(ctx.hdl, basp::server_handshake, node(), invalid_actor_id,
-             invalid_node_id, invalid_actor_id, basp::version);
+             invalid_node_id, invalid_actor_id, basp::version, nullptr,
+             flags);
   }
   // prepare for receiving client handshake
   ctx.state = await_client_handshake;
-  configure_read(ctx.hdl, receive_policy::exactly(basp::header_size));
+  configure_read(ctx.hdl, receive_policy::at_most(basp::read_ahead_size));
 }
 
 void basp_broker::add_published_actor(accept_handle hdl,
@@ -742,12 +1990,16 @@ void basp_broker::add_published_actor(accept_handle hdl,
   if (!ptr) {
     return;
   }
-  CAF_LOG_TRACE("");
   m_acceptors.insert(std::make_pair(hdl, std::make_pair(ptr, port)));
-  m_open_ports.insert(std::make_pair(port, hdl));
-  ptr->attach_functor([port](abstract_actor* self, uint32_t) {
-    unpublish_impl(self->address(), port, false);
-  });
+  if (port != 0) {
+    m_open_ports.insert(std::make_pair(port, hdl));
+  }
+  if (is_first()) {
+    // other brokers share the doorman of the first one
+    ptr->attach_functor([port](abstract_actor* self, uint32_t) {
+      unpublish_impl(self->address(), port, false);
+    });
+  }
   if (ptr->node() == node()) {
     singletons::get_actor_registry()->put(ptr->id(), ptr);
   }
@@ -761,7 +2013,9 @@ bool basp_broker::remove_published_actor(const abstract_actor_ptr& whom) {
     if (i->second.first == whom) {
       close(i->first);
       m_open_ports.erase(i->second.second);
+      m_local_paths.erase(i->first);
       i = m_acceptors.erase(i);
+      ++erased_elements;
     }
     else {
       ++i;
@@ -790,7 +2044,17 @@ bool basp_broker::remove_published_actor(const abstract_actor_ptr& whom,
   }
   close(j->first);
   m_open_ports.erase(i);
+  m_local_paths.erase(j->first);
   m_acceptors.erase(j);
+  // close the Unix domain socket accompanying this port as well
+  for (auto k = m_acceptors.begin(); k != m_acceptors.end();) {
+    if (k->second.first == whom && k->second.second == port) {
+      close(k->first);
+      k = m_acceptors.erase(k);
+    } else {
+      ++k;
+    }
+  }
   return true;
 }
 
@@ -93,6 +93,22 @@ void broker::scribe::consume(const void*, size_t num_bytes) {
   flush();                  // implicit flush of wr_buf()
 }
 
+void broker::scribe::data_transferred(size_t num_bytes, size_t remaining) {
+  CAF_LOG_TRACE(CAF_ARG(num_bytes) << ", " << CAF_ARG(remaining));
+  if (m_disconnected) {
+    return;
+  }
+  auto msg = make_message(data_transferred_msg{hdl(), num_bytes, remaining});
+  m_broker->invoke_message(invalid_actor_addr, invalid_message_id, msg);
+}
+
+void broker::scribe::write(const network::shared_buffer_ptr& buf,
+                           size_t offset, size_t num_bytes) {
+  auto first = buf->data() + offset;
+  auto& out = wr_buf();
+  out.insert(out.end(), first, first + num_bytes);
+}
+
 void broker::scribe::io_failure(network::operation op) {
   CAF_LOG_TRACE("id = " << hdl().id()
                 << ", " << CAF_TARG(op, static_cast<int>));
@@ -250,17 +266,30 @@ void broker::write(connection_handle hdl, size_t bs, const void* buf) {
   out.insert(out.end(), first, last);
 }
 
+void broker::write(connection_handle hdl,
+                   const network::shared_buffer_ptr& buf, size_t offset,
+                   size_t num_bytes) {
+  by_id(hdl).write(buf, offset, num_bytes);
+}
+
 void broker::enqueue(const actor_addr& sender, message_id mid, message msg,
                      execution_unit*) {
-  parent().backend().post(continuation{this, sender,
-                                       mid, std::move(msg)});
+  backend().post(continuation{this, sender, mid, std::move(msg)});
+}
+
+broker::broker()
+    : m_mm(*middleman::instance()),
+      m_backend(&m_mm.next_backend()) {
+  // nop
 }
 
-broker::broker() : m_mm(*middleman::instance()) {
+broker::broker(middleman& ptr) : m_mm(ptr), m_backend(&ptr.backend()) {
   // nop
 }
 
-broker::broker(middleman& ptr) : m_mm(ptr) {
+broker::broker(middleman& ptr, network::multiplexer& backend_ref)
+    : m_mm(ptr),
+      m_backend(&backend_ref) {
   // nop
 }
 
@@ -309,6 +338,10 @@ void broker::flush(connection_handle hdl) {
   by_id(hdl).flush();
 }
 
+void broker::ack_writes(connection_handle hdl, bool enable) {
+  by_id(hdl).ack_writes(enable);
+}
+
 broker::buffer_type& broker::wr_buf(connection_handle hdl) {
   return by_id(hdl).wr_buf();
 }
@@ -353,14 +386,15 @@ behavior broker::functor_based::make_behavior() {
   return m_make_behavior(this);
 }
 
-network::multiplexer& broker::backend() {
-  return m_mm.backend();
-}
-
 connection_handle broker::add_tcp_scribe(const std::string& hst, uint16_t prt) {
   return backend().add_tcp_scribe(this, hst, prt);
 }
 
+connection_handle broker::add_tcp_scribe_async(const std::string& hst,
+                                               uint16_t prt) {
+  return backend().add_tcp_scribe_async(this, hst, prt);
+}
+
 void broker::assign_tcp_scribe(connection_handle hdl) {
   backend().assign_tcp_scribe(this, hdl);
 }
@@ -382,5 +416,25 @@ accept_handle broker::add_tcp_doorman(network::native_socket fd) {
   return backend().add_tcp_doorman(this, fd);
 }
 
+connection_handle broker::add_unix_scribe(const std::string& path) {
+  return backend().add_unix_scribe(this, path);
+}
+
+accept_handle broker::add_unix_doorman(const std::string& path) {
+  return backend().add_unix_doorman(this, path);
+}
+
+connection_handle broker::add_shm_scribe(const std::string& path) {
+  return backend().add_shm_scribe(this, path);
+}
+
+void broker::assign_shm_doorman(accept_handle hdl) {
+  backend().assign_shm_doorman(this, hdl);
+}
+
+accept_handle broker::add_shm_doorman(const std::string& path) {
+  return backend().add_shm_doorman(this, path);
+}
+
 } // namespace io
 } // namespace caf
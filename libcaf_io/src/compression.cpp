@@ -0,0 +1,43 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/io/compression.hpp"
+
+#include <atomic>
+
+namespace caf {
+namespace io {
+
+namespace {
+
+std::atomic<size_t> s_compression_threshold{0};
+
+} // namespace <anonymous>
+
+void compression_threshold(size_t num_bytes) {
+  s_compression_threshold = num_bytes;
+}
+
+size_t compression_threshold() {
+  return s_compression_threshold;
+}
+
+} // namespace io
+} // namespace caf
@@ -19,11 +19,23 @@
 
 #include "caf/io/network/default_multiplexer.hpp"
 
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+#include "caf/locks.hpp"
 #include "caf/config.hpp"
 #include "caf/exception.hpp"
+#include "caf/exit_reason.hpp"
 
 #include "caf/io/broker.hpp"
 #include "caf/io/middleman.hpp"
+#include "caf/io/system_messages.hpp"
+
+#include "caf/io/network/shared_memory_stream.hpp"
 
 #ifdef CAF_WINDOWS
 # include <winsock2.h>
@@ -37,6 +49,8 @@
 # include <sys/types.h>
 # include <arpa/inet.h>
 # include <sys/socket.h>
+# include <sys/un.h>
+# include <sys/stat.h>
 # include <netinet/in.h>
 # include <netinet/tcp.h>
 #endif
@@ -221,6 +235,130 @@ namespace network {
 
 #endif
 
+/******************************************************************************
+ *                      asynchronous host name resolution                     *
+ ******************************************************************************/
+
+/**
+ * Resolves host names on a small pool of helper threads, because
+ * `getaddrinfo` blocks and must never run in the event loop.
+ * Successful lookups are cached process-wide for a limited time.
+ */
+class name_resolver {
+ public:
+  // receives an error description (empty on success) and the address
+  using callback = std::function<void (std::string, in_addr)>;
+
+  name_resolver() : m_done(false) {
+    // nop
+  }
+
+  ~name_resolver() {
+    { // lifetime scope of guard
+      std::unique_lock<std::mutex> guard{m_mtx};
+      m_done = true;
+    }
+    m_cv.notify_all();
+    for (auto& t : m_workers) {
+      t.join();
+    }
+  }
+
+  // calls `f` from a helper thread once `host` has been resolved
+  void resolve(std::string host, callback f) {
+    std::unique_lock<std::mutex> guard{m_mtx};
+    if (m_workers.empty()) {
+      for (size_t i = 0; i < num_workers; ++i) {
+        m_workers.emplace_back([=] { run(); });
+      }
+    }
+    m_jobs.emplace_back(std::move(host), std::move(f));
+    m_cv.notify_one();
+  }
+
+  // tries to resolve `host` without calling `getaddrinfo`
+  static bool try_resolve_locally(const std::string& host, in_addr& result) {
+    if (::inet_pton(AF_INET, host.c_str(), &result) == 1) {
+      return true;
+    }
+    std::unique_lock<std::mutex> guard{s_cache_mtx};
+    auto i = s_cache.find(host);
+    if (i == s_cache.end()) {
+      return false;
+    }
+    if (i->second.second < clock_type::now()) {
+      s_cache.erase(i);
+      return false;
+    }
+    result = i->second.first;
+    return true;
+  }
+
+ private:
+  using clock_type = std::chrono::steady_clock;
+  using job = std::pair<std::string, callback>;
+
+  static constexpr size_t num_workers = 2;
+
+  static constexpr std::chrono::seconds cache_ttl() {
+    return std::chrono::seconds{60};
+  }
+
+  void run() {
+    for (;;) {
+      job x;
+      { // lifetime scope of guard
+        std::unique_lock<std::mutex> guard{m_mtx};
+        m_cv.wait(guard, [&] { return m_done || !m_jobs.empty(); });
+        if (m_done) {
+          return;
+        }
+        x = std::move(m_jobs.front());
+        m_jobs.pop_front();
+      }
+      in_addr addr;
+      memset(&addr, 0, sizeof(addr));
+      auto err = lookup(x.first, addr);
+      x.second(std::move(err), addr);
+    }
+  }
+
+  static std::string lookup(const std::string& host, in_addr& result) {
+    CAF_LOGF_TRACE(CAF_ARG(host));
+    if (try_resolve_locally(host, result)) {
+      return {};
+    }
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &res) != 0 || !res) {
+      return "no such host: " + host;
+    }
+    result = reinterpret_cast<sockaddr_in*>(res->ai_addr)->sin_addr;
+    freeaddrinfo(res);
+    std::unique_lock<std::mutex> guard{s_cache_mtx};
+    s_cache[host] = std::make_pair(result, clock_type::now() + cache_ttl());
+    return {};
+  }
+
+  std::mutex m_mtx;
+  std::condition_variable m_cv;
+  bool m_done;
+  std::deque<job> m_jobs;
+  std::vector<std::thread> m_workers;
+
+  static std::mutex s_cache_mtx;
+  static std::map<std::string, std::pair<in_addr, clock_type::time_point>>
+  s_cache;
+};
+
+std::mutex name_resolver::s_cache_mtx;
+
+std::map<std::string, std::pair<in_addr, name_resolver::clock_type::time_point>>
+name_resolver::s_cache;
+
 /******************************************************************************
  *                             epoll() vs. poll()                             *
  ******************************************************************************/
@@ -230,6 +368,10 @@ namespace network {
   // In this implementation, m_shadow is the number of sockets we have
   // registered to epoll.
 
+  // bounds for the number of events fetched by a single epoll_wait()
+  constexpr size_t min_epoll_events = 64;
+  constexpr size_t max_epoll_events = 8192;
+
   default_multiplexer::default_multiplexer()
       : m_epollfd(invalid_native_socket),
         m_shadow(1) {
@@ -239,9 +381,17 @@ namespace network {
       CAF_LOG_ERROR("epoll_create1: " << strerror(errno));
       exit(errno);
     }
-    // handle at most 64 events at a time
-    m_pollset.resize(64);
-    m_pipe = create_pipe();
+    // start with 64 events per epoll_wait(), run() grows the
+    // array whenever the kernel fills it completely
+    m_pollset.resize(min_epoll_events);
+    // a single eventfd serves as both ends of our pipe
+    auto efd = eventfd(0, EFD_CLOEXEC);
+    if (efd < 0) {
+      CAF_LOG_ERROR("eventfd: " << strerror(errno));
+      exit(errno);
+    }
+    m_pipe = std::make_pair(efd, efd);
+    m_dispatch_queue.try_block();
     epoll_event ee;
     ee.events = input_mask;
     ee.data.ptr = nullptr;
@@ -278,11 +428,15 @@ namespace network {
         auto fd = ptr ? ptr->fd() : m_pipe.first;
         handle_socket_event(fd, iter->events, ptr);
       }
-      for (auto& me : m_events) {
-        handle(me);
+      handle_pending_events();
+      // a full batch indicates more pending events, hence we fetch
+      // more events per system call in the next iteration
+      if (static_cast<size_t>(presult) == m_pollset.size()
+          && m_pollset.size() < max_epoll_events) {
+        m_pollset.resize(m_pollset.size() * 2);
       }
-      m_events.clear();
     }
+    close_dispatch_queue();
   }
 
   void default_multiplexer::handle(const default_multiplexer::event& e) {
@@ -367,6 +521,7 @@ namespace network {
     init();
     // initial setup
     m_pipe = create_pipe();
+    m_dispatch_queue.try_block();
     pollfd pipefd;
     pipefd.fd = m_pipe.first;
     pipefd.events = input_mask;
@@ -438,11 +593,9 @@ namespace network {
         handle_socket_event(e.fd, e.mask, e.ptr);
       }
       poll_res.clear();
-      for (auto& me : m_events) {
-        handle(me);
-      }
-      m_events.clear();
+      handle_pending_events();
     }
+    close_dispatch_queue();
   }
 
   void default_multiplexer::handle(const default_multiplexer::event& e) {
@@ -554,29 +707,55 @@ void default_multiplexer::del(operation op, native_socket fd, event_handler* ptr
   new_event(del_flag, op, fd, ptr);
 }
 
-void default_multiplexer::wr_dispatch_request(runnable* ptr) {
-  intptr_t ptrval = reinterpret_cast<intptr_t>(ptr);
+void default_multiplexer::wr_dispatch_request() {
+  // an eventfd requires us to write exactly 8 bytes,
+  // we simply write the same amount to our pipe
+  uint64_t token = 1;
   // on windows, we actually have sockets, otherwise we have file handles
 # ifdef CAF_WINDOWS
-    ::send(m_pipe.second, reinterpret_cast<socket_send_ptr>(&ptrval),
-           sizeof(ptrval), no_sigpipe_flag);
+    ::send(m_pipe.second, reinterpret_cast<socket_send_ptr>(&token),
+           sizeof(token), no_sigpipe_flag);
 # else
-    auto unused = ::write(m_pipe.second, &ptrval, sizeof(ptrval));
+    auto unused = ::write(m_pipe.second, &token, sizeof(token));
     static_cast<void>(unused);
 # endif
 }
 
-default_multiplexer::runnable* default_multiplexer::rd_dispatch_request() {
-  intptr_t ptrval;
+void default_multiplexer::rd_dispatch_request() {
+  uint64_t token;
   // on windows, we actually have sockets, otherwise we have file handles
 # ifdef CAF_WINDOWS
-    ::recv(m_pipe.first, reinterpret_cast<socket_recv_ptr>(&ptrval),
-           sizeof(ptrval), 0);
+    ::recv(m_pipe.first, reinterpret_cast<socket_recv_ptr>(&token),
+           sizeof(token), 0);
 # else
-    auto unused = ::read(m_pipe.first, &ptrval, sizeof(ptrval));
+    auto unused = ::read(m_pipe.first, &token, sizeof(token));
     static_cast<void>(unused);
 # endif
-  return reinterpret_cast<runnable*>(ptrval);;
+  // run all runnables enqueued so far, but not the ones enqueued
+  // by those runnables; otherwise a runnable that posts to the
+  // multiplexer again would prevent us from doing any I/O
+  for (auto n = m_dispatch_queue.count(); n > 0; --n) {
+    auto ptr = m_dispatch_queue.try_pop();
+    ptr->run();
+    ptr->request_deletion();
+  }
+  // signal ourselves if we cannot block the queue, because we would
+  // not receive a signal for elements that are already enqueued
+  if (!m_dispatch_queue.try_block()) {
+    wr_dispatch_request();
+  }
+}
+
+void default_multiplexer::close_dispatch_queue() {
+  if (!m_dispatch_queue.closed()) {
+    m_dispatch_queue.try_unblock();
+    m_dispatch_queue.close();
+  }
+}
+
+bool default_multiplexer::owns(native_socket fd) const {
+  shared_lock<detail::shared_spinlock> guard{m_sockets_mtx};
+  return m_sockets.count(fd) > 0;
 }
 
 default_multiplexer& get_multiplexer_singleton() {
@@ -604,10 +783,41 @@ void default_multiplexer::close_pipe() {
   del(operation::read, m_pipe.first, nullptr);
 }
 
+void default_multiplexer::add_pending_event(const event& e) {
+  auto i = static_cast<size_t>(e.fd);
+  if (i >= m_event_index.size()) {
+    // grow geometrically to keep insertions amortized O(1)
+    m_event_index.resize(std::max(i + 1, m_event_index.size() * 2), 0);
+  }
+  m_events.push_back(e);
+  m_event_index[i] = m_events.size();
+}
+
+void default_multiplexer::erase_pending_event(native_socket fd) {
+  auto i = static_cast<size_t>(fd);
+  auto pos = m_event_index[i] - 1;
+  // move the last element into the gap to avoid shifting all others
+  if (pos != m_events.size() - 1) {
+    m_events[pos] = m_events.back();
+    m_event_index[static_cast<size_t>(m_events[pos].fd)] = pos + 1;
+  }
+  m_events.pop_back();
+  m_event_index[i] = 0;
+}
+
+void default_multiplexer::handle_pending_events() {
+  for (auto& e : m_events) {
+    handle(e);
+  }
+  for (auto& e : m_events) {
+    m_event_index[static_cast<size_t>(e.fd)] = 0;
+  }
+  m_events.clear();
+}
+
 bool default_multiplexer::socket_had_rd_shutdown_event(native_socket fd) {
-  auto last = m_events.end();
-  auto i = std::lower_bound(m_events.begin(), last, fd, event_less{});
-  if (i != last && i->fd == fd) {
+  auto i = pending_event(fd);
+  if (i) {
     // socket is about to be shut down for read if
     // its new bitmask does not have the input_mask flag
     return (i->mask & input_mask) == 0;
@@ -628,9 +838,7 @@ void default_multiplexer::handle_socket_event(native_socket fd, int mask,
     } else {
       CAF_REQUIRE(fd == m_pipe.first);
       CAF_LOG_DEBUG("read message from pipe");
-      auto cb = rd_dispatch_request();
-      cb->run();
-      cb->request_deletion();
+      rd_dispatch_request();
     }
   }
   if (mask & output_mask) {
@@ -672,18 +880,29 @@ void default_multiplexer::init() {
 }
 
 default_multiplexer::~default_multiplexer() {
+  // stop helper threads first, because they post to this multiplexer
+  m_resolver.reset();
 # ifdef CAF_WINDOWS
     WSACleanup();
 # endif
   if (m_epollfd != invalid_native_socket) {
     closesocket(m_epollfd);
   }
+  close_dispatch_queue();
   closesocket(m_pipe.first);
-  closesocket(m_pipe.second);
+  if (m_pipe.second != m_pipe.first) {
+    closesocket(m_pipe.second);
+  }
 }
 
 void default_multiplexer::dispatch_runnable(runnable_ptr ptr) {
-  wr_dispatch_request(ptr.release());
+  // signal the event loop only if it might be waiting for events; the
+  // queue deletes ptr if the loop has already been shut down
+  using detail::enqueue_result;
+  if (m_dispatch_queue.enqueue(ptr.release())
+      == enqueue_result::unblocked_reader) {
+    wr_dispatch_request();
+  }
 }
 
 connection_handle default_multiplexer::add_tcp_scribe(broker* self,
@@ -705,6 +924,10 @@ connection_handle default_multiplexer::add_tcp_scribe(broker* self,
     broker::buffer_type& wr_buf() override {
       return m_stream.wr_buf();
     }
+    void write(const shared_buffer_ptr& buf, size_t offset,
+               size_t num_bytes) override {
+      m_stream.write(buf, offset, num_bytes);
+    }
     broker::buffer_type& rd_buf() override {
       return m_stream.rd_buf();
     }
@@ -717,6 +940,10 @@ connection_handle default_multiplexer::add_tcp_scribe(broker* self,
       CAF_LOGM_TRACE("caf::io::broker::scribe", "");
       m_stream.flush(this);
     }
+    void ack_writes(bool enable) override {
+      CAF_LOGM_TRACE("caf::io::broker::scribe", CAF_ARG(enable));
+      m_stream.ack_writes(enable);
+    }
     void launch() {
       CAF_LOGM_TRACE("caf::io::broker::scribe", "");
       CAF_REQUIRE(!m_launched);
@@ -734,19 +961,42 @@ connection_handle default_multiplexer::add_tcp_scribe(broker* self,
 
 accept_handle default_multiplexer::add_tcp_doorman(broker* self,
                                                    default_socket_acceptor&& sock) {
-  CAF_LOG_TRACE("sock.fd = " << sock.fd());
+  return add_doorman(self, std::move(sock), false);
+}
+
+accept_handle default_multiplexer::add_doorman(broker* self,
+                                               default_socket_acceptor&& sock,
+                                               bool shared_memory) {
+  CAF_LOG_TRACE("sock.fd = " << sock.fd() << ", " << CAF_ARG(shared_memory));
   CAF_REQUIRE(sock.fd() != network::invalid_native_socket);
   class impl : public broker::doorman {
    public:
-    impl(broker* ptr, default_socket_acceptor&& s)
+    impl(broker* ptr, default_socket_acceptor&& s, bool shm)
         : doorman(ptr, network::accept_hdl_from_socket(s)),
+          m_shared_memory(shm),
           m_acceptor(s.backend()) {
       m_acceptor.init(std::move(s));
     }
+    ~impl() {
+      remove_unix_socket_file(m_acceptor.socket_handle().fd());
+    }
     void new_connection() override {
       auto& dm = m_acceptor.backend();
-      accept_msg().handle = dm.add_tcp_scribe(parent(),
-                                              std::move(m_acceptor.accepted_socket()));
+      auto& sock = m_acceptor.accepted_socket();
+      if (!m_shared_memory) {
+        accept_msg().handle = dm.add_tcp_scribe(parent(), std::move(sock));
+      } else {
+        try {
+          accept_msg().handle = dm.add_shm_scribe(parent(), std::move(sock),
+                                                  true);
+        }
+        catch (network_error& e) {
+          // drop the connection, the client fails to receive the segment
+          CAF_LOG_ERROR("unable to set up shared memory: " << e.what());
+          static_cast<void>(e); // keep compiler happy w/o logging
+          return;
+        }
+      }
       parent()->invoke_message(invalid_actor_addr,
                                invalid_message_id,
                                m_accept_msg);
@@ -759,13 +1009,89 @@ accept_handle default_multiplexer::add_tcp_doorman(broker* self,
       m_acceptor.start(this);
     }
    private:
+    bool m_shared_memory;
     network::acceptor<default_socket_acceptor> m_acceptor;
   };
-  broker::doorman_pointer ptr{new impl{self, std::move(sock)}};
+  broker::doorman_pointer ptr{new impl{self, std::move(sock), shared_memory}};
   self->add_doorman(ptr);
   return ptr->hdl();
 }
 
+connection_handle default_multiplexer::add_shm_scribe(broker* self,
+                                                      default_socket&& sock,
+                                                      bool accepted) {
+  CAF_LOG_TRACE("sock.fd = " << sock.fd() << ", " << CAF_ARG(accepted));
+  class impl : public broker::scribe {
+   public:
+    impl(broker* ptr, default_socket&& s, bool is_server)
+        : scribe(ptr, network::conn_hdl_from_socket(s)),
+          m_launched(false),
+          m_stream(s.backend()) {
+      if (is_server) {
+        m_stream.init_as_server(std::move(s));
+      } else {
+        m_stream.init_as_client(std::move(s));
+      }
+    }
+    void configure_read(receive_policy::config config) override {
+      CAF_LOGM_TRACE("caf::io::broker::scribe", "");
+      m_stream.configure_read(config);
+      if (!m_launched) launch();
+    }
+    broker::buffer_type& wr_buf() override {
+      return m_stream.wr_buf();
+    }
+    broker::buffer_type& rd_buf() override {
+      return m_stream.rd_buf();
+    }
+    void stop_reading() override {
+      CAF_LOGM_TRACE("caf::io::broker::scribe", "");
+      m_stream.stop_reading();
+      disconnect(false);
+    }
+    void flush() override {
+      CAF_LOGM_TRACE("caf::io::broker::scribe", "");
+      m_stream.flush(this);
+    }
+    void ack_writes(bool enable) override {
+      CAF_LOGM_TRACE("caf::io::broker::scribe", CAF_ARG(enable));
+      m_stream.ack_writes(enable);
+    }
+    void launch() {
+      CAF_LOGM_TRACE("caf::io::broker::scribe", "");
+      CAF_REQUIRE(!m_launched);
+      m_launched = true;
+      m_stream.start(this);
+    }
+   private:
+    bool m_launched;
+    shared_memory_stream m_stream;
+  };
+  broker::scribe_pointer ptr{new impl{self, std::move(sock), accepted}};
+  self->add_scribe(ptr);
+  return ptr->hdl();
+}
+
+namespace {
+
+// handles returned by `add_tcp_scribe` or `add_tcp_doorman` belong to the
+// multiplexer of the calling broker, whereas handles returned by
+// `new_tcp_scribe` or `new_tcp_doorman` belong to no multiplexer yet
+native_socket unowned_or_local(default_multiplexer* self, int64_t hdl) {
+  auto fd = static_cast<native_socket>(hdl);
+  auto mm = middleman::instance();
+  for (size_t i = 0; i < mm->num_backends(); ++i) {
+    auto other = static_cast<default_multiplexer*>(&mm->backend(i));
+    if (other != self && other->owns(fd)) {
+      throw network_error("cannot assign a handle registered at "
+                          "another multiplexer");
+    }
+  }
+  return fd;
+}
+
+} // namespace <anonymous>
+
 connection_handle default_multiplexer::new_tcp_scribe(const std::string& host,
                                                       uint16_t port) {
   auto fd = new_ipv4_connection_impl(host, port);
@@ -774,7 +1100,7 @@ connection_handle default_multiplexer::new_tcp_scribe(const std::string& host,
 
 void default_multiplexer::assign_tcp_scribe(broker* ptr,
                                             connection_handle hdl) {
-  add_tcp_scribe(ptr, static_cast<native_socket>(hdl.id()));
+  add_tcp_scribe(ptr, unowned_or_local(this, hdl.id()));
 }
 
 connection_handle default_multiplexer::add_tcp_scribe(broker* self,
@@ -785,7 +1111,170 @@ connection_handle default_multiplexer::add_tcp_scribe(broker* self,
 connection_handle default_multiplexer::add_tcp_scribe(broker* self,
                                                       const std::string& host,
                                                       uint16_t port) {
-  return add_tcp_scribe(self, new_ipv4_connection(host, port));
+  return add_tcp_scribe(self, new_ipv4_connection_impl(host, port));
+}
+
+namespace {
+
+// state of an ongoing connection attempt, shared between the helper
+// thread resolving the host name and the event loop; closes the
+// socket on destruction unless it has been passed to a scribe
+struct pending_connection {
+  broker_ptr self;
+  native_socket fd;
+  std::string host;
+  uint16_t port;
+  ~pending_connection() {
+    if (fd != invalid_native_socket) {
+      closesocket(fd);
+    }
+  }
+};
+
+using pending_connection_ptr = std::shared_ptr<pending_connection>;
+
+bool connect_in_progress() {
+# ifdef CAF_WINDOWS
+    return last_socket_error() == WSAEWOULDBLOCK;
+# else
+    return last_socket_error() == EINPROGRESS;
+# endif
+}
+
+// delivers the connection_attempt_msg to the broker; must be
+// called from a runnable, since it might add a new scribe
+void finalize_connection(default_multiplexer& dm,
+                         const pending_connection_ptr& pc, std::string error) {
+  CAF_LOGF_TRACE(CAF_ARG(pc->host) << ", " << CAF_ARG(pc->port)
+                 << ", " << CAF_ARG(error));
+  auto& self = pc->self;
+  if (self->exit_reason() != exit_reason::not_exited
+      || self->planned_exit_reason() != exit_reason::not_exited) {
+    // nobody is interested in the result
+    return;
+  }
+  auto hdl = connection_handle::from_int(int64_from_native_socket(pc->fd));
+  if (error.empty()) {
+    try {
+      auto fd = pc->fd;
+      pc->fd = invalid_native_socket;
+      dm.add_tcp_scribe(self.get(), default_socket{dm, fd});
+    }
+    catch (network_error& e) {
+      error = e.what();
+    }
+  }
+  if (!error.empty()) {
+    CAF_LOGF_INFO("could not connect to " << pc->host << " on port "
+                  << pc->port << ": " << error);
+  }
+  auto success = error.empty();
+  auto msg = make_message(connection_attempt_msg{hdl, success,
+                                                 std::move(error)});
+  self->invoke_message(invalid_actor_addr, invalid_message_id, msg);
+}
+
+// waits for a non-blocking connect() to finish
+class connector : public event_handler {
+ public:
+  connector(default_multiplexer& dm, pending_connection_ptr pc)
+      : event_handler(dm),
+        m_pc(std::move(pc)),
+        m_error("could not connect to host") {
+    // nop
+  }
+
+  native_socket fd() const override {
+    return m_pc->fd;
+  }
+
+  void start() {
+    backend().add(operation::write, fd(), this);
+  }
+
+  void handle_event(operation op) override {
+    if (op == operation::write) {
+      int err = 0;
+      socklen_t len = sizeof(err);
+      if (getsockopt(fd(), SOL_SOCKET, SO_ERROR,
+                     reinterpret_cast<getsockopt_ptr>(&err), &len) == 0
+          && err == 0) {
+        m_error.clear();
+      }
+    }
+    backend().del(operation::write, fd(), this);
+  }
+
+  void removed_from_loop(operation) override {
+    // the multiplexer is still iterating its events at this point,
+    // hence we cannot add the scribe for our socket right away
+    auto& dm = backend();
+    auto pc = m_pc;
+    auto error = m_error;
+    dm.post([=, &dm] { finalize_connection(dm, pc, error); });
+    delete this;
+  }
+
+ private:
+  pending_connection_ptr m_pc;
+  std::string m_error;
+};
+
+// runs in the event loop once the host name has been resolved
+void start_connection(default_multiplexer& dm, const pending_connection_ptr& pc,
+                      const std::string& error, in_addr addr) {
+  if (!error.empty()) {
+    finalize_connection(dm, pc, error);
+    return;
+  }
+  sockaddr_in serv_addr;
+  memset(&serv_addr, 0, sizeof(serv_addr));
+  serv_addr.sin_family = AF_INET;
+  serv_addr.sin_addr = addr;
+  serv_addr.sin_port = htons(pc->port);
+  CAF_LOGF_DEBUG("call non-blocking connect()");
+  if (connect(pc->fd, reinterpret_cast<const sockaddr*>(&serv_addr),
+              sizeof(serv_addr)) == 0) {
+    finalize_connection(dm, pc, "");
+  } else if (connect_in_progress()) {
+    auto ptr = new connector(dm, pc);
+    ptr->start();
+  } else {
+    finalize_connection(dm, pc, "could not connect to host");
+  }
+}
+
+} // namespace <anonymous>
+
+connection_handle
+default_multiplexer::add_tcp_scribe_async(broker* self, const std::string& host,
+                                          uint16_t port) {
+  CAF_LOG_TRACE(CAF_ARG(host) << ", " << CAF_ARG(port));
+  native_socket fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd == invalid_native_socket) {
+    throw network_error("socket creation failed");
+  }
+  auto pc = std::make_shared<pending_connection>();
+  pc->self = self;
+  pc->fd = fd;
+  pc->host = host;
+  pc->port = port;
+  nonblocking(fd, true);
+  auto hdl = connection_handle::from_int(int64_from_native_socket(fd));
+  // the broker receives the result of the attempt only after this
+  // function returned, even if we can connect without a lookup
+  in_addr addr;
+  if (name_resolver::try_resolve_locally(host, addr)) {
+    post([=] { start_connection(*this, pc, "", addr); });
+    return hdl;
+  }
+  if (!m_resolver) {
+    m_resolver.reset(new name_resolver);
+  }
+  m_resolver->resolve(host, [=](std::string error, in_addr resolved) {
+    post([=] { start_connection(*this, pc, error, resolved); });
+  });
+  return hdl;
 }
 
 
@@ -798,7 +1287,7 @@ default_multiplexer::new_tcp_doorman(uint16_t port, const char* in,
 }
 
 void default_multiplexer::assign_tcp_doorman(broker* ptr, accept_handle hdl) {
-  add_tcp_doorman(ptr, static_cast<native_socket>(hdl.id()));
+  add_tcp_doorman(ptr, unowned_or_local(this, hdl.id()));
 }
 
 accept_handle default_multiplexer::add_tcp_doorman(broker* self,
@@ -806,12 +1295,60 @@ accept_handle default_multiplexer::add_tcp_doorman(broker* self,
   return add_tcp_doorman(self, default_socket_acceptor{*this, fd});
 }
 
+accept_handle default_multiplexer::new_shared_doorman(accept_handle hdl) {
+# ifdef CAF_WINDOWS
+    static_cast<void>(hdl);
+    throw network_error("cannot share sockets between multiplexers");
+# else
+    auto fd = fcntl(static_cast<native_socket>(hdl.id()), F_DUPFD_CLOEXEC, 0);
+    if (fd == invalid_native_socket) {
+      throw_io_failure("unable to duplicate socket");
+    }
+    return accept_handle::from_int(int64_from_native_socket(fd));
+# endif
+}
+
 std::pair<accept_handle, uint16_t>
 default_multiplexer::add_tcp_doorman(broker* self, uint16_t port,
                                      const char* host, bool reuse_addr) {
-  auto acceptor = new_ipv4_acceptor(port, host, reuse_addr);
+  auto acceptor = new_ipv4_acceptor_impl(port, host, reuse_addr);
   auto bound_port = acceptor.second;
-  return {add_tcp_doorman(self, std::move(acceptor.first)), bound_port};
+  return {add_tcp_doorman(self, acceptor.first), bound_port};
+}
+
+connection_handle
+default_multiplexer::add_unix_scribe(broker* self, const std::string& path) {
+  return add_tcp_scribe(self, new_unix_connection_impl(path));
+}
+
+accept_handle default_multiplexer::new_unix_doorman(const std::string& path) {
+  auto fd = new_unix_acceptor_impl(path);
+  return accept_handle::from_int(int64_from_native_socket(fd));
+}
+
+accept_handle default_multiplexer::add_unix_doorman(broker* self,
+                                                    const std::string& path) {
+  return add_tcp_doorman(self, new_unix_acceptor_impl(path));
+}
+
+connection_handle
+default_multiplexer::add_shm_scribe(broker* self, const std::string& path) {
+  return add_shm_scribe(self, default_socket{*this,
+                                             new_unix_connection_impl(path)},
+                        false);
+}
+
+void default_multiplexer::assign_shm_doorman(broker* ptr, accept_handle hdl) {
+  add_doorman(ptr, default_socket_acceptor{*this,
+                                           unowned_or_local(this, hdl.id())},
+              true);
+}
+
+accept_handle default_multiplexer::add_shm_doorman(broker* self,
+                                                   const std::string& path) {
+  return add_doorman(self, default_socket_acceptor{*this,
+                                                   new_unix_acceptor_impl(path)},
+                     true);
 }
 
 /******************************************************************************
@@ -836,6 +1373,15 @@ void tcp_nodelay(native_socket fd, bool new_value) {
   }
 }
 
+bool is_tcp_socket(native_socket fd) {
+  sockaddr_storage addr;
+  socklen_t len = sizeof(addr);
+  if (getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+    return false;
+  }
+  return addr.ss_family == AF_INET || addr.ss_family == AF_INET6;
+}
+
 bool is_error(ssize_t res, bool is_nonblock) {
   if (res < 0) {
     auto err = last_socket_error();
@@ -873,6 +1419,30 @@ bool write_some(size_t& result, native_socket fd, const void* buf, size_t len) {
   return true;
 }
 
+bool write_some(size_t& result, native_socket fd,
+                io_vec* bufs, size_t num_bufs) {
+  CAF_LOGF_TRACE(CAF_ARG(fd) << ", " << CAF_ARG(num_bufs));
+  CAF_REQUIRE(num_bufs > 0 && num_bufs <= max_io_vecs);
+# ifdef CAF_WINDOWS
+    DWORD bytes_sent = 0;
+    auto sres = ::WSASend(fd, bufs, static_cast<DWORD>(num_bufs),
+                          &bytes_sent, 0, nullptr, nullptr);
+    auto res = sres == 0 ? static_cast<ssize_t>(bytes_sent) : -1;
+# else
+    msghdr mh;
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_iov = bufs;
+    mh.msg_iovlen = num_bufs;
+    auto res = ::sendmsg(fd, &mh, no_sigpipe_flag);
+# endif
+  CAF_LOGF_DEBUG("tried to write " << num_bufs << " buffers to socket " << fd
+                                   << ", sendmsg returned " << res);
+  if (is_error(res, true))
+    return false;
+  result = (res > 0) ? static_cast<size_t>(res) : 0;
+  return true;
+}
+
 bool try_accept(native_socket& result, native_socket fd) {
   CAF_LOGF_TRACE(CAF_ARG(fd));
   sockaddr addr;
@@ -905,9 +1475,13 @@ default_socket::default_socket(default_multiplexer& ref, native_socket sockfd)
       m_fd(sockfd) {
   CAF_LOG_TRACE(CAF_ARG(sockfd));
   if (sockfd != invalid_native_socket) {
-    // enable nonblocking IO & disable Nagle's algorithm
+    // enable nonblocking IO & disable Nagle's algorithm for TCP
     nonblocking(m_fd, true);
-    tcp_nodelay(m_fd, true);
+    if (is_tcp_socket(m_fd)) {
+      tcp_nodelay(m_fd, true);
+    }
+    std::unique_lock<detail::shared_spinlock> guard{m_parent.m_sockets_mtx};
+    m_parent.m_sockets.insert(sockfd);
   }
 }
 
@@ -918,12 +1492,33 @@ default_socket::default_socket(default_socket&& other)
 
 default_socket& default_socket::operator=(default_socket&& other) {
   std::swap(m_fd, other.m_fd);
+  if (&m_parent != &other.m_parent) {
+    // both sockets changed their multiplexer
+    auto move_socket = [](native_socket fd, default_multiplexer& from,
+                          default_multiplexer& to) {
+      if (fd == invalid_native_socket) {
+        return;
+      }
+      { // lifetime scope of first guard
+        std::unique_lock<detail::shared_spinlock> guard{from.m_sockets_mtx};
+        from.m_sockets.erase(fd);
+      }
+      std::unique_lock<detail::shared_spinlock> guard{to.m_sockets_mtx};
+      to.m_sockets.insert(fd);
+    };
+    move_socket(m_fd, other.m_parent, m_parent);
+    move_socket(other.m_fd, m_parent, other.m_parent);
+  }
   return *this;
 }
 
 default_socket::~default_socket() {
   if (m_fd != invalid_native_socket) {
     CAF_LOG_DEBUG("close socket " << m_fd);
+    { // the OS reuses the descriptor after closing it
+      std::unique_lock<detail::shared_spinlock> guard{m_parent.m_sockets_mtx};
+      m_parent.m_sockets.erase(m_fd);
+    }
     closesocket(m_fd);
   }
 }
@@ -1038,6 +1633,120 @@ new_ipv4_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr) {
   return {fd, ntohs(serv_addr.sin_port)};
 }
 
+#ifndef CAF_WINDOWS
+
+namespace {
+
+sockaddr_un unix_address(const std::string& path) {
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+    throw network_error("invalid Unix domain socket path: " + path);
+  }
+  memcpy(addr.sun_path, path.data(), path.size());
+  return addr;
+}
+
+// a socket file is stale if it refuses connections, i.e.,
+// if the process that created it no longer exists
+bool is_stale_unix_socket(const std::string& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0 || !S_ISSOCK(st.st_mode)) {
+    return false;
+  }
+  auto addr = unix_address(path);
+  native_socket fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd == invalid_native_socket) {
+    return false;
+  }
+  socket_guard sguard(fd);
+  return connect(fd, reinterpret_cast<const sockaddr*>(&addr),
+                 sizeof(addr)) != 0
+         && last_socket_error() == ECONNREFUSED;
+}
+
+} // namespace <anonymous>
+
+native_socket new_unix_connection_impl(const std::string& path) {
+  CAF_LOGF_TRACE(CAF_ARG(path));
+  auto addr = unix_address(path);
+  native_socket fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd == invalid_native_socket) {
+    throw network_error("socket creation failed");
+  }
+  socket_guard sguard(fd);
+  if (connect(fd, reinterpret_cast<const sockaddr*>(&addr),
+              sizeof(addr)) != 0) {
+    CAF_LOGF_INFO("could not connect to " << path);
+    throw network_error("could not connect to " + path + ": "
+                        + last_socket_error_as_string());
+  }
+  sguard.release();
+  return fd;
+}
+
+native_socket new_unix_acceptor_impl(const std::string& path) {
+  CAF_LOGF_TRACE(CAF_ARG(path));
+  auto addr = unix_address(path);
+  auto addr_ptr = reinterpret_cast<sockaddr*>(&addr);
+  native_socket fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd == invalid_native_socket) {
+    throw network_error("could not create server socket");
+  }
+  // sguard closes the socket in case of exception
+  socket_guard sguard(fd);
+  if (bind(fd, addr_ptr, sizeof(addr)) != 0) {
+    auto err = last_socket_error();
+    auto errstr = last_socket_error_as_string();
+    if (err != EADDRINUSE || !is_stale_unix_socket(path)
+        || unlink(path.c_str()) != 0
+        || bind(fd, addr_ptr, sizeof(addr)) != 0) {
+      throw bind_failure(path + ": " + errstr);
+    }
+    CAF_LOGF_INFO("replaced stale socket file " << path);
+  }
+  if (listen(fd, SOMAXCONN) != 0) {
+    unlink(path.c_str());
+    throw network_error("listen() failed: " + last_socket_error_as_string());
+  }
+  sguard.release();
+  CAF_LOGF_DEBUG("sockfd = " << fd << ", path = " << path);
+  return fd;
+}
+
+void remove_unix_socket_file(native_socket fd) {
+  if (fd == invalid_native_socket) {
+    return;
+  }
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  socklen_t len = sizeof(addr);
+  if (getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0
+      && addr.sun_family == AF_UNIX && addr.sun_path[0] != '\0') {
+    std::string path{addr.sun_path, strnlen(addr.sun_path,
+                                            sizeof(addr.sun_path))};
+    CAF_LOGF_DEBUG("remove socket file " << path);
+    unlink(path.c_str());
+  }
+}
+
+#else // CAF_WINDOWS
+
+native_socket new_unix_connection_impl(const std::string&) {
+  throw network_error("Unix domain sockets are not supported on Windows");
+}
+
+native_socket new_unix_acceptor_impl(const std::string&) {
+  throw network_error("Unix domain sockets are not supported on Windows");
+}
+
+void remove_unix_socket_file(native_socket) {
+  // nop
+}
+
+#endif // CAF_WINDOWS
+
 std::pair<default_socket_acceptor, uint16_t>
 new_ipv4_acceptor(uint16_t port, const char* addr, bool reuse) {
   CAF_LOGF_TRACE(CAF_ARG(port) << ", addr = " << (addr ? addr : "nullptr"));
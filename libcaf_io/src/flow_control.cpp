@@ -0,0 +1,63 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/io/flow_control.hpp"
+
+#include <atomic>
+
+namespace caf {
+namespace io {
+
+namespace {
+
+std::atomic<size_t> s_connection_credit{0};
+
+std::atomic<size_t> s_actor_credit{0};
+
+std::atomic<backpressure_policy> s_policy{backpressure_policy::suspend};
+
+} // namespace <anonymous>
+
+void connection_credit(size_t num_bytes) {
+  s_connection_credit = num_bytes;
+}
+
+size_t connection_credit() {
+  return s_connection_credit;
+}
+
+void actor_credit(size_t num_messages) {
+  s_actor_credit = num_messages;
+}
+
+size_t actor_credit() {
+  return s_actor_credit;
+}
+
+void on_backpressure(backpressure_policy policy) {
+  s_policy = policy;
+}
+
+backpressure_policy on_backpressure() {
+  return s_policy;
+}
+
+} // namespace io
+} // namespace caf
@@ -81,5 +81,19 @@ void hook::invalid_message_received_cb(const node_id& source,
   call_next<invalid_message_received>(source, sender, invalid_dest, mid, msg);
 }
 
+void hook::payload_sent_cb(const node_id& hop, const message& payload,
+                           size_t num_bytes) {
+  call_next<payload_sent>(hop, payload, num_bytes);
+}
+
+void hook::payload_received_cb(const node_id& source, const message& payload,
+                               size_t num_bytes) {
+  call_next<payload_received>(source, payload, num_bytes);
+}
+
+bool hook::needs_payload_size() const {
+  return false;
+}
+
 } // namespace io
 } // namespace caf
@@ -0,0 +1,42 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <atomic>
+
+#include "caf/io/io_threads.hpp"
+
+namespace caf {
+namespace io {
+
+namespace {
+
+std::atomic<size_t> default_io_threads{1};
+
+} // namespace <anonymous>
+
+void io_threads(size_t num) {
+  default_io_threads = num > 0 ? num : 1;
+}
+
+size_t io_threads() {
+  return default_io_threads;
+}
+
+} // namespace io
+} // namespace caf
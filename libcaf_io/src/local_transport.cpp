@@ -0,0 +1,102 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/io/local_transport.hpp"
+
+#include <atomic>
+#include <cstdlib>
+
+#include "caf/config.hpp"
+
+#ifndef CAF_WINDOWS
+# include <unistd.h>
+#endif
+
+namespace caf {
+namespace io {
+
+namespace {
+
+#ifdef CAF_WINDOWS
+std::atomic<bool> s_prefer_local_transport{false};
+#else
+std::atomic<bool> s_prefer_local_transport{true};
+#endif
+
+std::atomic<bool> s_shared_memory_transport{false};
+
+constexpr char shared_memory_prefix[] = "shm:";
+
+} // namespace <anonymous>
+
+void prefer_local_transport(bool value) {
+# ifndef CAF_WINDOWS
+  s_prefer_local_transport = value;
+# else
+  static_cast<void>(value);
+# endif
+}
+
+bool prefer_local_transport() {
+  return s_prefer_local_transport;
+}
+
+std::string local_transport_path(uint16_t port) {
+  std::string result;
+# ifndef CAF_WINDOWS
+  auto dir = getenv("TMPDIR");
+  result = dir && dir[0] != '\0' ? dir : "/tmp";
+  if (result.back() != '/') {
+    result += '/';
+  }
+  result += "caf-";
+  result += std::to_string(getpid());
+  result += '-';
+  result += std::to_string(port);
+  result += ".sock";
+# else
+  static_cast<void>(port);
+# endif
+  return result;
+}
+
+void shared_memory_transport(bool value) {
+# ifdef CAF_LINUX
+  s_shared_memory_transport = value;
+# else
+  static_cast<void>(value);
+# endif
+}
+
+bool shared_memory_transport() {
+  return s_shared_memory_transport;
+}
+
+bool strip_shared_memory_prefix(std::string& path) {
+  auto len = sizeof(shared_memory_prefix) - 1;
+  if (path.compare(0, len, shared_memory_prefix) != 0) {
+    return false;
+  }
+  path.erase(0, len);
+  return true;
+}
+
+} // namespace io
+} // namespace caf
@@ -0,0 +1,191 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/io/network/lz_codec.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+namespace caf {
+namespace io {
+namespace network {
+
+namespace {
+
+inline uint32_t read32(const unsigned char* ptr) {
+  uint32_t result;
+  memcpy(&result, ptr, sizeof(result));
+  return result;
+}
+
+inline size_t hash(uint32_t sequence, size_t bits) {
+  return static_cast<size_t>((sequence * 2654435761u) >> (32 - bits));
+}
+
+// writes the part of a length exceeding the 4 bits of the token
+void write_length(lz_codec::buffer_type& out, size_t len) {
+  while (len >= 255) {
+    out.push_back(static_cast<char>(255));
+    len -= 255;
+  }
+  out.push_back(static_cast<char>(len));
+}
+
+// reads the part of a length exceeding the 4 bits of
+// the token, returns false if the input ends prematurely
+bool read_length(const unsigned char*& first, const unsigned char* last,
+                 size_t& len) {
+  unsigned char x;
+  do {
+    if (first == last) {
+      return false;
+    }
+    x = *first++;
+    len += x;
+  } while (x == 255);
+  return true;
+}
+
+void write_sequence(lz_codec::buffer_type& out, const unsigned char* literals,
+                    size_t num_literals, size_t offset, size_t match_len) {
+  auto lit_bits = std::min<size_t>(num_literals, 15);
+  auto match_bits = std::min<size_t>(match_len, 15);
+  out.push_back(static_cast<char>((lit_bits << 4) | match_bits));
+  if (lit_bits == 15) {
+    write_length(out, num_literals - 15);
+  }
+  out.insert(out.end(), literals, literals + num_literals);
+  if (offset > 0) {
+    out.push_back(static_cast<char>(offset & 0xFF));
+    out.push_back(static_cast<char>(offset >> 8));
+    if (match_bits == 15) {
+      write_length(out, match_len - 15);
+    }
+  }
+}
+
+} // namespace <anonymous>
+
+lz_codec::lz_codec() : m_table(size_t{1} << table_bits) {
+  // nop
+}
+
+void lz_codec::compress(const char* data, size_t size, buffer_type& out) {
+  auto size32 = static_cast<uint32_t>(size);
+  for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+    out.push_back(static_cast<char>((size32 >> (i * 8)) & 0xFF));
+  }
+  std::fill(m_table.begin(), m_table.end(), 0);
+  auto first = reinterpret_cast<const unsigned char*>(data);
+  size_t anchor = 0; // first byte not written to `out` yet
+  size_t pos = 0;
+  auto limit = size >= min_match ? size - min_match + 1 : 0;
+  while (pos < limit) {
+    auto sequence = read32(first + pos);
+    auto& entry = m_table[hash(sequence, table_bits)];
+    auto candidate = static_cast<size_t>(entry);
+    entry = static_cast<uint32_t>(pos + 1);
+    if (candidate == 0 || pos - (candidate - 1) > max_offset
+        || read32(first + candidate - 1) != sequence) {
+      ++pos;
+      continue;
+    }
+    auto match = candidate - 1;
+    auto len = min_match;
+    while (pos + len < size && first[match + len] == first[pos + len]) {
+      ++len;
+    }
+    write_sequence(out, first + anchor, pos - anchor, pos - match,
+                   len - min_match);
+    pos += len;
+    anchor = pos;
+  }
+  write_sequence(out, first + anchor, size - anchor, 0, 0);
+}
+
+bool lz_codec::decompress(const char* data, size_t size, buffer_type& out,
+                          size_t max_size) {
+  if (size < sizeof(uint32_t)) {
+    return false;
+  }
+  auto first = reinterpret_cast<const unsigned char*>(data);
+  auto last = first + size;
+  size_t expected = 0;
+  for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+    expected |= static_cast<size_t>(*first++) << (i * 8);
+  }
+  // each input byte expands to at most 255 output bytes, rejecting
+  // larger sizes prevents malicious peers from exhausting memory
+  if (expected > max_size || expected / 255 > size) {
+    return false;
+  }
+  auto base = out.size();
+  out.reserve(base + expected);
+  for (;;) {
+    if (first == last) {
+      return false;
+    }
+    auto token = *first++;
+    size_t num_literals = token >> 4;
+    if (num_literals == 15 && !read_length(first, last, num_literals)) {
+      return false;
+    }
+    if (static_cast<size_t>(last - first) < num_literals
+        || out.size() - base + num_literals > expected) {
+      return false;
+    }
+    out.insert(out.end(), first, first + num_literals);
+    first += num_literals;
+    if (first == last) {
+      // the last sequence has no match
+      return out.size() - base == expected;
+    }
+    if (last - first < 2) {
+      return false;
+    }
+    size_t offset = first[0] | (static_cast<size_t>(first[1]) << 8);
+    first += 2;
+    size_t match_len = token & 0x0F;
+    if (match_len == 15 && !read_length(first, last, match_len)) {
+      return false;
+    }
+    match_len += min_match;
+    auto produced = out.size() - base;
+    if (offset == 0 || offset > produced || produced + match_len > expected) {
+      return false;
+    }
+    auto pos = out.size();
+    out.resize(pos + match_len);
+    auto dst = out.data() + pos;
+    auto src = dst - offset;
+    if (offset >= match_len) {
+      memcpy(dst, src, match_len);
+    } else {
+      // overlapping matches repeat the last `offset` bytes
+      for (size_t i = 0; i < match_len; ++i) {
+        dst[i] = src[i];
+      }
+    }
+  }
+}
+
+} // namespace network
+} // namespace io
+} // namespace caf
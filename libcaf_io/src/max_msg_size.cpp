@@ -28,6 +28,10 @@ namespace {
 
 std::atomic<size_t> default_max_msg_size{16 * 1024 * 1024};
 
+std::atomic<size_t> default_fragment_size{64 * 1024};
+
+std::atomic<size_t> default_max_reassembly_size{64 * 1024 * 1024};
+
 } // namespace <anonymous>
 
 void max_msg_size(size_t size) {
@@ -38,5 +42,21 @@ size_t max_msg_size() {
   return default_max_msg_size;
 }
 
+void fragment_size(size_t size) {
+  default_fragment_size = size;
+}
+
+size_t fragment_size() {
+  return default_fragment_size;
+}
+
+void max_reassembly_size(size_t size) {
+  default_max_reassembly_size = size;
+}
+
+size_t max_reassembly_size() {
+  return default_max_reassembly_size;
+}
+
 } // namespace io
 } // namespace caf
@@ -35,7 +35,9 @@
 #include "caf/uniform_type_info.hpp"
 
 #include "caf/io/middleman.hpp"
+#include "caf/io/io_threads.hpp"
 #include "caf/io/basp_broker.hpp"
+#include "caf/io/local_transport.hpp"
 #include "caf/io/system_messages.hpp"
 
 #include "caf/detail/logging.hpp"
@@ -115,6 +117,34 @@ deserialize_impl(T& dm, deserializer* source) {
   deserialize_impl(dm.handle, source);
 }
 
+inline void serialize_impl(const connection_attempt_msg& msg,
+                           serializer* sink) {
+  serialize_impl(msg.handle, sink);
+  sink->write_value(static_cast<uint8_t>(msg.success ? 1 : 0));
+  sink->write_value(msg.reason);
+}
+
+inline void deserialize_impl(connection_attempt_msg& msg,
+                             deserializer* source) {
+  deserialize_impl(msg.handle, source);
+  msg.success = source->read<uint8_t>() != 0;
+  msg.reason = source->read<std::string>();
+}
+
+inline void serialize_impl(const data_transferred_msg& msg,
+                           serializer* sink) {
+  serialize_impl(msg.handle, sink);
+  sink->write_value(msg.written);
+  sink->write_value(msg.remaining);
+}
+
+inline void deserialize_impl(data_transferred_msg& msg,
+                             deserializer* source) {
+  deserialize_impl(msg.handle, source);
+  msg.written = source->read<uint64_t>();
+  msg.remaining = source->read<uint64_t>();
+}
+
 template <class T>
 class uti_impl : public uniform_type_info {
  public:
@@ -217,6 +247,9 @@ class middleman_actor_impl : public middleman_actor_base::base {
       [=](put_atom, const actor_addr& whom, uint16_t port) {
         return put(whom, port);
       },
+      [=](put_atom, const actor_addr& whom, const std::string& path) {
+        return put(whom, path);
+      },
       [=](get_atom, const std::string& hostname, uint16_t port,
           std::set<std::string>& expected_ifs) {
         return get(hostname, port, std::move(expected_ifs));
@@ -224,6 +257,13 @@ class middleman_actor_impl : public middleman_actor_base::base {
       [=](get_atom, const std::string& hostname, uint16_t port) {
         return get(hostname, port, std::set<std::string>());
       },
+      [=](get_atom, const std::string& path,
+          std::set<std::string>& expected_ifs) {
+        return get(path, std::move(expected_ifs));
+      },
+      [=](get_atom, const std::string& path) {
+        return get(path, std::set<std::string>());
+      },
       [=](delete_atom, const actor_addr& whom) {
         return del(whom);
       },
@@ -285,22 +325,43 @@ class middleman_actor_impl : public middleman_actor_base::base {
     return {ok_atom{}, actual_port};
   }
 
-  get_op_promise get(const std::string& hostname, uint16_t port,
-                     std::set<std::string> expected_ifs) {
-    auto result = make_response_promise();
+  either<ok_atom>::or_else<error_atom, std::string>
+  put(const actor_addr& whom, const std::string& path) {
+    accept_handle hdl;
     try {
-      auto hdl = m_parent.backend().new_tcp_scribe(hostname, port);
-      auto req_id = m_next_request_id++;
-      send(m_broker, get_atom{}, hdl, req_id,
-           actor{this}, std::move(expected_ifs));
-      m_pending_requests.insert(std::make_pair(req_id, result));
+      auto socket_path = path;
+      strip_shared_memory_prefix(socket_path);
+      hdl = m_parent.backend().new_unix_doorman(socket_path);
+    }
+    catch (bind_failure& err) {
+      return {error_atom{}, std::string("bind_failure: ") + err.what()};
     }
     catch (network_error& err) {
-      // fullfil promise immediately
-      std::string msg = "network_error: ";
-      msg += err.what();
-      result.deliver(get_op_result{error_atom{}, std::move(msg)}.value);
+      return {error_atom{}, std::string("network_error: ") + err.what()};
     }
+    send(m_broker, put_atom{}, hdl, whom, path);
+    return {ok_atom{}};
+  }
+
+  get_op_promise get(const std::string& path,
+                     std::set<std::string> expected_ifs) {
+    auto result = make_response_promise();
+    auto req_id = m_next_request_id++;
+    send(m_broker, get_atom{}, path, req_id, actor{this},
+         std::move(expected_ifs));
+    m_pending_requests.insert(std::make_pair(req_id, result));
+    return result;
+  }
+
+  get_op_promise get(const std::string& hostname, uint16_t port,
+                     std::set<std::string> expected_ifs) {
+    auto result = make_response_promise();
+    // the BASP broker connects asynchronously and reports errors
+    // via (error_atom, request_id, reason) to this actor
+    auto req_id = m_next_request_id++;
+    send(m_broker, get_atom{}, hostname, port, req_id,
+         actor{this}, std::move(expected_ifs));
+    m_pending_requests.insert(std::make_pair(req_id, result));
     return result;
   }
 
@@ -329,6 +390,10 @@ middleman* middleman::instance() {
   return static_cast<middleman*>(res);
 }
 
+network::multiplexer& middleman::next_backend() {
+  return *m_backends[m_next_backend++ % m_backends.size()];
+}
+
 void middleman::add_broker(broker_ptr bptr) {
   m_brokers.insert(bptr);
   bptr->attach_functor([=](uint32_t) { m_brokers.erase(bptr); });
@@ -336,31 +401,44 @@ void middleman::add_broker(broker_ptr bptr) {
 
 void middleman::initialize() {
   CAF_LOG_TRACE("");
-  m_backend = network::multiplexer::make();
-  m_backend_supervisor = m_backend->make_supervisor();
-  m_thread = std::thread([this] {
-    CAF_LOGC_TRACE("caf::io::middleman", "initialize$run", "");
-    m_backend->run();
-  });
-  m_backend->thread_id(m_thread.get_id());
+  auto num_backends = io_threads();
+  for (size_t i = 0; i < num_backends; ++i) {
+    m_backends.push_back(network::multiplexer::make());
+    auto backend = m_backends.back().get();
+    m_backend_supervisors.push_back(backend->make_supervisor());
+    m_threads.emplace_back([backend] {
+      CAF_LOGC_TRACE("caf::io::middleman", "initialize$run", "");
+      backend->run();
+    });
+    backend->thread_id(m_threads.back().get_id());
+  }
   // announce io-related types
   do_announce<new_data_msg>("caf::io::new_data_msg");
   do_announce<new_connection_msg>("caf::io::new_connection_msg");
   do_announce<acceptor_closed_msg>("caf::io::acceptor_closed_msg");
   do_announce<connection_closed_msg>("caf::io::connection_closed_msg");
+  do_announce<connection_attempt_msg>("caf::io::connection_attempt_msg");
+  do_announce<data_transferred_msg>("caf::io::data_transferred_msg");
   do_announce<accept_handle>("caf::io::accept_handle");
   do_announce<acceptor_closed_msg>("caf::io::acceptor_closed_msg");
   do_announce<connection_closed_msg>("caf::io::connection_closed_msg");
   do_announce<connection_handle>("caf::io::connection_handle");
   do_announce<new_connection_msg>("caf::io::new_connection_msg");
   do_announce<new_data_msg>("caf::io::new_data_msg");
-  actor mgr = get_named_broker<basp_broker>(atom("_BASP"));
+  auto basp = get_named_broker<basp_broker>(atom("_BASP"));
+  // each further backend handles a share of all remote connections
+  for (size_t i = 1; i < num_backends; ++i) {
+    broker_ptr shard{new basp_broker(*basp, backend(i))};
+    shard->launch(true, false, nullptr);
+    m_basp_shards.push_back(std::move(shard));
+  }
+  actor mgr = basp;
   m_manager = spawn_typed<middleman_actor_impl, detached + hidden>(*this, mgr);
 }
 
 void middleman::stop() {
   CAF_LOG_TRACE("");
-  m_backend->dispatch([=] {
+  backend().dispatch([=] {
     CAF_LOGC_TRACE("caf::io::middleman", "stop$lambda", "");
     // m_managers will be modified while we are stopping each manager,
     // because each manager will call remove(...)
@@ -372,9 +450,17 @@ void middleman::stop() {
       bro->close_all();
     }
   });
-  m_backend_supervisor.reset();
-  m_thread.join();
+  for (auto& shard : m_basp_shards) {
+    shard->backend().dispatch([=] {
+      shard->close_all();
+    });
+  }
+  m_backend_supervisors.clear();
+  for (auto& t : m_threads) {
+    t.join();
+  }
   m_named_brokers.clear();
+  m_basp_shards.clear();
   scoped_actor self(true);
   self->monitor(m_manager);
   self->send_exit(m_manager, exit_reason::user_shutdown);
@@ -389,7 +475,7 @@ void middleman::dispose() {
   delete this;
 }
 
-middleman::middleman() {
+middleman::middleman() : m_next_backend(0), m_payload_hooks(false) {
   // nop
 }
 
@@ -0,0 +1,57 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/io/parallel_connections.hpp"
+
+#include <atomic>
+#include <algorithm>
+
+#include "caf/io/basp.hpp"
+
+namespace caf {
+namespace io {
+
+namespace {
+
+std::atomic<size_t> s_connections_per_peer{1};
+
+std::atomic<size_t> s_bulk_connection_threshold{0};
+
+} // namespace <anonymous>
+
+void connections_per_peer(size_t num) {
+  s_connections_per_peer = std::min(std::max<size_t>(num, 1),
+                                    static_cast<size_t>(basp::max_lanes));
+}
+
+size_t connections_per_peer() {
+  return s_connections_per_peer;
+}
+
+void bulk_connection_threshold(size_t num_bytes) {
+  s_bulk_connection_threshold = num_bytes;
+}
+
+size_t bulk_connection_threshold() {
+  return s_bulk_connection_threshold;
+}
+
+} // namespace io
+} // namespace caf
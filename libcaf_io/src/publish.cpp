@@ -53,5 +53,18 @@ uint16_t publish_impl(abstract_actor_ptr whom, uint16_t port,
   return result;
 }
 
+void publish_impl(abstract_actor_ptr whom, const std::string& path) {
+  auto mm = get_middleman_actor();
+  scoped_actor self;
+  self->sync_send(mm, put_atom{}, whom->address(), path).await(
+    [](ok_atom) {
+      // nop
+    },
+    [&](error_atom, std::string& msg) {
+      throw network_error(std::move(msg));
+    }
+  );
+}
+
 } // namespace io
 } // namespace caf
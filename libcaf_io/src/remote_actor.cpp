@@ -57,6 +57,22 @@ abstract_actor_ptr remote_actor_impl(std::set<std::string> ifs,
   return result;
 }
 
+abstract_actor_ptr remote_actor_impl(std::set<std::string> ifs,
+                                     const std::string& path) {
+  auto mm = get_middleman_actor();
+  scoped_actor self;
+  abstract_actor_ptr result;
+  self->sync_send(mm, get_atom{}, path, std::move(ifs)).await(
+    [&](ok_atom, actor_addr res) {
+      result = actor_cast<abstract_actor_ptr>(res);
+    },
+    [&](error_atom, std::string& msg) {
+      throw network_error(std::move(msg));
+    }
+  );
+  return result;
+}
+
 } // namespace io
 } // namespace caf
 
@@ -0,0 +1,480 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/io/network/shared_memory_stream.hpp"
+
+#include <cstring>
+
+#include "caf/config.hpp"
+#include "caf/exception.hpp"
+
+#ifdef CAF_LINUX
+# include <errno.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/socket.h>
+#endif
+
+namespace caf {
+namespace io {
+namespace network {
+
+namespace {
+
+// maximum number of rounds in `process` before yielding to other handlers
+constexpr size_t max_rounds = 16;
+
+// the first ring transfers data from the client to the server
+inline size_t segment_size(size_t capacity) {
+  return 2 * spsc_ring::required_size(capacity);
+}
+
+#ifdef CAF_LINUX
+// prevents the server from resizing a segment the client has mapped,
+// because accessing pages beyond the end of the file raises SIGBUS
+constexpr int segment_seals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL;
+#endif
+
+#ifdef CAF_LINUX
+// closes a file descriptor when going out of scope
+class fd_guard {
+ public:
+  fd_guard(int fd) : m_fd(fd) {
+    // nop
+  }
+  ~fd_guard() {
+    close(m_fd);
+  }
+ private:
+  int m_fd;
+};
+#endif // CAF_LINUX
+
+} // namespace <anonymous>
+
+shared_memory_stream::shared_memory_stream(default_multiplexer& backend_ref)
+    : event_handler(backend_ref),
+      m_sock(backend_ref),
+      m_segment(nullptr),
+      m_segment_size(0),
+      m_reading(false),
+      m_wr_pos(0),
+      m_ack_writes(false),
+      m_ack_scheduled(false),
+      m_unacked(0) {
+  configure_read(receive_policy::at_most(1024));
+}
+
+shared_memory_stream::~shared_memory_stream() {
+# ifdef CAF_LINUX
+  if (m_segment) {
+    munmap(m_segment, m_segment_size);
+  }
+# endif
+}
+
+#ifdef CAF_LINUX
+
+void shared_memory_stream::init_as_server(default_socket sock) {
+  CAF_LOG_TRACE("sock.fd = " << sock.fd());
+  m_sock = std::move(sock);
+  auto memfd = memfd_create("caf-shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (memfd < 0) {
+    throw_io_failure("memfd_create() failed");
+  }
+  fd_guard guard{memfd};
+  auto size = segment_size(ring_capacity);
+  if (ftruncate(memfd, static_cast<off_t>(size)) != 0) {
+    throw_io_failure("ftruncate() failed");
+  }
+  if (fcntl(memfd, F_ADD_SEALS, segment_seals) != 0) {
+    throw_io_failure("unable to seal shared memory segment");
+  }
+  map_segment(memfd, ring_capacity, true);
+  auto ptr = reinterpret_cast<char*>(m_segment);
+  spsc_ring::init(ptr);
+  spsc_ring::init(ptr + spsc_ring::required_size(ring_capacity));
+  // both sides start idle, i.e., the first write wakes up the peer
+  m_in.consumer_sleep();
+  m_out.consumer_sleep();
+  // pass the segment along with the ring capacity to the client
+  uint64_t capacity = ring_capacity;
+  iovec iov;
+  iov.iov_base = &capacity;
+  iov.iov_len = sizeof(capacity);
+  union {
+    char buf[CMSG_SPACE(sizeof(int))];
+    cmsghdr align;
+  } ctrl;
+  memset(&ctrl, 0, sizeof(ctrl));
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = ctrl.buf;
+  msg.msg_controllen = sizeof(ctrl.buf);
+  auto cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  memcpy(CMSG_DATA(cmsg), &memfd, sizeof(int));
+  // the socket has just been accepted, i.e., its send buffer is empty
+  if (sendmsg(m_sock.fd(), &msg, MSG_NOSIGNAL)
+      != static_cast<ssize_t>(sizeof(capacity))) {
+    throw_io_failure("unable to pass shared memory segment");
+  }
+}
+
+void shared_memory_stream::map_segment(native_socket memfd, size_t capacity,
+                                       bool is_server) {
+  auto size = segment_size(capacity);
+  auto ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+  if (ptr == MAP_FAILED) {
+    throw_io_failure("mmap() failed");
+  }
+  m_segment = ptr;
+  m_segment_size = size;
+  auto first = reinterpret_cast<char*>(ptr);
+  auto second = first + spsc_ring::required_size(capacity);
+  m_in.attach(is_server ? first : second, capacity);
+  m_out.attach(is_server ? second : first, capacity);
+}
+
+bool shared_memory_stream::receive_segment() {
+  CAF_LOG_TRACE("");
+  uint64_t capacity = 0;
+  iovec iov;
+  iov.iov_base = &capacity;
+  iov.iov_len = sizeof(capacity);
+  union {
+    char buf[CMSG_SPACE(sizeof(int))];
+    cmsghdr align;
+  } ctrl;
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = ctrl.buf;
+  msg.msg_controllen = sizeof(ctrl.buf);
+  auto res = recvmsg(m_sock.fd(), &msg, MSG_CMSG_CLOEXEC);
+  if (res < 0 && would_block_or_temporarily_unavailable(last_socket_error())) {
+    return true;
+  }
+  auto cmsg = CMSG_FIRSTHDR(&msg);
+  if (res != static_cast<ssize_t>(sizeof(capacity)) || !cmsg
+      || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS
+      || cmsg->cmsg_len != CMSG_LEN(sizeof(int))) {
+    CAF_LOG_INFO("peer did not pass a shared memory segment");
+    return false;
+  }
+  int memfd;
+  memcpy(&memfd, CMSG_DATA(cmsg), sizeof(int));
+  fd_guard guard{memfd};
+  // accept only segments we would have created ourselves
+  struct stat st;
+  if (capacity == 0 || capacity > ring_capacity
+      || (capacity & (capacity - 1)) != 0 || fstat(memfd, &st) != 0
+      || static_cast<size_t>(st.st_size) != segment_size(capacity)) {
+    CAF_LOG_INFO("peer passed an invalid shared memory segment");
+    return false;
+  }
+  auto seals = fcntl(memfd, F_GET_SEALS);
+  if (seals < 0 || (seals & segment_seals) != segment_seals) {
+    CAF_LOG_INFO("peer passed an unsealed shared memory segment");
+    return false;
+  }
+  try {
+    map_segment(memfd, static_cast<size_t>(capacity), false);
+  }
+  catch (network_error& e) {
+    CAF_LOG_INFO(e.what());
+    static_cast<void>(e); // keep compiler happy w/o logging
+    return false;
+  }
+  return true;
+}
+
+void shared_memory_stream::ring_doorbell() {
+  char doorbell = 0;
+  // a full socket buffer means the peer has pending wakeups anyway
+  ::send(m_sock.fd(), &doorbell, 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+}
+
+#else // CAF_LINUX
+
+void shared_memory_stream::init_as_server(default_socket) {
+  throw network_error("shared memory transport is available on Linux only");
+}
+
+void shared_memory_stream::map_segment(native_socket, size_t, bool) {
+  throw network_error("shared memory transport is available on Linux only");
+}
+
+bool shared_memory_stream::receive_segment() {
+  return false;
+}
+
+void shared_memory_stream::ring_doorbell() {
+  // nop
+}
+
+#endif // CAF_LINUX
+
+void shared_memory_stream::init_as_client(default_socket sock) {
+# ifndef CAF_LINUX
+  throw network_error("shared memory transport is available on Linux only");
+# endif
+  m_sock = std::move(sock);
+}
+
+void shared_memory_stream::start(const manager_ptr& mgr) {
+  CAF_REQUIRE(mgr != nullptr);
+  m_reader = mgr;
+  m_reading = true;
+  read_loop();
+  // data written by the peer until now is announced by the doorbell
+  backend().add(operation::read, m_sock.fd(), this);
+}
+
+void shared_memory_stream::removed_from_loop(operation op) {
+  if (op == operation::read) {
+    // no more wakeups, i.e., we cannot send pending data either
+    m_reader.reset();
+    m_writer.reset();
+  }
+}
+
+void shared_memory_stream::configure_read(receive_policy::config config) {
+  m_rd_flag = config.first;
+  m_max = config.second;
+}
+
+void shared_memory_stream::flush(const manager_ptr& mgr) {
+  CAF_REQUIRE(mgr != nullptr);
+  CAF_LOG_TRACE("wr_buf size: " << m_wr_buf.size());
+  m_writer = mgr;
+  if (m_out.attached() && send_data() && m_ack_writes) {
+    schedule_ack();
+  }
+}
+
+void shared_memory_stream::ack_writes(bool enable) {
+  m_ack_writes = enable;
+}
+
+void shared_memory_stream::stop_reading() {
+  CAF_LOGM_TRACE("caf::io::network::shared_memory_stream", "");
+  m_reading = false;
+  m_sock.close_read();
+  backend().del(operation::read, m_sock.fd(), this);
+}
+
+void shared_memory_stream::handle_event(operation op) {
+  CAF_LOG_TRACE("op = " << static_cast<int>(op));
+  switch (op) {
+    case operation::read: {
+      if (!m_in.attached()) {
+        if (!receive_segment()) {
+          fail();
+        } else if (m_in.attached()) {
+          process();
+        }
+        break;
+      }
+      // consume all doorbells, the rings tell us what to do
+      char buf[64];
+      size_t rb;
+      if (!read_some(rb, m_sock.fd(), buf, sizeof(buf))) {
+        // deliver everything the peer wrote before shutting down
+        process();
+        if (m_reading) {
+          fail();
+        }
+      } else {
+        process();
+      }
+      break;
+    }
+    case operation::write:
+      // never subscribed to write events
+      break;
+    case operation::propagate_error:
+      if (m_reader) {
+        m_reader->io_failure(operation::read);
+      }
+      if (m_writer) {
+        m_writer->io_failure(operation::write);
+      }
+      break;
+  }
+}
+
+void shared_memory_stream::process() {
+  CAF_LOG_TRACE("");
+  // the peer does not need to wake us up while we are running
+  m_in.consumer_awake();
+  for (size_t round = 0; round < max_rounds; ++round) {
+    auto sent = send_data();
+    if (sent && m_ack_writes) {
+      schedule_ack();
+    }
+    auto received = receive_data();
+    if (m_in.corrupted() || m_out.corrupted()) {
+      CAF_LOG_ERROR("peer corrupted the shared memory segment");
+      fail();
+      return;
+    }
+    if (!m_reading) {
+      return;
+    }
+    if (!sent && !received && m_in.consumer_sleep()) {
+      return;
+    }
+  }
+  // continue later to give other handlers a chance to run
+  auto mgr = m_reader;
+  backend().post([=] {
+    if (m_reading && mgr == m_reader) {
+      process();
+    }
+  });
+}
+
+bool shared_memory_stream::send_data() {
+  if (!m_wr_buf.empty()) {
+    if (m_wr_pos == m_wr_pending.size()) {
+      // nothing pending, recycle the buffers
+      m_wr_pending.clear();
+      m_wr_pending.swap(m_wr_buf);
+      m_wr_pos = 0;
+    } else {
+      m_wr_pending.insert(m_wr_pending.end(), m_wr_buf.begin(), m_wr_buf.end());
+      m_wr_buf.clear();
+    }
+  }
+  size_t total = 0;
+  while (m_wr_pos < m_wr_pending.size()) {
+    auto n = m_out.write(m_wr_pending.data() + m_wr_pos,
+                         m_wr_pending.size() - m_wr_pos);
+    m_wr_pos += n;
+    total += n;
+    m_unacked += n;
+    if (n == 0 && m_out.producer_sleep()) {
+      // the consumer rings the doorbell once it made room
+      break;
+    }
+  }
+  if (total > 0 && m_out.wake_consumer()) {
+    ring_doorbell();
+  }
+  if (m_wr_pos == m_wr_pending.size()) {
+    m_wr_pending.clear();
+    m_wr_pos = 0;
+  }
+  return total > 0;
+}
+
+void shared_memory_stream::schedule_ack() {
+  if (m_ack_scheduled || !m_writer) {
+    return;
+  }
+  m_ack_scheduled = true;
+  auto mgr = m_writer;
+  backend().post([=] {
+    m_ack_scheduled = false;
+    if (m_ack_writes && mgr == m_writer && m_unacked > 0) {
+      auto num_bytes = m_unacked;
+      m_unacked = 0;
+      mgr->data_transferred(num_bytes, m_wr_buf.size() + m_wr_pending.size()
+                                       - m_wr_pos);
+    }
+  });
+}
+
+bool shared_memory_stream::receive_data() {
+  if (!m_reading || !m_reader) {
+    return false;
+  }
+  // limit the batch size to avoid starving the opposite direction
+  size_t total = 0;
+  while (total < m_in.capacity() && m_reading) {
+    auto n = m_in.read(m_rd_buf.data() + m_collected,
+                       m_rd_buf.size() - m_collected);
+    if (n == 0) {
+      break;
+    }
+    total += n;
+    m_collected += n;
+    if (m_collected >= m_threshold) {
+      m_reader->consume(m_rd_buf.data(), m_collected);
+      read_loop();
+    }
+  }
+  if (total > 0 && m_in.wake_producer()) {
+    ring_doorbell();
+  }
+  return total > 0;
+}
+
+void shared_memory_stream::read_loop() {
+  m_collected = 0;
+  switch (m_rd_flag) {
+    case receive_policy_flag::exactly:
+      if (m_rd_buf.size() != m_max) {
+        m_rd_buf.resize(m_max);
+      }
+      m_threshold = m_max;
+      break;
+    case receive_policy_flag::at_most:
+      if (m_rd_buf.size() != m_max) {
+        m_rd_buf.resize(m_max);
+      }
+      m_threshold = 1;
+      break;
+    case receive_policy_flag::at_least: {
+      // read up to 10% more, but at least allow 100 bytes more
+      auto max_size = m_max + std::max<size_t>(100, m_max / 10);
+      if (m_rd_buf.size() != max_size) {
+        m_rd_buf.resize(max_size);
+      }
+      m_threshold = m_max;
+      break;
+    }
+  }
+}
+
+void shared_memory_stream::fail() {
+  CAF_LOG_TRACE("");
+  if (m_reader) {
+    m_reader->io_failure(operation::read);
+  } else if (m_writer) {
+    m_writer->io_failure(operation::write);
+  }
+  if (m_reading) {
+    m_reading = false;
+    backend().del(operation::read, m_sock.fd(), this);
+  }
+}
+
+} // namespace network
+} // namespace io
+} // namespace caf
@@ -27,6 +27,10 @@ stream_manager::~stream_manager() {
   // nop
 }
 
+void stream_manager::data_transferred(size_t, size_t) {
+  // nop
+}
+
 } // namespace network
 } // namespace io
 } // namespace caf
@@ -0,0 +1,105 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/trace_recorder.hpp"
+
+#include <chrono>
+
+#include "caf/message_id.hpp"
+
+namespace caf {
+namespace io {
+
+trace_log::trace_log(size_t max_events)
+    : m_max_events(max_events),
+      m_dropped(0) {
+  // nop
+}
+
+void trace_log::append(trace_event event) {
+  std::lock_guard<std::mutex> guard{m_mtx};
+  if (m_max_events == 0) {
+    ++m_dropped;
+    return;
+  }
+  if (m_events.size() == m_max_events) {
+    m_events.pop_front();
+    ++m_dropped;
+  }
+  m_events.push_back(std::move(event));
+}
+
+std::vector<trace_event> trace_log::events() const {
+  std::lock_guard<std::mutex> guard{m_mtx};
+  return {m_events.begin(), m_events.end()};
+}
+
+size_t trace_log::dropped() const {
+  std::lock_guard<std::mutex> guard{m_mtx};
+  return m_dropped;
+}
+
+void trace_log::clear() {
+  std::lock_guard<std::mutex> guard{m_mtx};
+  m_events.clear();
+  m_dropped = 0;
+}
+
+trace_recorder::trace_recorder(std::shared_ptr<trace_log> log)
+    : m_log(std::move(log)) {
+  // nop
+}
+
+void trace_recorder::message_received_cb(const node_id& source,
+                                         const actor_addr& from,
+                                         const actor_addr& dest,
+                                         message_id mid, const message& msg) {
+  record(trace_event::received, source);
+  call_next<message_received>(source, from, dest, mid, msg);
+}
+
+void trace_recorder::message_sent_cb(const actor_addr& from,
+                                     const node_id& hop,
+                                     const actor_addr& dest, message_id mid,
+                                     const message& payload) {
+  record(trace_event::sent, hop);
+  call_next<message_sent>(from, hop, dest, mid, payload);
+}
+
+void trace_recorder::message_forwarded_cb(const node_id& from,
+                                          const node_id& dest,
+                                          const std::vector<char>* payload) {
+  record(trace_event::forwarded, from);
+  call_next<message_forwarded>(from, dest, payload);
+}
+
+void trace_recorder::record(trace_event::kind_type kind,
+                            const node_id& node) {
+  // the BASP broker sets the context of the message for each callback
+  auto& ctx = trace_context::current();
+  if (!ctx.sampled) {
+    return;
+  }
+  auto now = std::chrono::system_clock::now().time_since_epoch();
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now);
+  m_log->append({kind, ctx, node, static_cast<uint64_t>(ns.count())});
+}
+
+} // namespace io
+} // namespace caf
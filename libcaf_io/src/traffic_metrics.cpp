@@ -0,0 +1,268 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/traffic_metrics.hpp"
+
+#include <tuple>
+#include <utility>
+
+#include "caf/atom.hpp"
+#include "caf/spawn.hpp"
+#include "caf/to_string.hpp"
+#include "caf/message_builder.hpp"
+#include "caf/event_based_actor.hpp"
+
+#include "caf/io/middleman.hpp"
+
+#include "caf/detail/message_data.hpp"
+
+namespace caf {
+namespace io {
+
+namespace {
+
+constexpr auto relaxed = std::memory_order_relaxed;
+
+template <class Counters>
+void clear(Counters& cs) {
+  for (auto& x : cs) {
+    x.store(0, relaxed);
+  }
+}
+
+} // namespace <anonymous>
+
+void traffic_metrics::sent(const node_id& hop, const message& msg,
+                           size_t num_bytes) {
+  for (auto cs : {&peer(hop), &type(msg)}) {
+    (*cs)[messages_sent].fetch_add(1, relaxed);
+    (*cs)[bytes_sent].fetch_add(num_bytes, relaxed);
+  }
+}
+
+void traffic_metrics::received(const node_id& source, const message& msg,
+                               size_t num_bytes) {
+  for (auto cs : {&peer(source), &type(msg)}) {
+    (*cs)[messages_received].fetch_add(1, relaxed);
+    (*cs)[bytes_received].fetch_add(num_bytes, relaxed);
+  }
+}
+
+void traffic_metrics::forwarded(const node_id& source, size_t num_bytes) {
+  auto& cs = peer(source);
+  cs[messages_forwarded].fetch_add(1, relaxed);
+  cs[bytes_forwarded].fetch_add(num_bytes, relaxed);
+}
+
+void traffic_metrics::failed(const node_id& nid, const message* msg) {
+  peer(nid)[failures].fetch_add(1, relaxed);
+  if (msg) {
+    type(*msg)[failures].fetch_add(1, relaxed);
+  }
+}
+
+message traffic_metrics::snapshot() const {
+  m_lock.lock_shared();
+  auto result = make_message(make_rows(m_peers), make_rows(m_types));
+  m_lock.unlock_shared();
+  return result;
+}
+
+void traffic_metrics::reset() {
+  m_lock.lock_shared();
+  for (auto& kvp : m_peers) {
+    clear(kvp.second);
+  }
+  for (auto& kvp : m_types) {
+    clear(kvp.second);
+  }
+  m_lock.unlock_shared();
+}
+
+std::string traffic_metrics::type_name(const message& msg) {
+  if (msg.empty()) {
+    return "@<>";
+  }
+  std::string result;
+  try {
+    auto names = msg.tuple_type_names();
+    // skip the leading "@<>+" of tuple type names
+    result = names ? names->substr(4)
+                   : detail::get_tuple_type_names(*msg.vals()).substr(4);
+  }
+  catch (std::exception&) {
+    // elements of unannounced types have no uniform name
+    return "@<?>";
+  }
+  // distinguishes messages by their leading atom, e.g., 'GET'+@str
+  if (msg.type_at(0)->equal_to(typeid(atom_value))) {
+    result.replace(0, 5, "'" + to_string(msg.get_as<atom_value>(0)) + "'");
+  }
+  return result;
+}
+
+template <class Map, class Key>
+traffic_metrics::counters& traffic_metrics::get(Map& map, const Key& key) {
+  m_lock.lock_shared();
+  auto i = map.find(key);
+  if (i != map.end()) {
+    auto& result = i->second;
+    m_lock.unlock_shared();
+    return result;
+  }
+  m_lock.unlock_shared();
+  m_lock.lock();
+  auto res = map.emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                         std::forward_as_tuple());
+  if (res.second) {
+    clear(res.first->second);
+  }
+  auto& result = res.first->second;
+  m_lock.unlock();
+  return result;
+}
+
+traffic_metrics::counters& traffic_metrics::peer(const node_id& nid) {
+  return get(m_peers, nid);
+}
+
+constexpr size_t traffic_metrics::max_cached_types;
+
+traffic_metrics::counters& traffic_metrics::type(const message& msg) {
+  if (msg.size() > max_cached_types) {
+    return get(m_types, type_name(msg));
+  }
+  type_key key;
+  std::get<0>(key) = msg.size();
+  std::get<1>(key) = atom("");
+  auto& types = std::get<2>(key);
+  types.fill(nullptr);
+  try {
+    for (size_t i = 0; i < msg.size(); ++i) {
+      types[i] = msg.type_at(i);
+    }
+  }
+  catch (std::exception&) {
+    // elements of unannounced types have no uniform type info
+    return get(m_types, type_name(msg));
+  }
+  if (!msg.empty() && types[0]->equal_to(typeid(atom_value))) {
+    std::get<1>(key) = msg.get_as<atom_value>(0);
+  }
+  m_lock.lock_shared();
+  auto i = m_type_cache.find(key);
+  if (i != m_type_cache.end()) {
+    auto& result = *i->second;
+    m_lock.unlock_shared();
+    return result;
+  }
+  m_lock.unlock_shared();
+  // builds the type name only once per type
+  auto& result = get(m_types, type_name(msg));
+  m_lock.lock();
+  m_type_cache.emplace(key, &result);
+  m_lock.unlock();
+  return result;
+}
+
+template <class Map>
+message traffic_metrics::make_rows(const Map& map) {
+  message_builder rows;
+  for (auto& kvp : map) {
+    auto& cs = kvp.second;
+    rows.append(make_message(kvp.first, cs[messages_sent].load(relaxed),
+                             cs[bytes_sent].load(relaxed),
+                             cs[messages_received].load(relaxed),
+                             cs[bytes_received].load(relaxed),
+                             cs[messages_forwarded].load(relaxed),
+                             cs[bytes_forwarded].load(relaxed),
+                             cs[failures].load(relaxed)));
+  }
+  return rows.to_message();
+}
+
+traffic_metrics_hook::traffic_metrics_hook(std::shared_ptr<traffic_metrics> ms)
+    : m_metrics(std::move(ms)) {
+  // nop
+}
+
+void traffic_metrics_hook::message_forwarded_cb(
+    const node_id& from, const node_id& dest,
+    const std::vector<char>* payload) {
+  m_metrics->forwarded(from, payload ? payload->size() : 0);
+  call_next<message_forwarded>(from, dest, payload);
+}
+
+void traffic_metrics_hook::message_sending_failed_cb(const actor_addr& from,
+                                                     const actor_addr& dest,
+                                                     message_id mid,
+                                                     const message& payload) {
+  m_metrics->failed(dest.node(), &payload);
+  call_next<message_sending_failed>(from, dest, mid, payload);
+}
+
+void traffic_metrics_hook::message_forwarding_failed_cb(
+    const node_id& from, const node_id& to,
+    const std::vector<char>* payload) {
+  m_metrics->failed(to);
+  call_next<message_forwarding_failed>(from, to, payload);
+}
+
+void traffic_metrics_hook::invalid_message_received_cb(
+    const node_id& source, const actor_addr& sender, actor_id invalid_dest,
+    message_id mid, const message& msg) {
+  m_metrics->failed(source, &msg);
+  call_next<invalid_message_received>(source, sender, invalid_dest, mid, msg);
+}
+
+void traffic_metrics_hook::payload_sent_cb(const node_id& hop,
+                                           const message& payload,
+                                           size_t num_bytes) {
+  m_metrics->sent(hop, payload, num_bytes);
+  call_next<payload_sent>(hop, payload, num_bytes);
+}
+
+void traffic_metrics_hook::payload_received_cb(const node_id& source,
+                                               const message& payload,
+                                               size_t num_bytes) {
+  m_metrics->received(source, payload, num_bytes);
+  call_next<payload_received>(source, payload, num_bytes);
+}
+
+bool traffic_metrics_hook::needs_payload_size() const {
+  return true;
+}
+
+actor spawn_traffic_monitor() {
+  auto metrics = std::make_shared<traffic_metrics>();
+  middleman::instance()->add_hook<traffic_metrics_hook>(metrics);
+  return spawn<hidden>([=]() -> behavior {
+    return {
+      [=](get_atom) {
+        return metrics->snapshot();
+      },
+      [=](delete_atom) {
+        metrics->reset();
+      }
+    };
+  });
+}
+
+} // namespace io
+} // namespace caf
@@ -0,0 +1,136 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+#include <string>
+#include <cstring>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+using namespace caf::io;
+
+using publish_atom = atom_constant<atom("publish")>;
+using connect_atom = atom_constant<atom("connect")>;
+using done_atom = atom_constant<atom("done")>;
+
+namespace {
+
+// echoes each integer it receives
+behavior echo_conn(broker* self, connection_handle hdl) {
+  self->configure_read(hdl, receive_policy::exactly(sizeof(int)));
+  return {
+    [=](const new_data_msg& msg) {
+      self->write(hdl, msg.buf.size(), msg.buf.data());
+      self->flush(hdl);
+    },
+    [=](const connection_closed_msg&) {
+      self->quit();
+    }
+  };
+}
+
+behavior echo_server(broker* self) {
+  return {
+    [=](const new_connection_msg& msg) {
+      self->fork(echo_conn, msg.handle);
+      self->quit();
+    },
+    [=](publish_atom) {
+      return self->add_tcp_doorman(0, "127.0.0.1").second;
+    }
+  };
+}
+
+// connects asynchronously and reports (done_atom, success) to the
+// listener; a successful connection must echo one integer first
+behavior async_client(broker* self, const actor& listener) {
+  auto pending = make_shared<connection_handle>();
+  return {
+    [=](connect_atom, const string& host, uint16_t port) {
+      *pending = self->add_tcp_scribe_async(host, port);
+    },
+    [=](const connection_attempt_msg& msg) {
+      CAF_CHECK(msg.handle == *pending);
+      if (!msg.success) {
+        CAF_CHECK(!msg.reason.empty());
+        self->send(listener, done_atom::value, false);
+        self->quit();
+        return;
+      }
+      self->configure_read(msg.handle, receive_policy::exactly(sizeof(int)));
+      int value = 42;
+      self->write(msg.handle, sizeof(value), &value);
+      self->flush(msg.handle);
+    },
+    [=](const new_data_msg& msg) {
+      int value;
+      memcpy(&value, msg.buf.data(), sizeof(int));
+      CAF_CHECK_EQUAL(value, 42);
+      self->send(listener, done_atom::value, true);
+      self->quit();
+    }
+  };
+}
+
+bool try_connect(scoped_actor& self, const string& host, uint16_t port) {
+  actor listener = self;
+  auto client = spawn_io(async_client, listener);
+  self->send(client, connect_atom::value, host, port);
+  bool result = false;
+  self->receive(
+    [&](done_atom, bool success) {
+      result = success;
+    }
+  );
+  return result;
+}
+
+} // namespace <anonymous>
+
+int main() {
+  CAF_TEST(test_async_connect);
+  { // lifetime scope of self
+    scoped_actor self;
+    uint16_t port = 0;
+    auto serv = spawn_io(echo_server);
+    self->sync_send(serv, publish_atom::value).await(
+      [&](uint16_t res) {
+        port = res;
+      }
+    );
+    CAF_CHECK(try_connect(self, "127.0.0.1", port));
+    // port 1 is reserved and nothing listens on it
+    CAF_CHECK(!try_connect(self, "127.0.0.1", 1));
+    CAF_CHECK(!try_connect(self, "unknown-host.invalid", 1));
+    // remote_actor() reports connection failures as before
+    auto failed = false;
+    try {
+      remote_actor("127.0.0.1", 1);
+    }
+    catch (network_error&) {
+      failed = true;
+    }
+    CAF_CHECK(failed);
+  }
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -0,0 +1,143 @@
+#include <random>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+#include "caf/io/network/lz_codec.hpp"
+
+using namespace std;
+using namespace caf;
+
+using caf::io::network::lz_codec;
+
+namespace {
+
+using buffer_type = lz_codec::buffer_type;
+
+constexpr size_t threshold = 64;
+
+buffer_type to_buf(const string& str) {
+  return buffer_type(str.begin(), str.end());
+}
+
+string make_text(size_t size) {
+  string result;
+  for (size_t i = 0; result.size() < size; ++i) {
+    result += "key" + to_string(i % 13) + "=value ";
+  }
+  result.resize(size);
+  return result;
+}
+
+string make_noise(size_t size) {
+  string result(size, '\0');
+  default_random_engine engine{size};
+  uniform_int_distribution<int> dist{0, 255};
+  for (auto& c : result) {
+    c = static_cast<char>(dist(engine));
+  }
+  return result;
+}
+
+void test_codec() {
+  lz_codec codec;
+  vector<buffer_type> inputs{buffer_type{}, to_buf("a"), to_buf("abcd"),
+                             to_buf(string(1000, 'x')),
+                             to_buf(make_text(100000)),
+                             to_buf(make_noise(5000))};
+  for (auto& input : inputs) {
+    buffer_type compressed;
+    codec.compress(input.data(), input.size(), compressed);
+    buffer_type output{'?'};
+    CAF_CHECK(lz_codec::decompress(compressed.data(), compressed.size(),
+                                   output));
+    output.erase(output.begin());
+    CAF_CHECK(output == input);
+  }
+  buffer_type compressed;
+  auto text = to_buf(make_text(10000));
+  codec.compress(text.data(), text.size(), compressed);
+  CAF_CHECK(compressed.size() * 4 < text.size());
+  // original size exceeds the limit of the receiver
+  buffer_type output;
+  CAF_CHECK(!lz_codec::decompress(compressed.data(), compressed.size(),
+                                  output, text.size() - 1));
+  CAF_CHECK(output.empty());
+  CAF_CHECK(lz_codec::decompress(compressed.data(), compressed.size(),
+                                 output, text.size()));
+  CAF_CHECK(output == text);
+  // truncated or corrupted input
+  output.clear();
+  CAF_CHECK(!lz_codec::decompress(compressed.data(), compressed.size() - 1,
+                                  output));
+  CAF_CHECK(!lz_codec::decompress(compressed.data(), 3, output));
+  compressed[0] = static_cast<char>(compressed[0] + 1);
+  output.clear();
+  CAF_CHECK(!lz_codec::decompress(compressed.data(), compressed.size(),
+                                  output));
+}
+
+behavior echo() {
+  return {
+    [](const string& str) {
+      return str;
+    }
+  };
+}
+
+void run_client(uint16_t port) {
+  io::compression_threshold(threshold);
+  io::prefer_local_transport(false);
+  auto server = io::remote_actor("127.0.0.1", port);
+  scoped_actor self;
+  // below the threshold, compressible, fragmented, and incompressible
+  vector<string> payloads{"small", make_text(1000), make_text(300000),
+                          make_noise(2000)};
+  for (auto& payload : payloads) {
+    self->sync_send(server, payload).await(
+      [&](const string& str) {
+        CAF_CHECK(str == payload);
+      },
+      after(chrono::seconds(5)) >> [] {
+        CAF_UNEXPECTED_TOUT();
+      }
+    );
+  }
+  anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  CAF_TEST(test_compression);
+  message_builder{argv + 1, argv + argc}.apply({
+    on("-c", spro<uint16_t>) >> [](uint16_t port) {
+      CAF_PRINT("run in client mode");
+      run_client(port);
+    },
+    on() >> [&] {
+      test_codec();
+      io::compression_threshold(threshold);
+      CAF_CHECK_EQUAL(io::compression_threshold(), threshold);
+      io::prefer_local_transport(false);
+      auto port = io::publish(spawn(echo), 0, "127.0.0.1");
+      CAF_PRINT("running on port " << port);
+      scoped_actor self;
+      auto child = run_program(self, argv[0], "-c", port);
+      child.join();
+      self->await_all_other_actors_done();
+      self->receive(
+        [](const string& output) {
+          cout << endl << endl << "*** output of client program ***"
+               << endl << output << endl;
+          CAF_CHECK(output.find("\n0 error(s) detected") != string::npos);
+        }
+      );
+    }
+  });
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -0,0 +1,151 @@
+#include <string>
+#include <vector>
+#include <chrono>
+#include <memory>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+
+using namespace std;
+using namespace caf;
+
+using scheduler::test_coordinator;
+
+namespace {
+
+using log_ptr = shared_ptr<vector<string>>;
+
+// appends `name` and each received integer to `log`
+behavior logger(event_based_actor* self, string name, log_ptr log) {
+  return {
+    [=](int value) {
+      log->push_back(name + to_string(value));
+    },
+    [=](const string&) {
+      self->quit();
+    }
+  };
+}
+
+behavior pong() {
+  return {
+    [](int value) {
+      return value;
+    }
+  };
+}
+
+behavior ping(event_based_actor* self, actor buddy, int rounds,
+              shared_ptr<int> done) {
+  self->send(buddy, 0);
+  return {
+    [=](int value) {
+      if (value + 1 == rounds) {
+        *done = value + 1;
+        self->send_exit(buddy, exit_reason::user_shutdown);
+        self->quit();
+        return;
+      }
+      self->send(buddy, value + 1);
+    }
+  };
+}
+
+behavior sleeper(event_based_actor* self, log_ptr log) {
+  return {
+    [=](int) {
+      log->push_back("message");
+    },
+    after(chrono::seconds(10)) >> [=] {
+      log->push_back("timeout");
+      self->quit();
+    }
+  };
+}
+
+void test_order(test_coordinator& sched) {
+  auto log = make_shared<vector<string>>();
+  auto a = spawn(logger, "a", log);
+  auto b = spawn(logger, "b", log);
+  // both actors run once after spawning
+  CAF_CHECK_EQUAL(sched.num_jobs(), 2);
+  CAF_CHECK_EQUAL(sched.run(), 2);
+  anon_send(a, 1);
+  anon_send(b, 1);
+  anon_send(a, 2);
+  CAF_CHECK_EQUAL(sched.num_jobs(), 2);
+  // resume b first
+  CAF_CHECK(sched.run_job(1));
+  CAF_CHECK(sched.run_once());
+  CAF_CHECK(!sched.run_once());
+  vector<string> expected{"b1", "a1", "a2"};
+  CAF_CHECK(*log == expected);
+  anon_send(a, string("quit"));
+  anon_send(b, string("quit"));
+  CAF_CHECK_EQUAL(sched.run(), 2);
+  CAF_CHECK_EQUAL(sched.num_jobs(), 0);
+}
+
+void test_ping_pong(test_coordinator& sched) {
+  auto done = make_shared<int>(0);
+  spawn(ping, spawn(pong), 100, done);
+  CAF_CHECK_EQUAL(sched.run(1), 1);
+  CAF_CHECK_EQUAL(*done, 0);
+  sched.run();
+  CAF_CHECK_EQUAL(*done, 100);
+  CAF_CHECK_EQUAL(sched.num_jobs(), 0);
+}
+
+void test_virtual_time(test_coordinator& sched) {
+  auto log = make_shared<vector<string>>();
+  auto start = sched.now();
+  auto hdl = spawn(sleeper, log);
+  sched.run();
+  CAF_CHECK_EQUAL(sched.num_delayed(), 1);
+  CAF_CHECK_EQUAL(sched.advance_time(chrono::seconds(5)), 0);
+  anon_send(hdl, 1);
+  sched.run();
+  // the message restarts the timeout
+  CAF_CHECK_EQUAL(sched.advance_time(chrono::seconds(5)), 1);
+  sched.run();
+  CAF_CHECK_EQUAL(log->size(), 1);
+  CAF_CHECK(sched.trigger_timeout());
+  CAF_CHECK((sched.now() - start == chrono::seconds(15)));
+  sched.run();
+  vector<string> expected{"message", "timeout"};
+  CAF_CHECK(*log == expected);
+  // drop outdated timeouts of the terminated actor
+  while (sched.trigger_timeout()) {
+    CAF_CHECK_EQUAL(sched.run(), 0);
+  }
+  start = sched.now();
+  // delayed messages are delivered in order of their due time
+  auto a = spawn(logger, "a", log);
+  sched.run();
+  log->clear();
+  scoped_actor self;
+  self->delayed_send(a, chrono::seconds(2), 2);
+  self->delayed_send(a, chrono::seconds(1), 1);
+  self->delayed_send(a, chrono::seconds(2), 3);
+  CAF_CHECK_EQUAL(sched.advance_time(chrono::seconds(2)), 3);
+  self->delayed_send(a, chrono::seconds(3600), string("quit"));
+  sched.run();
+  expected = vector<string>{"a1", "a2", "a3"};
+  CAF_CHECK(*log == expected);
+  CAF_CHECK(sched.trigger_timeout());
+  CAF_CHECK((sched.now() - start == chrono::seconds(3602)));
+  CAF_CHECK_EQUAL(sched.run(), 1);
+}
+
+} // namespace <anonymous>
+
+int main() {
+  CAF_TEST(test_deterministic_scheduling);
+  auto sched = new test_coordinator;
+  set_scheduler(sched);
+  test_order(*sched);
+  test_ping_pong(*sched);
+  test_virtual_time(*sched);
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -0,0 +1,227 @@
+#include <chrono>
+#include <thread>
+#include <string>
+#include <iostream>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+using stall_atom = atom_constant<atom("stall")>;
+
+constexpr int high_water_mark = 10;
+constexpr int num_messages = 20;
+
+// blocks the I/O thread of this node for a while, i.e.,
+// incoming messages remain unread and receive no credit
+void stall_network() {
+  io::middleman::instance()->backend().post([] {
+    this_thread::sleep_for(chrono::seconds(2));
+  });
+}
+
+behavior consumer(event_based_actor* self) {
+  auto received = make_shared<int>(0);
+  auto out_of_order = make_shared<int>(0);
+  return {
+    [=](ok_atom) {
+      self->delayed_send(self, chrono::milliseconds(100), stall_atom::value);
+      return ok_atom::value;
+    },
+    [=](stall_atom) {
+      stall_network();
+    },
+    [=](int seq, const string&) {
+      if (seq != ++*received) {
+        ++*out_of_order;
+      }
+    },
+    [=](get_atom) {
+      return make_message(*received, *out_of_order);
+    }
+  };
+}
+
+// an outbound queue whose broker already lost the remote node
+class closed_queue : public outbound_queue {
+ public:
+  closed_queue() {
+    close();
+  }
+
+  void wakeup() override {
+    // nop
+  }
+};
+
+void test_closed_queue() {
+  scoped_actor self;
+  auto mgr = spawn([](event_based_actor*) -> behavior {
+    return {
+      others() >> [] {
+        // nop
+      }
+    };
+  });
+  auto queue = detail::make_counted<closed_queue>();
+  auto proxy = detail::make_counted<forwarding_actor_proxy>(
+    42, invalid_node_id, mgr, queue, high_water_mark,
+    backpressure_policy::error_reply);
+  auto dest = actor_cast<actor>(proxy);
+  // requests to an unreachable node fail immediately ...
+  self->sync_send(dest, ok_atom::value).await(
+    [](const sync_exited_msg& msg) {
+      CAF_CHECK_EQUAL(msg.reason, exit_reason::remote_link_unreachable);
+    },
+    others() >> CAF_UNEXPECTED_MSG_CB_REF(self),
+    after(chrono::seconds(1)) >> CAF_UNEXPECTED_TOUT_CB()
+  );
+  // ... and undelivered messages take no credit
+  for (int i = 0; i < num_messages; ++i) {
+    self->send(dest, i, string("x"));
+  }
+  CAF_CHECK(!proxy->backpressure());
+  anon_send_exit(mgr, exit_reason::user_shutdown);
+}
+
+// an outbound queue that no broker ever drains
+class stalled_queue : public outbound_queue {
+ public:
+  void wakeup() override {
+    // nop
+  }
+};
+
+void test_stalled_queue() {
+  scoped_actor self;
+  auto mgr = spawn([](event_based_actor*) -> behavior {
+    return {
+      others() >> [] {
+        // nop
+      }
+    };
+  });
+  auto make_proxy = [&](backpressure_policy policy) {
+    auto queue = detail::make_counted<stalled_queue>();
+    return detail::make_counted<forwarding_actor_proxy>(42, invalid_node_id,
+                                                        mgr, queue, 1, policy);
+  };
+  // dropping a request still answers it
+  auto dropping = actor_cast<actor>(make_proxy(backpressure_policy::drop));
+  self->send(dropping, ok_atom::value);
+  self->sync_send(dropping, ok_atom::value).await(
+    [](error_atom, const string& what) {
+      CAF_CHECK_EQUAL(what, "backpressure");
+    },
+    others() >> CAF_UNEXPECTED_MSG_CB_REF(self),
+    after(chrono::seconds(1)) >> CAF_UNEXPECTED_TOUT_CB()
+  );
+  // scheduled senders never block on a suspending proxy,
+  // they receive an error for each message exceeding the limit
+  auto suspending = actor_cast<actor>(make_proxy(backpressure_policy::suspend));
+  auto sender = spawn([=](event_based_actor* ptr) -> behavior {
+    for (int i = 0; i < num_messages; ++i) {
+      ptr->send(suspending, i, string("x"));
+    }
+    auto errors = make_shared<int>(0);
+    return {
+      [=](error_atom, const string& what) {
+        CAF_CHECK_EQUAL(what, "backpressure");
+        if (++*errors == num_messages - 1) {
+          ptr->quit();
+        }
+      }
+    };
+  });
+  self->monitor(sender);
+  self->receive(
+    [&](const down_msg& dm) {
+      CAF_CHECK(dm.source == sender);
+    },
+    after(chrono::seconds(1)) >> CAF_UNEXPECTED_TOUT_CB()
+  );
+  anon_send_exit(mgr, exit_reason::user_shutdown);
+}
+
+void run_client(uint16_t port) {
+  io::actor_credit(high_water_mark);
+  io::connection_credit(1024);
+  io::on_backpressure(backpressure_policy::error_reply);
+  auto server = io::remote_actor("127.0.0.1", port);
+  auto ptr = actor_cast<abstract_actor_ptr>(server);
+  auto proxy = dynamic_cast<forwarding_actor_proxy*>(ptr.get());
+  CAF_CHECK(proxy != nullptr);
+  scoped_actor self;
+  self->sync_send(server, ok_atom::value).await(
+    [](ok_atom) {
+      CAF_CHECKPOINT();
+    }
+  );
+  // wait until the server stopped reading
+  this_thread::sleep_for(chrono::milliseconds(500));
+  CAF_CHECK(proxy && !proxy->backpressure());
+  for (int i = 1; i <= num_messages; ++i) {
+    self->send(server, i, string(300, 'x'));
+  }
+  CAF_CHECK(proxy && proxy->backpressure());
+  int errors = 0;
+  self->receive_for(errors, num_messages - high_water_mark) (
+    [&](error_atom, const string& what) {
+      CAF_CHECK_EQUAL(what, "backpressure");
+      CAF_CHECK(self->last_sender() == server);
+    },
+    after(chrono::seconds(1)) >> [] {
+      CAF_UNEXPECTED_TOUT();
+    }
+  );
+  CAF_CHECK_EQUAL(errors, num_messages - high_water_mark);
+  // the server returns credit once it reads again
+  for (int i = 0; i < 100 && proxy && proxy->backpressure(); ++i) {
+    this_thread::sleep_for(chrono::milliseconds(50));
+  }
+  CAF_CHECK(proxy && !proxy->backpressure());
+  // all accepted messages arrived in order
+  self->sync_send(server, get_atom::value).await(
+    [](int received, int out_of_order) {
+      CAF_CHECK_EQUAL(received, high_water_mark);
+      CAF_CHECK_EQUAL(out_of_order, 0);
+    }
+  );
+  anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  CAF_TEST(test_flow_control);
+  message_builder{argv + 1, argv + argc}.apply({
+    on("-c", spro<uint16_t>) >> [](uint16_t port) {
+      CAF_PRINT("run in client mode");
+      run_client(port);
+    },
+    on() >> [&] {
+      test_closed_queue();
+      test_stalled_queue();
+      auto port = io::publish(spawn(consumer), 0, "127.0.0.1");
+      CAF_PRINT("running on port " << port);
+      scoped_actor self;
+      auto child = run_program(self, argv[0], "-c", port);
+      child.join();
+      self->await_all_other_actors_done();
+      self->receive(
+        [](const string& output) {
+          cout << endl << endl << "*** output of client program ***"
+               << endl << output << endl;
+          CAF_CHECK(output.find("\n0 error(s) detected") != string::npos);
+        }
+      );
+    }
+  });
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -0,0 +1,140 @@
+#include <string>
+#include <iostream>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+constexpr size_t fragment = 4 * 1024;
+constexpr size_t large_size = 2 * 1024 * 1024;
+constexpr int num_small = 100;
+
+// replies to each string with its size and a checksum
+behavior sink() {
+  auto received = make_shared<int>(0);
+  auto out_of_order = make_shared<int>(0);
+  return {
+    [=](const string& str) {
+      size_t sum = 0;
+      for (auto c : str) {
+        sum += static_cast<unsigned char>(c);
+      }
+      return make_message(str.size(), sum);
+    },
+    [=](int seq) {
+      if (seq != ++*received) {
+        ++*out_of_order;
+      }
+    },
+    [=](get_atom) {
+      return make_message(*received, *out_of_order);
+    }
+  };
+}
+
+string make_payload(size_t size, size_t& sum) {
+  string result(size, '\0');
+  sum = 0;
+  for (size_t i = 0; i < size; ++i) {
+    result[i] = static_cast<char>(i % 251);
+    sum += i % 251;
+  }
+  return result;
+}
+
+void run_client(uint16_t port) {
+  io::fragment_size(fragment);
+  CAF_CHECK_EQUAL(io::fragment_size(), fragment);
+  io::prefer_local_transport(false);
+  auto server = io::remote_actor("127.0.0.1", port);
+  scoped_actor self;
+  size_t sum;
+  auto large = make_payload(large_size, sum);
+  // large messages share the connection with small ones from another
+  // actor, while messages from the same sender keep their order
+  spawn([=](event_based_actor* ptr) {
+    for (int i = 1; i <= num_small; ++i) {
+      ptr->send(server, i);
+    }
+  });
+  self->send(server, large);
+  self->send(server, large.substr(0, large_size / 2 + 1));
+  self->send(server, string("small"));
+  size_t half_sum;
+  make_payload(large_size / 2 + 1, half_sum);
+  int i = 0;
+  self->receive_for(i, 3) (
+    [&](size_t size, size_t checksum) {
+      switch (i) {
+        case 0:
+          CAF_CHECK_EQUAL(size, large_size);
+          CAF_CHECK_EQUAL(checksum, sum);
+          break;
+        case 1:
+          CAF_CHECK_EQUAL(size, large_size / 2 + 1);
+          CAF_CHECK_EQUAL(checksum, half_sum);
+          break;
+        default:
+          CAF_CHECK_EQUAL(size, 5);
+      }
+    },
+    after(chrono::seconds(10)) >> [] {
+      CAF_UNEXPECTED_TOUT();
+    }
+  );
+  self->await_all_other_actors_done();
+  self->sync_send(server, get_atom::value).await(
+    [](int received, int out_of_order) {
+      CAF_CHECK_EQUAL(received, num_small);
+      CAF_CHECK_EQUAL(out_of_order, 0);
+    }
+  );
+  // the server disconnects peers exceeding its reassembly limits
+  self->monitor(server);
+  self->send(server, string(2 * large_size, 'x'));
+  self->receive(
+    [&](const down_msg& dm) {
+      CAF_CHECK_EQUAL(dm.reason, exit_reason::remote_link_unreachable);
+    },
+    after(chrono::seconds(10)) >> CAF_UNEXPECTED_TOUT_CB()
+  );
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  CAF_TEST(test_fragmentation);
+  message_builder{argv + 1, argv + argc}.apply({
+    on("-c", spro<uint16_t>) >> [](uint16_t port) {
+      CAF_PRINT("run in client mode");
+      run_client(port);
+    },
+    on() >> [&] {
+      io::fragment_size(fragment);
+      io::max_msg_size(large_size + fragment);
+      io::prefer_local_transport(false);
+      auto server = spawn(sink);
+      auto port = io::publish(server, 0, "127.0.0.1");
+      CAF_PRINT("running on port " << port);
+      scoped_actor self;
+      auto child = run_program(self, argv[0], "-c", port);
+      child.join();
+      anon_send_exit(server, exit_reason::user_shutdown);
+      self->await_all_other_actors_done();
+      self->receive(
+        [](const string& output) {
+          cout << endl << endl << "*** output of client program ***"
+               << endl << output << endl;
+          CAF_CHECK(output.find("\n0 error(s) detected") != string::npos);
+        }
+      );
+    }
+  });
+  shutdown();
+  return CAF_TEST_RESULT();
+}
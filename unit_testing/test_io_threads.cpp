@@ -0,0 +1,316 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <set>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <functional>
+#include <iostream>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+using namespace caf::io;
+
+using publish_atom = atom_constant<atom("publish")>;
+using done_atom = atom_constant<atom("done")>;
+using assign_atom = atom_constant<atom("assign")>;
+using backend_atom = atom_constant<atom("backend")>;
+using hello_atom = atom_constant<atom("hello")>;
+
+namespace {
+
+constexpr size_t num_threads = 4;
+constexpr size_t num_pairs = 8;
+constexpr int num_rounds = 100;
+constexpr size_t num_clients = 4;
+constexpr size_t num_client_threads = 2;
+
+// echoes each integer it receives
+behavior echo_conn(broker* self, connection_handle hdl) {
+  self->configure_read(hdl, receive_policy::exactly(sizeof(int)));
+  return {
+    [=](const new_data_msg& msg) {
+      self->write(hdl, msg.buf.size(), msg.buf.data());
+      self->flush(hdl);
+    },
+    [=](const connection_closed_msg&) {
+      self->quit();
+    }
+  };
+}
+
+behavior echo_server(broker* self) {
+  return {
+    [=](const new_connection_msg& msg) {
+      self->fork(echo_conn, msg.handle);
+      self->quit();
+    },
+    [=](publish_atom) {
+      return self->add_tcp_doorman(0, "127.0.0.1").second;
+    }
+  };
+}
+
+// sends `num_rounds` integers one after another and
+// reports the thread it is running in when done
+void client(broker* self, connection_handle hdl, const actor& listener) {
+  self->configure_read(hdl, receive_policy::exactly(sizeof(int)));
+  int value = 0;
+  self->write(hdl, sizeof(value), &value);
+  self->flush(hdl);
+  self->become(
+    [=](const new_data_msg& msg) {
+      int x;
+      memcpy(&x, msg.buf.data(), sizeof(int));
+      if (++x == num_rounds) {
+        auto tid = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        self->send(listener, done_atom::value, static_cast<uint64_t>(tid));
+        self->quit();
+        return;
+      }
+      self->write(hdl, sizeof(x), &x);
+      self->flush(hdl);
+    }
+  );
+}
+
+uint64_t backend_id(broker* self) {
+  return reinterpret_cast<uintptr_t>(&self->backend());
+}
+
+// owns an accept handle registered at its multiplexer
+behavior owner(broker* self) {
+  return {
+    [=](backend_atom) {
+      return backend_id(self);
+    },
+    [=](publish_atom) {
+      return self->add_tcp_doorman(0, "127.0.0.1").first;
+    }
+  };
+}
+
+// takes over accept handles and reports its first connection
+behavior acceptor(broker* self, const actor& listener) {
+  return {
+    [=](backend_atom) {
+      return backend_id(self);
+    },
+    [=](assign_atom, accept_handle hdl) -> message {
+      try {
+        self->assign_tcp_doorman(hdl);
+      }
+      catch (network_error&) {
+        return make_message(error_atom::value);
+      }
+      return make_message(ok_atom::value);
+    },
+    [=](const new_connection_msg&) {
+      self->send(listener, done_atom::value, uint64_t{0});
+      self->quit();
+    }
+  };
+}
+
+void disconnect(broker* self, connection_handle) {
+  self->quit();
+}
+
+void test_assign() {
+  scoped_actor self;
+  auto a = spawn_io(owner);
+  auto b = spawn_io(acceptor, actor{self});
+  uint64_t backends[2];
+  int i = 0;
+  for (auto& bro : {a, b}) {
+    self->sync_send(bro, backend_atom::value).await(
+      [&](uint64_t id) {
+        backends[i++] = id;
+      }
+    );
+  }
+  // brokers are spawned round-robin
+  CAF_CHECK(backends[0] != backends[1]);
+  // handles of brokers on another multiplexer are rejected ...
+  accept_handle owned;
+  self->sync_send(a, publish_atom::value).await(
+    [&](accept_handle hdl) {
+      owned = hdl;
+    }
+  );
+  self->sync_send(b, assign_atom::value, owned).await(
+    [](error_atom) {
+      CAF_CHECKPOINT();
+    },
+    others() >> CAF_UNEXPECTED_MSG_CB_REF(self)
+  );
+  // ... whereas unowned handles of the primary multiplexer move
+  auto res = middleman::instance()->backend().new_tcp_doorman(0, "127.0.0.1",
+                                                              true);
+  self->sync_send(b, assign_atom::value, res.first).await(
+    [](ok_atom) {
+      CAF_CHECKPOINT();
+    },
+    others() >> CAF_UNEXPECTED_MSG_CB_REF(self)
+  );
+  spawn_io_client(disconnect, "127.0.0.1", res.second);
+  self->receive(
+    [](done_atom, uint64_t) {
+      CAF_CHECKPOINT();
+    },
+    after(chrono::seconds(5)) >> CAF_UNEXPECTED_TOUT_CB()
+  );
+  anon_send_exit(a, exit_reason::user_shutdown);
+}
+
+// introduces each client to the next one, whereas clients
+// exchange messages via this node only
+behavior hub(event_based_actor* self) {
+  auto clients = std::make_shared<std::vector<actor>>();
+  auto done = std::make_shared<size_t>(0);
+  return {
+    [=](ping_atom, int value) {
+      return make_message(pong_atom::value, value);
+    },
+    [=](const actor& client) {
+      clients->push_back(client);
+      if (clients->size() == num_clients) {
+        for (size_t i = 0; i < num_clients; ++i) {
+          self->send((*clients)[i], (*clients)[(i + 1) % num_clients]);
+        }
+      }
+    },
+    [=](done_atom) {
+      if (++*done < num_clients) {
+        return;
+      }
+      for (auto& client : *clients) {
+        self->send(client, done_atom::value);
+      }
+      self->quit();
+    }
+  };
+}
+
+void run_client(uint16_t port) {
+  io_threads(num_client_threads);
+  scoped_actor self;
+  auto server = remote_actor("127.0.0.1", port);
+  // another multiplexer re-uses the connection to the server
+  for (size_t i = 1; i < num_client_threads; ++i) {
+    CAF_CHECK(remote_actor("127.0.0.1", port) == server);
+  }
+  for (int i = 0; i < num_rounds; ++i) {
+    self->sync_send(server, ping_atom::value, i).await(
+      [&](pong_atom, int value) {
+        CAF_CHECK_EQUAL(value, i);
+      }
+    );
+  }
+  self->send(server, actor{self});
+  int i = 0;
+  self->receive_for(i, 2) (
+    [&](const actor& next) {
+      self->send(next, hello_atom::value);
+    },
+    [](hello_atom) {
+      CAF_CHECKPOINT();
+    },
+    after(chrono::seconds(10)) >> CAF_UNEXPECTED_TOUT_CB()
+  );
+  self->send(server, done_atom::value);
+  self->receive(
+    [](done_atom) {
+      CAF_CHECKPOINT();
+    },
+    after(chrono::seconds(10)) >> CAF_UNEXPECTED_TOUT_CB()
+  );
+  self->await_all_other_actors_done();
+}
+
+// connects several nodes to the BASP brokers of all IO threads
+void test_remote_nodes(const char* path) {
+  scoped_actor self;
+  auto port = publish(spawn(hub), 0, "127.0.0.1");
+  std::vector<std::thread> children;
+  for (size_t i = 0; i < num_clients; ++i) {
+    children.push_back(run_program(self, path, "-c", port));
+  }
+  for (auto& child : children) {
+    child.join();
+  }
+  size_t i = 0;
+  self->receive_for(i, num_clients) (
+    [](const string& output) {
+      cout << endl << endl << "*** output of client program ***"
+           << endl << output << endl;
+      CAF_CHECK(output.find("\n0 error(s) detected") != string::npos);
+    }
+  );
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  CAF_TEST(test_io_threads);
+  message_builder{argv + 1, argv + argc}.apply({
+    on("-c", spro<uint16_t>) >> [](uint16_t port) {
+      CAF_PRINT("run in client mode");
+      run_client(port);
+    },
+    on() >> [&] {
+      io_threads(num_threads);
+      CAF_CHECK_EQUAL(io_threads(), num_threads);
+      { // lifetime scope of self
+        scoped_actor self;
+        CAF_CHECK_EQUAL(middleman::instance()->num_backends(), num_threads);
+        for (size_t i = 0; i < num_pairs; ++i) {
+          auto serv = spawn_io(echo_server);
+          self->sync_send(serv, publish_atom::value).await(
+            [&](uint16_t port) {
+              actor listener = self;
+              spawn_io_client(client, "127.0.0.1", port, listener);
+            }
+          );
+        }
+        std::set<uint64_t> threads;
+        for (size_t i = 0; i < num_pairs; ++i) {
+          self->receive(
+            [&](done_atom, uint64_t tid) {
+              threads.insert(tid);
+            }
+          );
+        }
+        // clients are distributed among all IO threads
+        CAF_CHECK(threads.size() > 1);
+      }
+      test_assign();
+      test_remote_nodes(argv[0]);
+    }
+  });
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
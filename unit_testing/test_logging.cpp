@@ -0,0 +1,58 @@
+#include <typeinfo>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+#include "caf/detail/logging.hpp"
+
+using namespace caf;
+
+using caf::detail::logging;
+
+namespace {
+
+template <class T>
+bool accepts(int level) {
+  return logging::accepts(level, typeid(T).name());
+}
+
+} // namespace <anonymous>
+
+int main() {
+  CAF_TEST(test_logging);
+  logging::set_level(CAF_WARNING);
+  CAF_CHECK(accepts<actor>(CAF_ERROR));
+  CAF_CHECK(accepts<io::basp_broker>(CAF_WARNING));
+  CAF_CHECK(!accepts<io::basp_broker>(CAF_INFO));
+  // enable tracing for one namespace
+  logging::set_level("caf::io", CAF_TRACE);
+  CAF_CHECK(accepts<io::basp_broker>(CAF_TRACE));
+  CAF_CHECK(accepts<io::middleman>(CAF_DEBUG));
+  CAF_CHECK(!accepts<actor>(CAF_INFO));
+  CAF_CHECK(logging::accepts(CAF_TRACE, "caf::io::broker"));
+  CAF_CHECK(!logging::accepts(CAF_TRACE, "caf::iox"));
+  // the most specific component wins, in either notation
+  logging::set_level("caf.io.basp_broker", CAF_INFO);
+  CAF_CHECK(accepts<io::basp_broker>(CAF_INFO));
+  CAF_CHECK(!accepts<io::basp_broker>(CAF_DEBUG));
+  CAF_CHECK(accepts<io::middleman>(CAF_TRACE));
+  // statements above CAF_LOG_LEVEL remain disabled
+# ifdef CAF_LOG_LEVEL
+    CAF_CHECK_EQUAL(logging::enabled(CAF_TRACE), CAF_LOG_LEVEL >= CAF_TRACE);
+# else
+    CAF_CHECK(!logging::enabled(CAF_WARNING));
+# endif
+  logging::reset_levels();
+  CAF_CHECK(!accepts<io::basp_broker>(CAF_INFO));
+  CAF_CHECK(!accepts<io::middleman>(CAF_DEBUG));
+  // a component level below the global level silences the component
+  logging::set_level(CAF_DEBUG);
+  logging::set_level("caf.io", CAF_ERROR);
+  CAF_CHECK(accepts<io::basp_broker>(CAF_ERROR));
+  CAF_CHECK(!accepts<io::basp_broker>(CAF_WARNING));
+  CAF_CHECK(!accepts<io::middleman>(CAF_INFO));
+  CAF_CHECK(accepts<actor>(CAF_DEBUG));
+  logging::reset_levels();
+  CAF_CHECK(accepts<io::middleman>(CAF_DEBUG));
+  return CAF_TEST_RESULT();
+}
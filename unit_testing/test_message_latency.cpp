@@ -0,0 +1,107 @@
+#include <thread>
+#include <chrono>
+#include <sstream>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+constexpr int num_messages = 5;
+
+// the dynamic type of sleeper instances
+const type_info* sleeper_type;
+
+class sleeper : public event_based_actor {
+ public:
+  behavior make_behavior() override {
+    sleeper_type = &typeid(*this);
+    return {
+      [=](int i) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+        return i;
+      }
+    };
+  }
+};
+
+void test_histogram() {
+  latency_histogram hg;
+  for (uint64_t i = 0; i < 16; ++i) {
+    CAF_CHECK_EQUAL(latency_histogram::bucket_of(i), i);
+    CAF_CHECK_EQUAL(latency_histogram::upper_bound_of(i), i);
+  }
+  // each bucket contains its upper bound and starts after the previous one
+  for (size_t i = 16; i < latency_histogram::num_buckets - 1; ++i) {
+    auto x = latency_histogram::upper_bound_of(i);
+    CAF_CHECK_EQUAL(latency_histogram::bucket_of(x), i);
+    CAF_CHECK_EQUAL(latency_histogram::bucket_of(x + 1), i + 1);
+  }
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    hg.record(i * 1000);
+  }
+  CAF_CHECK_EQUAL(hg.count(), 1000);
+  CAF_CHECK_EQUAL(hg.max(), 1000000);
+  CAF_CHECK(hg.mean() > 500000 && hg.mean() < 501000);
+  // each bucket covers at most 1/16 of its values
+  auto p50 = hg.percentile(50);
+  CAF_CHECK(p50 >= 500000 && p50 <= 500000 + 500000 / 16);
+  auto p99 = hg.percentile(99);
+  CAF_CHECK(p99 >= 990000 && p99 <= 1000000);
+  hg.reset();
+  CAF_CHECK_EQUAL(hg.count(), 0);
+  CAF_CHECK_EQUAL(hg.percentile(50), 0);
+}
+
+} // namespace <anonymous>
+
+int main() {
+  CAF_TEST(test_message_latency);
+  test_histogram();
+  CAF_CHECK(!trace_message_latency());
+  trace_message_latency(true);
+  { // lifetime scope of self
+    scoped_actor self;
+    auto worker = spawn<sleeper>();
+    // messages wait in the mailbox of the worker while it sleeps
+    for (int i = 0; i < num_messages; ++i) {
+      self->send(worker, i);
+    }
+    int i = 0;
+    self->receive_for(i, num_messages) (
+      [&](int value) {
+        CAF_CHECK_EQUAL(value, i);
+      }
+    );
+    self->send_exit(worker, exit_reason::user_shutdown);
+    self->await_all_other_actors_done();
+    // blocking actors record the latency of receive() as well
+    self->send(self, atom("ping"));
+    this_thread::sleep_for(chrono::milliseconds(10));
+    self->receive(
+      on(atom("ping")) >> [] {
+        // nop
+      }
+    );
+    auto& sleeper_lat = message_latency_of(*sleeper_type);
+    // the exit message counts as handled message as well
+    CAF_CHECK(sleeper_lat.handling.count() >= num_messages);
+    CAF_CHECK(sleeper_lat.handling.percentile(50) >= 10000000);
+    // the last message waits for all others
+    CAF_CHECK(sleeper_lat.queueing.max() >= 40000000);
+    auto& self_lat = message_latency_of(typeid(*self.get()));
+    CAF_CHECK(self_lat.queueing.count() >= num_messages + 1);
+    CAF_CHECK(self_lat.queueing.max() >= 10000000);
+    ostringstream oss;
+    dump_message_latency(oss);
+    CAF_CHECK(oss.str().find("sleeper") != string::npos);
+  }
+  await_all_actors_done();
+  trace_message_latency(false);
+  reset_message_latency();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -0,0 +1,116 @@
+#include <map>
+#include <string>
+#include <iostream>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+constexpr int num_senders = 8;
+constexpr int num_messages = 500;
+constexpr size_t bulk_threshold = 64 * 1024;
+
+// counts messages per sender and the number of
+// messages that did not arrive in sending order
+behavior sequence_checker(event_based_actor* self) {
+  using counters = map<actor_addr, pair<int, int>>;
+  auto state = std::make_shared<counters>();
+  return {
+    [=](int seq) {
+      auto& x = (*state)[self->last_sender()];
+      if (seq != x.first + 1) {
+        ++x.second;
+      }
+      x.first = seq;
+    },
+    [=](const string& str) -> size_t {
+      return str.size();
+    },
+    [=](get_atom) -> message {
+      auto& x = (*state)[self->last_sender()];
+      return make_message(x.first, x.second);
+    }
+  };
+}
+
+behavior sender(event_based_actor* self, const actor& checker) {
+  return {
+    [=](ok_atom) {
+      for (int i = 1; i <= num_messages; ++i) {
+        self->send(checker, i);
+      }
+      // the query travels on the same connection as the messages
+      auto rp = self->make_response_promise();
+      self->sync_send(checker, get_atom::value).then(
+        [=](int received, int out_of_order) {
+          rp.deliver(make_message(received, out_of_order));
+          self->quit();
+        }
+      );
+    }
+  };
+}
+
+void run_client(uint16_t port) {
+  io::prefer_local_transport(false);
+  io::connections_per_peer(0);
+  CAF_CHECK_EQUAL(io::connections_per_peer(), 1);
+  io::connections_per_peer(4);
+  CAF_CHECK_EQUAL(io::connections_per_peer(), 4);
+  io::bulk_connection_threshold(bulk_threshold);
+  auto checker = io::remote_actor("127.0.0.1", port);
+  scoped_actor self;
+  for (int i = 0; i < num_senders; ++i) {
+    auto s = spawn(sender, checker);
+    self->sync_send(s, ok_atom::value).await(
+      [](int received, int out_of_order) {
+        CAF_CHECK_EQUAL(received, num_messages);
+        CAF_CHECK_EQUAL(out_of_order, 0);
+      }
+    );
+  }
+  // large messages use the bulk connection
+  for (size_t size : {bulk_threshold - 1, bulk_threshold * 4}) {
+    self->sync_send(checker, string(size, 'x')).await(
+      [&](size_t received) {
+        CAF_CHECK_EQUAL(received, size);
+      }
+    );
+  }
+  anon_send_exit(checker, exit_reason::user_shutdown);
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  CAF_TEST(test_parallel_connections);
+  message_builder{argv + 1, argv + argc}.apply({
+    on("-c", spro<uint16_t>) >> [](uint16_t port) {
+      CAF_PRINT("run in client mode");
+      run_client(port);
+    },
+    on() >> [&] {
+      io::prefer_local_transport(false);
+      auto port = io::publish(spawn(sequence_checker), 0, "127.0.0.1");
+      CAF_PRINT("running on port " << port);
+      scoped_actor self;
+      auto child = run_program(self, argv[0], "-c", port);
+      child.join();
+      self->await_all_other_actors_done();
+      self->receive(
+        [](const string& output) {
+          cout << endl << endl << "*** output of client program ***"
+               << endl << output << endl;
+          CAF_CHECK(output.find("\n0 error(s) detected") != string::npos);
+        }
+      );
+    }
+  });
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -0,0 +1,185 @@
+#include <string>
+#include <thread>
+#include <chrono>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+using go_atom = atom_constant<atom("go")>;
+
+constexpr int num_messages = 10;
+
+// returns the row of `rows` with `key` as first element
+template <class Key>
+message find_row(const message& rows, const Key& key) {
+  for (size_t i = 0; i < rows.size(); ++i) {
+    auto& x = rows.get_as<message>(i);
+    if (x.get_as<Key>(0) == key) {
+      return x;
+    }
+  }
+  return message{};
+}
+
+// returns the row of `rows` with a first element containing `str`
+message find_type(const message& rows, const string& str) {
+  for (size_t i = 0; i < rows.size(); ++i) {
+    auto& x = rows.get_as<message>(i);
+    if (x.get_as<string>(0).find(str) != string::npos) {
+      return x;
+    }
+  }
+  return message{};
+}
+
+void check_tables(const message& actors, const message& workers,
+                  const message& memory) {
+  for (size_t i = 0; i < actors.size(); ++i) {
+    CAF_CHECK((actors.get_as<message>(i).has_types<actor_id, string,
+                                                   uint64_t, uint64_t,
+                                                   double>()));
+  }
+  CAF_CHECK_EQUAL(workers.size(),
+                  detail::singletons::get_scheduling_coordinator()
+                  ->num_workers());
+  for (size_t i = 0; i < workers.size(); ++i) {
+    auto& row = workers.get_as<message>(i);
+    CAF_CHECK((row.has_types<uint64_t, uint64_t, uint64_t, double>()));
+    CAF_CHECK_EQUAL(row.get_as<uint64_t>(0), i);
+  }
+  for (size_t i = 0; i < memory.size(); ++i) {
+    CAF_CHECK((memory.get_as<message>(i).has_types<string, int64_t,
+                                                   uint64_t>()));
+  }
+}
+
+void test_queries(const actor& inspector) {
+  scoped_actor self;
+  // keeps the integers in its mailbox until receiving `go`
+  auto worker = spawn<blocking_api>([](blocking_actor* ptr) {
+    ptr->receive(
+      [](go_atom) {
+        // nop
+      }
+    );
+    int i = 0;
+    ptr->receive_for(i, num_messages) (
+      [](int) {
+        // nop
+      }
+    );
+  });
+  for (int i = 0; i < num_messages; ++i) {
+    self->send(worker, i);
+  }
+  self->sync_send(inspector, get_atom::value, actors_atom::value).await(
+    [&](actors_atom, const message& rows) {
+      auto row = find_row(rows, worker.id());
+      CAF_CHECK((row.has_types<actor_id, string, uint64_t, uint64_t,
+                               double>()));
+      if (!row.empty()) {
+        CAF_CHECK_EQUAL(row.get_as<string>(1),
+                        "caf::blocking_actor::functor_based");
+        CAF_CHECK_EQUAL(row.get_as<uint64_t>(2), num_messages);
+        CAF_CHECK_EQUAL(row.get_as<uint64_t>(3), 0);
+      }
+      CAF_CHECK(!find_row(rows, self->id()).empty());
+    },
+    others() >> [&] {
+      CAF_UNEXPECTED_MSG(self);
+    },
+    after(chrono::seconds(5)) >> [] {
+      CAF_UNEXPECTED_TOUT();
+    }
+  );
+  self->sync_send(inspector, get_atom::value, memory_atom::value).await(
+    [&](memory_atom, const message& rows) {
+      auto row = find_type(rows, "mailbox_element");
+      CAF_CHECK((row.has_types<string, int64_t, uint64_t>()));
+      if (!row.empty()) {
+        CAF_CHECK(row.get_as<int64_t>(1) >= num_messages);
+      }
+    },
+    after(chrono::seconds(5)) >> [] {
+      CAF_UNEXPECTED_TOUT();
+    }
+  );
+  self->send(worker, go_atom::value);
+  self->await_all_other_actors_done();
+  // give the workers some time to finish resuming the inspector
+  this_thread::sleep_for(chrono::milliseconds(50));
+  self->sync_send(inspector, get_atom::value).await(
+    [&](snapshot_atom, const message& actors, const message& workers,
+        const message& memory) {
+      CAF_CHECK(find_row(actors, worker.id()).empty());
+      check_tables(actors, workers, memory);
+      uint64_t resumed = 0;
+      for (size_t i = 0; i < workers.size(); ++i) {
+        resumed += workers.get_as<message>(i).get_as<uint64_t>(1);
+      }
+      CAF_CHECK(resumed > 0);
+    },
+    after(chrono::seconds(5)) >> [] {
+      CAF_UNEXPECTED_TOUT();
+    }
+  );
+}
+
+void test_subscription(const actor& inspector) {
+  scoped_actor self;
+  self->send(inspector, subscribe_atom::value, uint32_t{10});
+  int i = 0;
+  self->receive_for(i, 3) (
+    [](snapshot_atom, const message& actors, const message& workers,
+       const message& memory) {
+      check_tables(actors, workers, memory);
+    },
+    after(chrono::seconds(5)) >> [] {
+      CAF_UNEXPECTED_TOUT();
+    }
+  );
+  self->send(inspector, subscribe_atom::value, uint32_t{0});
+  // drain snapshots sent before unsubscribing
+  self->sync_send(inspector, get_atom::value, memory_atom::value).await(
+    [](memory_atom, const message&) {
+      // nop
+    }
+  );
+  self->receive(
+    [](snapshot_atom, const message&, const message&, const message&) {
+      // nop
+    },
+    after(chrono::milliseconds(50)) >> [] {
+      // nop
+    }
+  );
+  self->receive(
+    others() >> [&] {
+      CAF_UNEXPECTED_MSG(self);
+    },
+    after(chrono::milliseconds(100)) >> [] {
+      // nop
+    }
+  );
+}
+
+} // namespace <anonymous>
+
+int main() {
+  CAF_TEST(test_runtime_inspector);
+  CAF_CHECK(!inspect_runtime());
+  auto inspector = spawn_runtime_inspector();
+  CAF_CHECK(inspect_runtime());
+  test_queries(inspector);
+  test_subscription(inspector);
+  anon_send_exit(inspector, exit_reason::user_shutdown);
+  inspect_runtime(false);
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
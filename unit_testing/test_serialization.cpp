@@ -145,6 +145,36 @@ int main() {
   CAF_CHECK(nid2);
   if (nid2) {
     CAF_CHECK_EQUAL(to_string(nid), to_string(*nid2));
+    // node IDs are interned, i.e., equal IDs share the same data
+    CAF_CHECK(nid == *nid2);
+  }
+  node_id nid3{nid.process_id(), nid.host_id()};
+  node_id nid4{nid.process_id() + 1, nid.host_id()};
+  CAF_CHECK(nid == nid3);
+  CAF_CHECK(nid != nid4);
+  CAF_CHECK(nid < nid4 && nid4 > nid3);
+  CAF_CHECK(nid4 != invalid_node_id);
+
+  // message types with unknown element types are rejected
+  CAF_CHECK(!from_string<message>("@<>+@i32+unknown_type ( 1, 2 )"));
+  vector<char> buf;
+  binary_serializer bs(back_inserter(buf));
+  bs << make_message(1, 2);
+  // replace the second "@i32" with "@x32" in the binary representation
+  string tname = "@<>+@i32+@i32";
+  auto i = search(buf.begin(), buf.end(), tname.begin(), tname.end());
+  CAF_CHECK(i != buf.end());
+  if (i != buf.end()) {
+    *(i + 10) = 'x';
+    binary_deserializer bd(buf.data(), buf.size());
+    message msg;
+    try {
+      uniform_typeid<message>()->deserialize(&msg, &bd);
+      CAF_FAILURE("deserialized a message with an unknown element type");
+    }
+    catch (std::runtime_error&) {
+      CAF_CHECKPOINT();
+    }
   }
 
   /*
@@ -0,0 +1,210 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include <string>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+using namespace caf::io;
+
+using done_atom = atom_constant<atom("done")>;
+
+namespace {
+
+// exceeds the capacity of a ring, i.e., forces both sides to wait
+constexpr size_t bulk_size = 4 * 1024 * 1024 + 3;
+
+constexpr int ping_pong_rounds = 1000;
+
+string socket_path(const char* name) {
+  return "/tmp/caf-test-" + to_string(getpid()) + "-" + name + ".sock";
+}
+
+bool file_exists(const string& path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0;
+}
+
+// brokers open and close sockets asynchronously
+bool await_file(const string& path, bool exists) {
+  for (int i = 0; i < 500 && file_exists(path) != exists; ++i) {
+    this_thread::sleep_for(chrono::milliseconds(10));
+  }
+  return file_exists(path) == exists;
+}
+
+// echoes all received data in chunks of `chunk_size` bytes
+behavior echo_conn(broker* self, connection_handle hdl, size_t chunk_size) {
+  self->configure_read(hdl, receive_policy::exactly(chunk_size));
+  return {
+    [=](const new_data_msg& msg) {
+      self->write(hdl, msg.buf.size(), msg.buf.data());
+      self->flush(hdl);
+    },
+    [=](const connection_closed_msg&) {
+      self->quit();
+    }
+  };
+}
+
+behavior echo_server(broker* self, const string& path, size_t chunk_size) {
+  self->add_shm_doorman(path);
+  return {
+    [=](const new_connection_msg& msg) {
+      self->fork(echo_conn, msg.handle, chunk_size);
+      self->quit();
+    }
+  };
+}
+
+// sends integers one by one, waiting for each echo
+behavior ping_pong_client(broker* self, connection_handle hdl,
+                          const actor& listener) {
+  self->configure_read(hdl, receive_policy::exactly(sizeof(int)));
+  int value = 0;
+  self->write(hdl, sizeof(value), &value);
+  self->flush(hdl);
+  return {
+    [=](const new_data_msg& msg) {
+      int result;
+      memcpy(&result, msg.buf.data(), sizeof(int));
+      if (result + 1 < ping_pong_rounds) {
+        ++result;
+        self->write(hdl, sizeof(result), &result);
+        self->flush(hdl);
+        return;
+      }
+      CAF_CHECK_EQUAL(result, ping_pong_rounds - 1);
+      self->send(listener, done_atom::value);
+      self->quit();
+    }
+  };
+}
+
+// sends a single message that does not fit into the ring
+behavior bulk_client(broker* self, connection_handle hdl,
+                     const actor& listener) {
+  self->configure_read(hdl, receive_policy::exactly(bulk_size));
+  auto& buf = self->wr_buf(hdl);
+  for (size_t i = 0; i < bulk_size; ++i) {
+    buf.push_back(static_cast<char>(i % 251));
+  }
+  self->flush(hdl);
+  return {
+    [=](const new_data_msg& msg) {
+      auto ok = msg.buf.size() == bulk_size;
+      for (size_t i = 0; ok && i < bulk_size; ++i) {
+        ok = msg.buf[i] == static_cast<char>(i % 251);
+      }
+      CAF_CHECK(ok);
+      self->send(listener, done_atom::value);
+      self->quit();
+    }
+  };
+}
+
+template <class F>
+void run_echo(scoped_actor& self, const char* name, size_t chunk_size,
+              F client) {
+  auto path = socket_path(name);
+  spawn_io(echo_server, path, chunk_size);
+  CAF_CHECK(await_file(path, true));
+  actor listener = self;
+  spawn_io([=](broker* bro) {
+    bro->fork(client, bro->add_shm_scribe(path), listener);
+    bro->quit();
+  });
+  self->receive(
+    [](done_atom) {
+      // nop
+    }
+  );
+  CAF_CHECK(await_file(path, false));
+}
+
+void test_publish(scoped_actor& self) {
+  auto path = socket_path("publish");
+  auto pong = spawn([]() -> behavior {
+    return {
+      [](int value) {
+        return value * 2;
+      }
+    };
+  });
+  publish(pong, "shm:" + path);
+  CAF_CHECK(file_exists(path));
+  auto remote = remote_actor("shm:" + path);
+  CAF_CHECK(remote == pong);
+  self->sync_send(remote, 21).await(
+    [](int value) {
+      CAF_CHECK_EQUAL(value, 42);
+    }
+  );
+  unpublish(pong, 0);
+  CAF_CHECK(await_file(path, false));
+  // connecting via shared memory fails if the server does not offer it
+  publish(pong, path);
+  auto failed = false;
+  try {
+    remote_actor("shm:" + path);
+  }
+  catch (network_error&) {
+    failed = true;
+  }
+  CAF_CHECK(failed);
+  unpublish(pong, 0);
+  CAF_CHECK(await_file(path, false));
+  anon_send_exit(pong, exit_reason::user_shutdown);
+}
+
+void test_prefix() {
+  string path = "shm:/tmp/foo.sock";
+  CAF_CHECK(strip_shared_memory_prefix(path));
+  CAF_CHECK_EQUAL(path, "/tmp/foo.sock");
+  CAF_CHECK(!strip_shared_memory_prefix(path));
+  CAF_CHECK_EQUAL(path, "/tmp/foo.sock");
+}
+
+} // namespace <anonymous>
+
+int main() {
+  CAF_TEST(test_shared_memory);
+  test_prefix();
+  { // lifetime scope of self
+    scoped_actor self;
+    run_echo(self, "ping-pong", sizeof(int), ping_pong_client);
+    run_echo(self, "bulk", bulk_size, bulk_client);
+    test_publish(self);
+  }
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -0,0 +1,141 @@
+#include <string>
+#include <iostream>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+// replies with the trace context of each received message
+behavior tracer() {
+  return {
+    [](const string& str) {
+      auto& ctx = trace_context::current();
+      return make_message(str, ctx.trace_id, ctx.span_id, ctx.parent_id,
+                          ctx.sampled);
+    }
+  };
+}
+
+void test_local_propagation() {
+  scoped_actor self;
+  auto echo = spawn(tracer);
+  self->sync_send(echo, "untraced").await(
+    [](const string&, uint64_t trace_id, uint64_t, uint64_t, bool sampled) {
+      CAF_CHECK_EQUAL(trace_id, 0);
+      CAF_CHECK(!sampled);
+    }
+  );
+  { // messages to local actors keep the context of their sender
+    scoped_trace trace;
+    auto ctx = trace.context();
+    CAF_CHECK(ctx.sampled && ctx.trace_id != 0 && ctx.parent_id == 0);
+    self->sync_send(echo, "traced").await(
+      [&](const string&, uint64_t trace_id, uint64_t span_id,
+          uint64_t parent_id, bool sampled) {
+        CAF_CHECK_EQUAL(trace_id, ctx.trace_id);
+        CAF_CHECK_EQUAL(span_id, ctx.span_id);
+        CAF_CHECK_EQUAL(parent_id, ctx.parent_id);
+        CAF_CHECK(sampled);
+      }
+    );
+  }
+  CAF_CHECK(!trace_context::current().sampled);
+  // with sampling, handling an untraced message starts a new trace
+  trace_sampling(1);
+  CAF_CHECK_EQUAL(trace_sampling(), 1);
+  self->sync_send(echo, "sampled").await(
+    [](const string&, uint64_t trace_id, uint64_t, uint64_t parent_id,
+       bool sampled) {
+      CAF_CHECK(sampled && trace_id != 0);
+      CAF_CHECK_EQUAL(parent_id, 0);
+    }
+  );
+  trace_sampling(0);
+  anon_send_exit(echo, exit_reason::user_shutdown);
+}
+
+void run_client(uint16_t port) {
+  auto log = make_shared<io::trace_log>();
+  io::middleman::instance()->add_hook<io::trace_recorder>(log);
+  io::prefer_local_transport(false);
+  auto server = io::remote_actor("127.0.0.1", port);
+  scoped_actor self;
+  self->sync_send(server, "untraced").await(
+    [](const string&, uint64_t trace_id, uint64_t, uint64_t, bool sampled) {
+      CAF_CHECK_EQUAL(trace_id, 0);
+      CAF_CHECK(!sampled);
+    },
+    after(chrono::seconds(5)) >> [] {
+      CAF_UNEXPECTED_TOUT();
+    }
+  );
+  scoped_trace trace;
+  auto ctx = trace.context();
+  uint64_t remote_span = 0;
+  self->sync_send(server, "traced").await(
+    [&](const string&, uint64_t trace_id, uint64_t span_id,
+        uint64_t parent_id, bool sampled) {
+      // sending the message to another node started a new span
+      CAF_CHECK_EQUAL(trace_id, ctx.trace_id);
+      CAF_CHECK(span_id != ctx.span_id);
+      CAF_CHECK_EQUAL(parent_id, ctx.span_id);
+      CAF_CHECK(sampled);
+      remote_span = span_id;
+      // the response belongs to the trace as well
+      auto& reply = trace_context::current();
+      CAF_CHECK_EQUAL(reply.trace_id, ctx.trace_id);
+      CAF_CHECK_EQUAL(reply.parent_id, span_id);
+    },
+    after(chrono::seconds(5)) >> [] {
+      CAF_UNEXPECTED_TOUT();
+    }
+  );
+  auto events = log->events();
+  CAF_CHECK_EQUAL(events.size(), 2);
+  if (events.size() == 2) {
+    CAF_CHECK_EQUAL(events[0].kind, io::trace_event::sent);
+    CAF_CHECK_EQUAL(events[0].context.span_id, remote_span);
+    CAF_CHECK(events[0].node == server.address().node());
+    CAF_CHECK_EQUAL(events[1].kind, io::trace_event::received);
+    CAF_CHECK_EQUAL(events[1].context.parent_id, remote_span);
+    CAF_CHECK(events[1].node == server.address().node());
+    CAF_CHECK(events[0].timestamp <= events[1].timestamp);
+  }
+  anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  CAF_TEST(test_tracing);
+  message_builder{argv + 1, argv + argc}.apply({
+    on("-c", spro<uint16_t>) >> [](uint16_t port) {
+      CAF_PRINT("run in client mode");
+      run_client(port);
+    },
+    on() >> [&] {
+      test_local_propagation();
+      io::prefer_local_transport(false);
+      auto port = io::publish(spawn(tracer), 0, "127.0.0.1");
+      CAF_PRINT("running on port " << port);
+      scoped_actor self;
+      auto child = run_program(self, argv[0], "-c", port);
+      child.join();
+      self->await_all_other_actors_done();
+      self->receive(
+        [](const string& output) {
+          cout << endl << endl << "*** output of client program ***"
+               << endl << output << endl;
+          CAF_CHECK(output.find("\n0 error(s) detected") != string::npos);
+        }
+      );
+    }
+  });
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -0,0 +1,155 @@
+#include <string>
+#include <iostream>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+
+using io::traffic_metrics;
+
+namespace {
+
+constexpr int num_messages = 10;
+
+behavior echo() {
+  return {
+    [](const string& str) {
+      return str;
+    },
+    [](put_atom, int value) {
+      return value;
+    }
+  };
+}
+
+// returns the counters in the row of `snapshot` for `key`
+template <class Key>
+vector<uint64_t> row(const message& rows, const Key& key) {
+  vector<uint64_t> result;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    auto& x = rows.get_as<message>(i);
+    if (x.get_as<Key>(0) == key) {
+      for (size_t j = 1; j < x.size(); ++j) {
+        result.push_back(x.get_as<uint64_t>(j));
+      }
+    }
+  }
+  return result;
+}
+
+void test_counters() {
+  CAF_CHECK_EQUAL(traffic_metrics::type_name(make_message(string("a"), 1)),
+                  "@str+@i32");
+  auto msg = make_message(put_atom::value, 1);
+  CAF_CHECK_EQUAL(traffic_metrics::type_name(msg), "'PUT'+@i32");
+  traffic_metrics metrics;
+  node_id nid{42, "0123456789abcdef0123456789abcdef01234567"};
+  metrics.sent(nid, msg, 10);
+  metrics.sent(nid, msg, 20);
+  // dynamically typed messages share the counters of their type,
+  // whereas each leading atom denotes a type of its own
+  metrics.sent(nid, message_builder{}.append(atom("PUT")).append(1)
+                                     .to_message(), 30);
+  metrics.sent(nid, make_message(get_atom::value, 1), 5);
+  metrics.received(nid, make_message(1), 4);
+  metrics.forwarded(nid, 100);
+  metrics.failed(nid, &msg);
+  auto snapshot = metrics.snapshot();
+  CAF_CHECK((snapshot.has_types<message, message>()));
+  vector<uint64_t> peer{4, 65, 1, 4, 1, 100, 1};
+  vector<uint64_t> put_type{3, 60, 0, 0, 0, 0, 1};
+  vector<uint64_t> get_type{1, 5, 0, 0, 0, 0, 0};
+  vector<uint64_t> int_type{0, 0, 1, 4, 0, 0, 0};
+  CAF_CHECK(row(snapshot.get_as<message>(0), nid) == peer);
+  CAF_CHECK(row(snapshot.get_as<message>(1), string("'PUT'+@i32"))
+            == put_type);
+  CAF_CHECK(row(snapshot.get_as<message>(1), string("'GET'+@i32"))
+            == get_type);
+  CAF_CHECK(row(snapshot.get_as<message>(1), string("@i32")) == int_type);
+  metrics.reset();
+  snapshot = metrics.snapshot();
+  CAF_CHECK(row(snapshot.get_as<message>(0), nid)
+            == vector<uint64_t>(traffic_metrics::num_counters, 0));
+}
+
+void run_client(uint16_t port) {
+  auto monitor = io::spawn_traffic_monitor();
+  io::prefer_local_transport(false);
+  auto server = io::remote_actor("127.0.0.1", port);
+  scoped_actor self;
+  for (int i = 0; i < num_messages; ++i) {
+    self->sync_send(server, string(100, 'x')).await(
+      [](const string&) {
+        // nop
+      },
+      after(chrono::seconds(5)) >> [] {
+        CAF_UNEXPECTED_TOUT();
+      }
+    );
+  }
+  self->sync_send(server, put_atom::value, 42).await(
+    [](int) {
+      // nop
+    }
+  );
+  self->sync_send(monitor, get_atom::value).await(
+    [&](const message& peers, const message& types) {
+      auto p = row(peers, server.address().node());
+      CAF_CHECK_EQUAL(p.size(), traffic_metrics::num_counters);
+      if (p.size() == traffic_metrics::num_counters) {
+        CAF_CHECK_EQUAL(p[traffic_metrics::messages_sent], num_messages + 1);
+        CAF_CHECK_EQUAL(p[traffic_metrics::messages_received],
+                        num_messages + 1);
+        CAF_CHECK(p[traffic_metrics::bytes_sent] > 100 * num_messages);
+        CAF_CHECK_EQUAL(p[traffic_metrics::failures], 0);
+      }
+      auto s = row(types, string("@str"));
+      CAF_CHECK(s.size() == traffic_metrics::num_counters
+                && s[traffic_metrics::messages_sent] == num_messages
+                && s[traffic_metrics::messages_received] == num_messages);
+      auto t = row(types, string("'PUT'+@i32"));
+      CAF_CHECK(t.size() == traffic_metrics::num_counters
+                && t[traffic_metrics::messages_sent] == 1
+                && t[traffic_metrics::bytes_sent] > 0);
+    },
+    after(chrono::seconds(5)) >> [] {
+      CAF_UNEXPECTED_TOUT();
+    }
+  );
+  anon_send_exit(monitor, exit_reason::user_shutdown);
+  anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  CAF_TEST(test_traffic_metrics);
+  message_builder{argv + 1, argv + argc}.apply({
+    on("-c", spro<uint16_t>) >> [](uint16_t port) {
+      CAF_PRINT("run in client mode");
+      run_client(port);
+    },
+    on() >> [&] {
+      test_counters();
+      io::prefer_local_transport(false);
+      auto port = io::publish(spawn(echo), 0, "127.0.0.1");
+      CAF_PRINT("running on port " << port);
+      scoped_actor self;
+      auto child = run_program(self, argv[0], "-c", port);
+      child.join();
+      self->await_all_other_actors_done();
+      self->receive(
+        [](const string& output) {
+          cout << endl << endl << "*** output of client program ***"
+               << endl << output << endl;
+          CAF_CHECK(output.find("\n0 error(s) detected") != string::npos);
+        }
+      );
+    }
+  });
+  shutdown();
+  return CAF_TEST_RESULT();
+}
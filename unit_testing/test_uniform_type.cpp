@@ -165,7 +165,9 @@ int main() {
                        "caf::io::accept_handle",
                        "caf::io::acceptor_closed_msg",
                        "caf::io::connection_handle",
+                       "caf::io::connection_attempt_msg",
                        "caf::io::connection_closed_msg",
+                       "caf::io::data_transferred_msg",
                        "caf::io::new_connection_msg",
                        "caf::io::new_data_msg"));
     CAF_CHECKPOINT();
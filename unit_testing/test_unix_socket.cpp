@@ -0,0 +1,275 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2014                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+
+#include "test.hpp"
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+using namespace caf::io;
+
+using publish_atom = atom_constant<atom("publish")>;
+using done_atom = atom_constant<atom("done")>;
+
+namespace {
+
+string socket_path(const char* name) {
+  return "/tmp/caf-test-" + to_string(getpid()) + "-" + name + ".sock";
+}
+
+bool file_exists(const string& path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0;
+}
+
+// brokers open and close sockets asynchronously
+bool await_file(const string& path, bool exists) {
+  for (int i = 0; i < 500 && file_exists(path) != exists; ++i) {
+    this_thread::sleep_for(chrono::milliseconds(10));
+  }
+  return file_exists(path) == exists;
+}
+
+// echoes each integer it receives
+behavior echo_conn(broker* self, connection_handle hdl) {
+  self->configure_read(hdl, receive_policy::exactly(sizeof(int)));
+  return {
+    [=](const new_data_msg& msg) {
+      self->write(hdl, msg.buf.size(), msg.buf.data());
+      self->flush(hdl);
+    },
+    [=](const connection_closed_msg&) {
+      self->quit();
+    }
+  };
+}
+
+behavior echo_server(broker* self, const string& path) {
+  self->add_unix_doorman(path);
+  return {
+    [=](const new_connection_msg& msg) {
+      self->fork(echo_conn, msg.handle);
+      self->quit();
+    }
+  };
+}
+
+behavior echo_client(broker* self, connection_handle hdl,
+                     const actor& listener) {
+  self->configure_read(hdl, receive_policy::exactly(sizeof(int)));
+  int value = 42;
+  self->write(hdl, sizeof(value), &value);
+  self->flush(hdl);
+  return {
+    [=](const new_data_msg& msg) {
+      int result;
+      memcpy(&result, msg.buf.data(), sizeof(int));
+      CAF_CHECK_EQUAL(result, 42);
+      self->send(listener, done_atom::value);
+      self->quit();
+    }
+  };
+}
+
+void test_broker_echo(scoped_actor& self) {
+  auto path = socket_path("echo");
+  spawn_io(echo_server, path);
+  CAF_CHECK(await_file(path, true));
+  actor listener = self;
+  spawn_io([=](broker* bro) {
+    bro->fork(echo_client, bro->add_unix_scribe(path), listener);
+    bro->quit();
+  });
+  self->receive(
+    [](done_atom) {
+      // nop
+    }
+  );
+  CAF_CHECK(await_file(path, false));
+}
+
+void test_publish(scoped_actor& self) {
+  auto path = socket_path("publish");
+  auto pong = spawn([]() -> behavior {
+    return {
+      [](int value) {
+        return value * 2;
+      }
+    };
+  });
+  publish(pong, path);
+  CAF_CHECK(file_exists(path));
+  auto remote = remote_actor(path);
+  CAF_CHECK(remote == pong);
+  self->sync_send(remote, 21).await(
+    [](int value) {
+      CAF_CHECK_EQUAL(value, 42);
+    }
+  );
+  // publishing the same path twice fails while the socket is in use
+  auto failed = false;
+  try {
+    publish(pong, path);
+  }
+  catch (network_error&) {
+    failed = true;
+  }
+  CAF_CHECK(failed);
+  unpublish(pong, 0);
+  CAF_CHECK(await_file(path, false));
+  // TCP ports come with a Unix domain socket for clients on the same host
+  auto port = publish(pong, 0, "127.0.0.1");
+  auto local_path = local_transport_path(port);
+  CAF_CHECK(!prefer_local_transport() || await_file(local_path, true));
+  unpublish(pong, port);
+  CAF_CHECK(await_file(local_path, false));
+  anon_send_exit(pong, exit_reason::user_shutdown);
+}
+
+void test_stale_socket_file() {
+  auto path = socket_path("stale");
+  // leave a socket file behind without a listening process
+  auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  CAF_CHECK(::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+  close(fd);
+  CAF_CHECK(file_exists(path));
+  auto dummy = spawn([]() -> behavior {
+    return {
+      others() >> [] {
+        // nop
+      }
+    };
+  });
+  publish(dummy, path);
+  unpublish(dummy, 0);
+  CAF_CHECK(await_file(path, false));
+  anon_send_exit(dummy, exit_reason::user_shutdown);
+}
+
+// accepts a single connection on a Unix domain socket and
+// closes it again without ever sending a BASP handshake
+behavior rogue_server(broker* self, const string& path, const actor& listener) {
+  self->add_unix_doorman(path);
+  return {
+    [=](const new_connection_msg& msg) {
+      self->close(msg.handle);
+      self->send(listener, done_atom::value);
+      self->quit();
+    }
+  };
+}
+
+void run_client(uint16_t port) {
+  // the handshake on the local socket fails, hence we stay on TCP
+  auto remote = remote_actor("127.0.0.1", port);
+  scoped_actor self;
+  self->sync_send(remote, 21).await(
+    [](int value) {
+      CAF_CHECK_EQUAL(value, 42);
+    },
+    after(chrono::seconds(5)) >> CAF_UNEXPECTED_TOUT_CB()
+  );
+}
+
+void test_local_fallback(scoped_actor& self, const char* program) {
+  if (!prefer_local_transport()) {
+    return;
+  }
+  auto pong = spawn([]() -> behavior {
+    return {
+      [](int value) {
+        return value * 2;
+      }
+    };
+  });
+  auto port = publish(pong, 0, "127.0.0.1");
+  auto local_path = local_transport_path(port);
+  CAF_CHECK(await_file(local_path, true));
+  // replace the socket of the BASP broker with a foreign one
+  unlink(local_path.c_str());
+  spawn_io(rogue_server, local_path, actor{self});
+  CAF_CHECK(await_file(local_path, true));
+  auto child = run_program(self, program, "-c", port);
+  child.join();
+  self->receive(
+    [](done_atom) {
+      // nop
+    },
+    after(chrono::seconds(5)) >> CAF_UNEXPECTED_TOUT_CB()
+  );
+  self->receive(
+    [](const string& output) {
+      cout << endl << endl << "*** output of client program ***"
+           << endl << output << endl;
+      CAF_CHECK(output.find("\n0 error(s) detected") != string::npos);
+    }
+  );
+  unpublish(pong, port);
+  anon_send_exit(pong, exit_reason::user_shutdown);
+}
+
+void test_connect_failure() {
+  auto failed = false;
+  try {
+    remote_actor(socket_path("missing"));
+  }
+  catch (network_error&) {
+    failed = true;
+  }
+  CAF_CHECK(failed);
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  CAF_TEST(test_unix_socket);
+  message_builder{argv + 1, argv + argc}.apply({
+    on("-c", spro<uint16_t>) >> [](uint16_t port) {
+      CAF_PRINT("run in client mode");
+      run_client(port);
+    },
+    on() >> [&] {
+      scoped_actor self;
+      test_broker_echo(self);
+      test_publish(self);
+      test_stale_socket_file();
+      test_connect_failure();
+      test_local_fallback(self, argv[0]);
+    }
+  });
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}